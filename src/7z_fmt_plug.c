@@ -43,6 +43,7 @@ john_register_one(&fmt_sevenzip);
 #include "dyna_salt.h"
 #include "lzma/LzmaDec.h"
 #include "lzma/Lzma2Dec.h"
+#include "stage_stats.h"
 
 #define FORMAT_LABEL		"7z"
 #define FORMAT_NAME		"7-Zip"
@@ -60,10 +61,9 @@ john_register_one(&fmt_sevenzip);
 
 #ifdef SIMD_COEF_32
 #include "simd-intrinsics.h"
+#include "iter_hash.h"
 
 #define NBKEYS     (SIMD_COEF_32*SIMD_PARA_SHA256)
-#define GETPOS(i,idx) ( (idx&(SIMD_COEF_32-1))*4 + ((i)&(0xffffffff-3))*SIMD_COEF_32 + (3-((i)&3)) + (unsigned int)idx/SIMD_COEF_32*SHA_BUF_SIZ*4*SIMD_COEF_32 )
-#define HASH_IDX_IN(idx)  (((unsigned int)idx&(SIMD_COEF_32-1))+(unsigned int)idx/SIMD_COEF_32*SHA_BUF_SIZ*SIMD_COEF_32)
 #define HASH_IDX_OUT(idx) (((unsigned int)idx&(SIMD_COEF_32-1))+(unsigned int)idx/SIMD_COEF_32*8*SIMD_COEF_32)
 
 #define ALGORITHM_NAME		"SHA256 " SHA256_ALGORITHM_NAME " AES"
@@ -127,10 +127,9 @@ static int *saved_len;
 static int *cracked;
 static int new_keys;
 static int max_kpc;
-static unsigned char (*master)[32];
+static struct stage_batch batch;	/* key slots hold the KDF output */
+static const char *stage_names[] = { "padding", "LZMA", "CRC", NULL };
 #ifdef SIMD_COEF_32
-static uint32_t (*vec_in)[2][NBKEYS*16];
-static uint32_t (*vec_out)[NBKEYS*8];
 static int *indices;
 #endif
 
@@ -167,13 +166,8 @@ static void init(struct fmt_main *self)
 	saved_key = mem_calloc(max_kpc, sizeof(*saved_key));
 	saved_len = mem_calloc(max_kpc, sizeof(*saved_len));
 	cracked   = mem_calloc(max_kpc, sizeof(*cracked));
-#ifdef SIMD_COEF_32
-	vec_in  = mem_calloc_align(self->params.max_keys_per_crypt,
-	                           sizeof(*vec_in), MEM_ALIGN_CACHE);
-	vec_out = mem_calloc_align(self->params.max_keys_per_crypt,
-	                           sizeof(*vec_out), MEM_ALIGN_CACHE);
-#endif
 	CRC32_Init(&crc);
+	stage_batch_init(&batch, "7z", stage_names, max_kpc, 32);
 
 	if (options.target_enc == UTF_8)
 		self->params.plaintext_length = MIN(125, 3 * PLAINTEXT_LENGTH);
@@ -181,13 +175,11 @@ static void init(struct fmt_main *self)
 
 static void done(void)
 {
+	stage_batch_done(&batch);
 	MEM_FREE(cracked);
 	MEM_FREE(saved_key);
 	MEM_FREE(saved_len);
-	MEM_FREE(master);
 #ifdef SIMD_COEF_32
-	MEM_FREE(vec_in);
-	MEM_FREE(vec_out);
 	MEM_FREE(indices);
 #endif
 }
@@ -347,13 +339,19 @@ static void *get_salt(char *ciphertext)
 
 static void set_salt(void *salt)
 {
-	static int old_power;
+	static int old_power, old_salt_size;
+	static unsigned char old_salt[16];
 
 	cur_salt = *((struct custom_salt**)salt);
 
-	if (old_power != cur_salt->NumCyclesPower) {
+	/* the derived keys only depend on these */
+	if (old_power != cur_salt->NumCyclesPower ||
+	    old_salt_size != cur_salt->SaltSize ||
+	    memcmp(old_salt, cur_salt->salt, cur_salt->SaltSize)) {
 		new_keys = 1;
 		old_power = cur_salt->NumCyclesPower;
+		old_salt_size = cur_salt->SaltSize;
+		memcpy(old_salt, cur_salt->salt, cur_salt->SaltSize);
 	}
 }
 
@@ -374,7 +372,44 @@ static int salt_compare(const void *x, const void *y)
 static void *SzAlloc(void *p, size_t size) { return mem_alloc(size); }
 static void SzFree(void *p, void *address) { MEM_FREE(address) };
 
-static int sevenzip_decrypt(unsigned char *derived_key)
+/*
+ * Early rejection (only decrypt last 16 bytes). We don't seem to be able to
+ * trust this, see #2532, so we only do it for truncated hashes (it's the only
+ * thing we can do!).
+ */
+static int sevenzip_quick_padding(void)
+{
+	return (cur_salt->type == 0x80 || TRUST_PADDING) &&
+		cur_salt->length - cur_salt->unpacksize > 0 &&
+		cur_salt->length >= 32;
+}
+
+static int sevenzip_padding(int index, unsigned char *derived_key)
+{
+	AES_KEY akey;
+	unsigned char iv[16];
+	uint8_t buf[16];
+	int i, nbytes = cur_salt->length - cur_salt->unpacksize;
+
+	if (!sevenzip_quick_padding())
+		return 1;
+
+	memcpy(iv, cur_salt->data + cur_salt->length - 32, 16);
+	AES_set_decrypt_key(derived_key, 256, &akey);
+	AES_cbc_encrypt(cur_salt->data + cur_salt->length - 16, buf,
+	                16, &akey, iv, AES_DECRYPT);
+	i = 15;
+	while (nbytes > 0) {
+		if (buf[i] != 0)
+			return 0;
+		nbytes--;
+		i--;
+	}
+	return 1;
+}
+
+/* Returns the number of the LZMA and CRC stages passed */
+static int sevenzip_decrypt(int index, unsigned char *derived_key)
 {
 	unsigned char *out = NULL;
 	AES_KEY akey;
@@ -387,37 +422,18 @@ static int sevenzip_decrypt(unsigned char *derived_key)
 	unsigned int ccrc;
 	CRC32_t crc;
 	int i;
-	int nbytes, pad_size;
+	int nbytes;
 	size_t crc_len = cur_salt->unpacksize;
 	size_t aes_len = cur_salt->crc_len ?
 		(cur_salt->crc_len * 11 + 150) / 160 * 16 : crc_len;
 
-	pad_size = nbytes = cur_salt->length - cur_salt->unpacksize;
-
-	/*
-	 * Early rejection (only decrypt last 16 bytes). We don't seem to
-	 * be able to trust this, see #2532, so we only do it for truncated
-	 * hashes (it's the only thing we can do!).
-	 */
-	if ((cur_salt->type == 0x80 || TRUST_PADDING) &&
-	    pad_size > 0 && cur_salt->length >= 32) {
-		uint8_t buf[16];
-
-		memcpy(iv, cur_salt->data + cur_salt->length - 32, 16);
-		AES_set_decrypt_key(derived_key, 256, &akey);
-		AES_cbc_encrypt(cur_salt->data + cur_salt->length - 16, buf,
-		                16, &akey, iv, AES_DECRYPT);
-		i = 15;
-		while (nbytes > 0) {
-			if (buf[i] != 0)
-				return 0;
-			nbytes--;
-			i--;
-		}
+	/* We only have truncated data, the padding was all we could check */
+	if (cur_salt->type == 0x80 && sevenzip_quick_padding())
+		return 2;
 
-		if (cur_salt->type == 0x80) /* We only have truncated data */
-			return 1;
-	}
+	nbytes = cur_salt->length - cur_salt->unpacksize;
+	if (sevenzip_quick_padding())
+		nbytes = 0;
 
 	/* Complete decryption, or partial if possible */
 	aes_len = nbytes ? cur_salt->length : MIN(aes_len, cur_salt->length);
@@ -494,91 +510,52 @@ static int sevenzip_decrypt(unsigned char *derived_key)
 #if !ARCH_LITTLE_ENDIAN
 	ccrc = JOHNSWAP(ccrc);
 #endif
-	if (ccrc == cur_salt->crc)
-		goto exit_good;
+	if (ccrc != cur_salt->crc) {
+		MEM_FREE(out);
+		return 1;
+	}
 
-exit_bad:
+exit_good:
 	MEM_FREE(out);
-	return 0;
+	return 2;
 
-exit_good:
+exit_bad:
 	MEM_FREE(out);
-	return 1;
+	return 0;
 }
 
 #ifdef SIMD_COEF_32
-static void sevenzip_kdf(int buf_idx, int *indices, unsigned char *master)
+static void sevenzip_kdf(int *indices)
 {
 	int i, j;
-	long long round, rounds = (long long) 1 << cur_salt->NumCyclesPower;
-	uint32_t (*buf_in)[NBKEYS*16] = vec_in[buf_idx];
-	uint32_t *buf_out = vec_out[buf_idx];
+	long long rounds = (long long) 1 << cur_salt->NumCyclesPower;
+	unsigned char buf[NBKEYS][sizeof(cur_salt->salt) + sizeof(*saved_key)];
+	unsigned char *prefix[NBKEYS];
+	struct iter_hash ih;
+	uint32_t *buf_out;
+	int salt_len = cur_salt->SaltSize;
 	int pw_len = saved_len[indices[0]];
-	int tot_len = (pw_len + 8)*rounds;
-	int acc_len = 0;
-#if !ARCH_LITTLE_ENDIAN
-	unsigned char temp[8] = { 0,0,0,0,0,0,0,0 };
-#endif
-
-	int cur_buf = 0;
-	int fst_blk = 1;
-
-	// it's assumed rounds is divisible by 64
-	for (round = 0; round < rounds; ++round) {
-		// copy password to vector buffer
-		for (i = 0; i < NBKEYS; ++i) {
-			UTF16 *buf = saved_key[indices[i]];
-			for (j = 0; j < pw_len; ++j) {
-				int len = acc_len + j;
-				char *in = (char*)buf_in[(len & 64)>>6];
-				in[GETPOS(len%64, i)] = ((char*)buf)[j];
-			}
 
-			for (j = 0; j < 8; ++j) {
-				int len = acc_len + pw_len + j;
-				char *in = (char*)buf_in[(len & 64)>>6];
-#if ARCH_LITTLE_ENDIAN
-				in[GETPOS(len%64, i)] = ((char*)&round)[j];
-#else
-				in[GETPOS(len%64, i)] = temp[j];
-#endif
-			}
-		}
-#if !ARCH_LITTLE_ENDIAN
-		for (j = 0; j < 8; j++)
-			if (++(temp[j]) != 0)
-				break;
-#endif
-		acc_len += (pw_len + 8);
-
-		// swap out and compute digest on the filled buffer
-		if ((acc_len & 64) != (cur_buf << 6)) {
-			if (fst_blk)
-				SIMDSHA256body(buf_in[cur_buf], buf_out, NULL, SSEi_MIXED_IN);
-			else
-				SIMDSHA256body(buf_in[cur_buf], buf_out, buf_out, SSEi_MIXED_IN | SSEi_RELOAD);
-			fst_blk = 0;
-			cur_buf = 1 - cur_buf;
-		}
-	}
-
-	// padding
-	memset(buf_in[0], 0, sizeof(buf_in[0]));
+	// all passwords in one batch have the same length
 	for (i = 0; i < NBKEYS; ++i) {
-		buf_in[0][HASH_IDX_IN(i)] = (0x80U << 24);
-		buf_in[0][HASH_IDX_IN(i) + 15*SIMD_COEF_32] = tot_len*8;
+		memcpy(buf[i], cur_salt->salt, salt_len);
+		memcpy(buf[i] + salt_len, saved_key[indices[i]], pw_len);
+		prefix[i] = buf[i];
 	}
-	SIMDSHA256body(buf_in[0], buf_out, buf_out, SSEi_MIXED_IN | SSEi_RELOAD);
+	iter_hash_init(&ih, ITER_HASH_SHA256, prefix, salt_len + pw_len, 8);
+	iter_hash_add(&ih, rounds);
+	buf_out = iter_hash_final(&ih);
 
 	// copy out result
 	for (i = 0; i < NBKEYS; ++i) {
-		uint32_t *m = (uint32_t*)&master[i*32];
+		uint32_t *m = (uint32_t*)stage_batch_key(&batch, indices[i]);
 		for (j = 0; j < 32/4; ++j)
 			m[j] = JOHNSWAP(buf_out[HASH_IDX_OUT(i) + j*SIMD_COEF_32]);
 	}
+	iter_hash_free(&ih);
 }
 #else
-static void sevenzip_kdf(int index, unsigned char *master)
+static void sevenzip_kdf(int index)
 {
 	long long rounds = (long long) 1 << cur_salt->NumCyclesPower;
 	long long round;
@@ -603,7 +580,7 @@ static void sevenzip_kdf(int index, unsigned char *master)
 				break;
 #endif
 	}
-	SHA256_Final(master, &sha);
+	SHA256_Final(stage_batch_key(&batch, index), &sha);
 }
 #endif
 
@@ -612,22 +589,13 @@ static int crypt_all(int *pcount, struct db_salt *salt)
 	const int count = *pcount;
 	int index = 0;
 #ifdef SIMD_COEF_32
-	static int tot_todo;
-	int len;
+	int tot_todo, len;
 
 	/* Tricky formula, see GitHub #1692 :-) */
 	if (!indices)
 		indices = mem_alloc((max_kpc + MIN(PLAINTEXT_LENGTH + 1, max_kpc) *
 		                     (NBKEYS - 1)) * sizeof(int));
-	if (!master)
-		master =  mem_alloc((max_kpc + MIN(PLAINTEXT_LENGTH + 1, max_kpc) *
-		                     (NBKEYS - 1)) * sizeof(*master));
-#else
-	if (!master)
-		master =  mem_alloc(max_kpc * sizeof(*master));
-#endif
 
-#ifdef SIMD_COEF_32
 	if (new_keys) {
 		// sort passwords by length
 		tot_todo = 0;
@@ -639,39 +607,30 @@ static int crypt_all(int *pcount, struct db_salt *salt)
 			while (tot_todo % NBKEYS)
 				indices[tot_todo++] = count;
 		}
-	}
 
 #ifdef _OPENMP
 #pragma omp parallel for
 #endif
-	for (index = 0; index < tot_todo; index += NBKEYS)
-	{
-		int j;
-
-		if (new_keys)
-			sevenzip_kdf(index/NBKEYS, indices + index, master[index]);
-
-		/* do decryption and checks */
-		for (j = 0; j < NBKEYS; ++j) {
-			cracked[indices[index + j]] = sevenzip_decrypt(master[index + j]);
-		}
+		for (index = 0; index < tot_todo; index += NBKEYS)
+			sevenzip_kdf(indices + index);
 	}
 #else
+	if (new_keys) {
 #ifdef _OPENMP
 #pragma omp parallel for
 #endif
-	for (index = 0; index < count; index += MAX_KEYS_PER_CRYPT)
-	{
-		/* derive key */
-		if (new_keys)
-			sevenzip_kdf(index, master[index]);
-
-		/* do decryption and checks */
-		cracked[index] = sevenzip_decrypt(master[index]);
+		for (index = 0; index < count; index += MAX_KEYS_PER_CRYPT)
+			sevenzip_kdf(index);
 	}
 #endif // SIMD_COEF_32
 	new_keys = 0;
 
+	/* do decryption and checks, each over all candidates still left */
+	stage_batch_start(&batch, count);
+	if (stage_batch_run(&batch, 0, 1, sevenzip_padding))
+		stage_batch_run(&batch, 1, 2, sevenzip_decrypt);
+	stage_batch_cracked(&batch, cracked, count);
+
 	return count;
 }
 
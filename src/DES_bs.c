@@ -54,6 +54,13 @@ DES_bs_combined CC_CACHE_ALIGN DES_bs_all;
 DES_bs_vector DES_bs_P[64];
 #endif
 
+#if DES_BS_HASH_CACHE
+uint64_t DES_bs_crypt_id;
+static uint32_t *DES_bs_hashes;
+static uint64_t *DES_bs_hashes_id;
+static unsigned int DES_bs_hashes_size;
+#endif
+
 static unsigned char DES_LM_KP[56] = {
 	1, 2, 3, 4, 5, 6, 7,
 	10, 11, 12, 13, 14, 15, 0,
@@ -112,6 +119,23 @@ void DES_bs_init(int LM, int cpt)
 	}
 #endif
 
+#if DES_BS_HASH_CACHE
+	if (!DES_bs_hashes) {
+#if DES_bs_mt
+		DES_bs_hashes_size = DES_bs_n_alloc * DES_BS_DEPTH;
+#else
+		DES_bs_hashes_size = DES_BS_DEPTH;
+#endif
+		DES_bs_hashes = mem_alloc_tiny(DES_bs_hashes_size *
+		    sizeof(*DES_bs_hashes), MEM_ALIGN_CACHE);
+		DES_bs_hashes_id = mem_alloc_tiny(DES_bs_hashes_size /
+		    ARCH_BITS * sizeof(*DES_bs_hashes_id), sizeof(uint64_t));
+	}
+	memset(DES_bs_hashes_id, 0,
+	    DES_bs_hashes_size / ARCH_BITS * sizeof(*DES_bs_hashes_id));
+	DES_bs_crypt_id = 1;
+#endif
+
 	for_each_t(n) {
 #if DES_BS_EXPAND
 		if (LM)
@@ -352,6 +376,66 @@ char *DES_bs_get_source_LM(uint32_t *raw)
 	return out;
 }
 
+#if DES_BS_HASH_CACHE
+/*
+ * Transposes a 32x32 bit matrix: bit i of a[j] ends up as bit j of a[i].
+ */
+static void DES_bs_transpose_32(uint32_t *a)
+{
+	uint32_t m, tmp;
+	int j, k;
+
+	for (j = 16, m = 0x0000ffff; j; j >>= 1, m ^= m << j)
+	for (k = 0; k < 32; k = ((k | j) + 1) & ~j) {
+		tmp = ((a[k] >> j) ^ a[k | j]) & m;
+		a[k | j] ^= tmp;
+		a[k] ^= tmp << j;
+	}
+}
+
+/*
+ * With more than a few hashes loaded, get_hash*() is called for every key.
+ * Rather than gathering bits one by one for each key, transpose the first
+ * 32 output bits of all keys in the same ARCH_WORD at once.
+ */
+static MAYBE_INLINE uint32_t DES_bs_get_hash_cached(int index)
+{
+	unsigned int block = (unsigned int)index / ARCH_BITS;
+	unsigned int pos = (unsigned int)index % ARCH_BITS;
+	uint32_t *hashes = &DES_bs_hashes[block * ARCH_BITS];
+
+	if (DES_bs_hashes_id[block] != DES_bs_crypt_id) {
+		DES_bs_vector *b;
+		int bit;
+#if DES_BS_VECTOR
+		int depth;
+#endif
+
+		index = block * ARCH_BITS;
+		{
+			init_t();
+			init_depth();
+			b = (DES_bs_vector *)&DES_bs_all.B[0] DEPTH;
+			for (bit = 0; bit < 32; bit++) {
+				unsigned ARCH_WORD w = b[bit] START;
+
+				hashes[bit] = (uint32_t)w;
+#if ARCH_BITS == 64
+				hashes[32 + bit] = (uint32_t)(w >> 32);
+#endif
+			}
+		}
+		DES_bs_transpose_32(hashes);
+#if ARCH_BITS == 64
+		DES_bs_transpose_32(hashes + 32);
+#endif
+		DES_bs_hashes_id[block] = DES_bs_crypt_id;
+	}
+
+	return hashes[pos];
+}
+#endif
+
 static MAYBE_INLINE int DES_bs_get_hash(int index, int count, int trip)
 {
 	int result;
@@ -430,39 +514,48 @@ static MAYBE_INLINE int DES_bs_get_hash(int index, int count, int trip)
 	return result;
 }
 
+static MAYBE_INLINE int DES_bs_get_hash_plain(int index, int count)
+{
+#if DES_BS_HASH_CACHE
+	return DES_bs_get_hash_cached(index) & ((1U << count) - 1);
+#else
+	return DES_bs_get_hash(index, count, 0);
+#endif
+}
+
 int DES_bs_get_hash_0(int index)
 {
-	return DES_bs_get_hash(index, 4, 0);
+	return DES_bs_get_hash_plain(index, 4);
 }
 
 int DES_bs_get_hash_1(int index)
 {
-	return DES_bs_get_hash(index, 8, 0);
+	return DES_bs_get_hash_plain(index, 8);
 }
 
 int DES_bs_get_hash_2(int index)
 {
-	return DES_bs_get_hash(index, 12, 0);
+	return DES_bs_get_hash_plain(index, 12);
 }
 
 int DES_bs_get_hash_3(int index)
 {
-	return DES_bs_get_hash(index, 16, 0);
+	return DES_bs_get_hash_plain(index, 16);
 }
 
 int DES_bs_get_hash_4(int index)
 {
-	return DES_bs_get_hash(index, 20, 0);
+	return DES_bs_get_hash_plain(index, 20);
 }
 
 int DES_bs_get_hash_5(int index)
 {
-	return DES_bs_get_hash(index, 24, 0);
+	return DES_bs_get_hash_plain(index, 24);
 }
 
 int DES_bs_get_hash_6(int index)
 {
-	return DES_bs_get_hash(index, 27, 0);
+	return DES_bs_get_hash_plain(index, 27);
 }
 
 /*
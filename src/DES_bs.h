@@ -83,7 +83,9 @@ extern DES_bs_vector DES_bs_P[64];
 
 #if defined(_OPENMP) && !DES_BS_ASM
 #define DES_bs_mt			1
-#if __AVX2__
+#if __AVX512F__
+#define DES_bs_cpt			8
+#elif __AVX2__
 #define DES_bs_cpt			16
 #else
 #define DES_bs_cpt			32
@@ -127,6 +129,20 @@ extern DES_bs_combined CC_CACHE_ALIGN DES_bs_all;
 #define init_t()
 #endif
 
+#if ARCH_LITTLE_ENDIAN && !DES_BS_ASM
+/*
+ * get_hash*() transposes output bits for ARCH_BITS keys at a time and keeps
+ * them until the next DES_bs_crypt*() call, which bumps this counter.  It's
+ * 64-bit so that it never wraps around to a stale block's id.
+ */
+#define DES_BS_HASH_CACHE		1
+extern uint64_t DES_bs_crypt_id;
+#define DES_bs_output_changed()		DES_bs_crypt_id++
+#else
+#define DES_BS_HASH_CACHE		0
+#define DES_bs_output_changed()
+#endif
+
 /*
  * Initializes the internal structures.
  */
@@ -351,6 +351,35 @@ typedef __m512i vtype;
 #define vshr(dst, src, shift) \
 	(dst) = _mm512_srli_epi32((src), (shift))
 
+#elif defined(__AVX512F__) && DES_BS_DEPTH == 512
+#include <immintrin.h>
+
+typedef __m512i vtype;
+
+#define vst(dst, ofs, src) \
+	_mm512_store_si512((vtype *)((DES_bs_vector *)&(dst) + (ofs)), (src))
+
+#define vxorf(a, b) \
+	_mm512_xor_si512((a), (b))
+
+#define vnot(dst, a) \
+	(dst) = _mm512_ternarylogic_epi32((a), (a), (a), 0x0f)
+#define vand(dst, a, b) \
+	(dst) = _mm512_and_si512((a), (b))
+#define vor(dst, a, b) \
+	(dst) = _mm512_or_si512((a), (b))
+#define vandn(dst, a, b) \
+	(dst) = _mm512_andnot_si512((b), (a))
+#define vsel(dst, a, b, c) \
+	(dst) = _mm512_ternarylogic_epi32((c), (b), (a), 0xca)
+
+#define vshl1(dst, src) \
+	(dst) = _mm512_add_epi64((src), (src))
+#define vshl(dst, src, shift) \
+	(dst) = _mm512_slli_epi64((src), (shift))
+#define vshr(dst, src, shift) \
+	(dst) = _mm512_srli_epi64((src), (shift))
+
 #elif defined(__AVX__) && DES_BS_DEPTH == 256 && !defined(DES_BS_NO_AVX256)
 #include <immintrin.h>
 
@@ -1332,6 +1361,8 @@ void DES_bs_crypt_25(int keys_count)
 	int t, n = (keys_count + (DES_BS_DEPTH - 1)) / DES_BS_DEPTH;
 #endif
 
+	DES_bs_output_changed();
+
 #ifdef _OPENMP
 #pragma omp parallel for default(none) private(t) shared(n, DES_bs_all_p, keys_count)
 #endif
@@ -1464,6 +1495,8 @@ void DES_bs_crypt(int count, int keys_count)
 	int t, n = (keys_count + (DES_BS_DEPTH - 1)) / DES_BS_DEPTH;
 #endif
 
+	DES_bs_output_changed();
+
 #ifdef _OPENMP
 #pragma omp parallel for default(none) private(t) shared(n, DES_bs_all_p, count, keys_count)
 #endif
@@ -1631,6 +1664,8 @@ int DES_bs_crypt_LM(int *pcount, struct db_salt *salt)
 	int t, n = (keys_count + (DES_BS_DEPTH - 1)) / DES_BS_DEPTH;
 #endif
 
+	DES_bs_output_changed();
+
 #ifdef _OPENMP
 #pragma omp parallel for default(none) private(t) shared(n, DES_bs_all_p, keys_count)
 #endif
@@ -1793,6 +1828,7 @@ void DES_bs_crypt_plain(int keys_count)
 	int t, n = (keys_count + (DES_BS_DEPTH - 1)) / DES_BS_DEPTH;
 #endif
 
+	DES_bs_output_changed();
 
 #ifdef _OPENMP
 #pragma omp parallel for default(none) private(t) shared(n, DES_bs_all_p, keys_count, DES_bs_P)
@@ -275,6 +275,35 @@ static void *get_binary(char *ciphertext)
   return binary;
 }
 
+/*
+ * The NTLM hash and the key setup of the first HMAC_MD5 only depend on the
+ * key, so they are done once for all salts.
+ */
+static void precompute_keys(int count)
+{
+	int i;
+
+	if (keys_prepared)
+		return;
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+	for (i = 0; i < count; i++) {
+		unsigned char ntlm[16];
+		int len;
+
+		/* Generate 16-byte NTLM hash */
+		len = E_md4hash(saved_plain[i], saved_len[i], ntlm);
+
+		hmac_md5_init_K16(ntlm, &saved_ctx[i]);
+
+		if (len <= 0)
+			saved_plain[i][-len] = 0; // match truncation
+	}
+	keys_prepared = 1;
+}
+
 /* Calculate the NTLMv2 response for the given challenge, using the
    specified authentication identity (username and domain), password
    and client nonce.
@@ -287,6 +316,8 @@ static int crypt_all(int *pcount, struct db_salt *salt)
 	int identity_length, challenge_size;
 	int i = 0;
 
+	precompute_keys(count);
+
 	/* --- HMAC #1 Calculations --- */
 	identity_length = challenge[0];
 	challenge_size = (*(challenge + 1 + identity_length + 1) << 8) | *(challenge + 1 + identity_length + 2);
@@ -299,20 +330,6 @@ static int crypt_all(int *pcount, struct db_salt *salt)
 		unsigned char ntlm_v2_hash[16];
 		HMACMD5Context ctx;
 
-		if (!keys_prepared) {
-			unsigned char ntlm[16];
-			int len;
-
-			/* Generate 16-byte NTLM hash */
-			len = E_md4hash(saved_plain[i], saved_len[i], ntlm);
-
-			// We do key setup of the next HMAC_MD5 here (once per salt)
-			hmac_md5_init_K16(ntlm, &saved_ctx[i]);
-
-			if (len <= 0)
-				saved_plain[i][-len] = 0; // match truncation
-		}
-
 		/* HMAC-MD5(Username + Domain, NTLM Hash) */
 		memcpy(&ctx, &saved_ctx[i], sizeof(ctx));
 		hmac_md5_update((unsigned char *)&challenge[1], identity_length, &ctx);
@@ -344,7 +361,6 @@ static int crypt_all(int *pcount, struct db_salt *salt)
 		*/
 		hmac_md5(ntlm_v2_hash, challenge + 1 + identity_length + 1 + 2, challenge_size, (unsigned char*)output[i]);
 	}
-	keys_prepared = 1;
 
 	return count;
 }
@@ -509,7 +525,8 @@ struct fmt_main fmt_NETNTLMv2 = {
 		},
 		cmp_all,
 		cmp_one,
-		cmp_exact
+		cmp_exact,
+		precompute_keys
 	}
 };
 
@@ -263,6 +263,9 @@ static void init(struct fmt_main *self)
 		tests[3].ciphertext = "$NT$030926b781938db4365d46adc7cfbcb8";
 		tests[4].plaintext = "\xE2\x82\xAC\xE2\x82\xAC";
 		tests[4].ciphertext = "$NT$682467b963bb4e61943e170a04f7db46";
+		/* long enough ASCII start for the widening fast path */
+		tests[5].plaintext = "John the Ripper \xE2\x82\xAC";
+		tests[5].ciphertext = "$NT$9390c933302019cd55480591a3308c00";
 	} else {
 		if (options.target_enc == ASCII ||
 		    options.target_enc == ISO_8859_1) {
@@ -726,7 +729,16 @@ inline static void set_key_helper_utf8(unsigned int * keybuffer, unsigned int xB
 {
 	unsigned int *target = keybuffer;
 	UTF32 chl, chh = 0x80;
-	unsigned int outlen = 0;
+	unsigned int outlen;
+
+	outlen = utf8_ascii_to_utf16_words(target, xBuf, source,
+	                                   strlen((char*)source),
+	                                   PLAINTEXT_LENGTH - 1);
+	if (outlen) {
+		source += outlen;
+		target += outlen / 2 * xBuf;
+		chh = 0; /* not a terminator */
+	}
 
 	while (*source) {
 		chl = *source;
@@ -15,6 +15,7 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <stdint.h>
 #ifdef AC_BUILT
 #include "autoconfig.h"
 #endif
@@ -35,6 +36,18 @@ typedef void (*aes_fptr_ctr)(unsigned char *, unsigned char *, unsigned char *,
 extern int using_aes_asm();
 extern const char *get_AES_type_string();
 
+/* Blocks AES_ecb_iterate() works on together */
+#define AES_ITER_STREAMS	8
+
+/*
+ * Encrypts count 16-byte blocks in place, each one rounds times over with
+ * the same 128 or 256 bit key (AES-NI is used when the CPU has it).  Give it
+ * a multiple of AES_ITER_STREAMS blocks for full speed, from many candidates
+ * at once if need be.
+ */
+extern void AES_ecb_iterate(const unsigned char *key, int bits,
+	unsigned char *blocks, size_t count, uint64_t rounds);
+
 #if HAVE_AES_ENCRYPT
 
 #include <openssl/aes.h>
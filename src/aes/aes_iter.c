@@ -0,0 +1,181 @@
+/*
+ * This file is part of John the Ripper password cracker.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted.
+ *
+ * There's ABSOLUTELY NO WARRANTY, express or implied.
+ *
+ * Iterated AES-ECB with one key over many independent blocks, for KDFs such
+ * as KeePass' key transformation.  Each AES-NI round has a latency of several
+ * cycles but the unit can start a new one every cycle, so a single block
+ * leaves it idle most of the time.  We run AES_ITER_STREAMS blocks through
+ * every round together instead.  The AES-NI code is compiled for that target
+ * only, and used if the CPU has it, so this library needs no special flags.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "../aes.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9) || __clang__)
+#define AES_ITER_NI			1
+#include <cpuid.h>
+#include <wmmintrin.h>
+#else
+#define AES_ITER_NI			0
+#endif
+
+#if AES_ITER_NI
+
+#define AES_ITER_TARGET	__attribute__((target("aes,sse2")))
+
+#define EXPAND(key, assist, shuffle) \
+	(tmp = _mm_shuffle_epi32(assist, shuffle), \
+	key = _mm_xor_si128(key, _mm_slli_si128(key, 4)), \
+	key = _mm_xor_si128(key, _mm_slli_si128(key, 4)), \
+	key = _mm_xor_si128(key, _mm_slli_si128(key, 4)), \
+	_mm_xor_si128(key, tmp))
+
+#define EXPAND_128(i, rcon) \
+	k[i] = k[i - 1]; \
+	k[i] = EXPAND(k[i], _mm_aeskeygenassist_si128(k[i - 1], rcon), 0xff)
+
+#define EXPAND_256(i, rcon) \
+	k[i] = k[i - 2]; \
+	k[i] = EXPAND(k[i], _mm_aeskeygenassist_si128(k[i - 1], rcon), 0xff); \
+	if (i < 14) { \
+		k[i + 1] = k[i - 1]; \
+		k[i + 1] = EXPAND(k[i + 1], \
+			_mm_aeskeygenassist_si128(k[i], 0), 0xaa); \
+	}
+
+#define ROUND_8(op, key) \
+	b0 = op(b0, key); b1 = op(b1, key); \
+	b2 = op(b2, key); b3 = op(b3, key); \
+	b4 = op(b4, key); b5 = op(b5, key); \
+	b6 = op(b6, key); b7 = op(b7, key)
+
+#define LOAD_8(p) \
+	b0 = _mm_loadu_si128((__m128i *)(p) + 0); \
+	b1 = _mm_loadu_si128((__m128i *)(p) + 1); \
+	b2 = _mm_loadu_si128((__m128i *)(p) + 2); \
+	b3 = _mm_loadu_si128((__m128i *)(p) + 3); \
+	b4 = _mm_loadu_si128((__m128i *)(p) + 4); \
+	b5 = _mm_loadu_si128((__m128i *)(p) + 5); \
+	b6 = _mm_loadu_si128((__m128i *)(p) + 6); \
+	b7 = _mm_loadu_si128((__m128i *)(p) + 7)
+
+#define STORE_8(p) \
+	_mm_storeu_si128((__m128i *)(p) + 0, b0); \
+	_mm_storeu_si128((__m128i *)(p) + 1, b1); \
+	_mm_storeu_si128((__m128i *)(p) + 2, b2); \
+	_mm_storeu_si128((__m128i *)(p) + 3, b3); \
+	_mm_storeu_si128((__m128i *)(p) + 4, b4); \
+	_mm_storeu_si128((__m128i *)(p) + 5, b5); \
+	_mm_storeu_si128((__m128i *)(p) + 6, b6); \
+	_mm_storeu_si128((__m128i *)(p) + 7, b7)
+
+static int aes_iter_have_ni(void)
+{
+	static int have = -1;
+	unsigned int a, b, c, d;
+
+	if (have < 0)
+		have = __get_cpuid(1, &a, &b, &c, &d) && (c & bit_AES);
+
+	return have;
+}
+
+static AES_ITER_TARGET int aes_iter_ni(const unsigned char *key, int bits,
+	unsigned char *blocks, size_t count, uint64_t rounds)
+{
+	__m128i k[15], tmp;
+	__m128i b0, b1, b2, b3, b4, b5, b6, b7;
+	int i, nr;
+	uint64_t r;
+
+	k[0] = _mm_loadu_si128((__m128i *)key);
+	if (bits == 128) {
+		nr = 10;
+		EXPAND_128(1, 0x01); EXPAND_128(2, 0x02);
+		EXPAND_128(3, 0x04); EXPAND_128(4, 0x08);
+		EXPAND_128(5, 0x10); EXPAND_128(6, 0x20);
+		EXPAND_128(7, 0x40); EXPAND_128(8, 0x80);
+		EXPAND_128(9, 0x1b); EXPAND_128(10, 0x36);
+	} else if (bits == 256) {
+		nr = 14;
+		k[1] = _mm_loadu_si128((__m128i *)key + 1);
+		EXPAND_256(2, 0x01); EXPAND_256(4, 0x02);
+		EXPAND_256(6, 0x04); EXPAND_256(8, 0x08);
+		EXPAND_256(10, 0x10); EXPAND_256(12, 0x20);
+		EXPAND_256(14, 0x40);
+	} else
+		return 0;
+
+	while (count >= AES_ITER_STREAMS) {
+		LOAD_8(blocks);
+		for (r = 0; r < rounds; r++) {
+			ROUND_8(_mm_xor_si128, k[0]);
+			for (i = 1; i < nr; i++) {
+				ROUND_8(_mm_aesenc_si128, k[i]);
+			}
+			ROUND_8(_mm_aesenclast_si128, k[nr]);
+		}
+		STORE_8(blocks);
+		blocks += AES_ITER_STREAMS * 16;
+		count -= AES_ITER_STREAMS;
+	}
+
+	while (count--) {
+		b0 = _mm_loadu_si128((__m128i *)blocks);
+		for (r = 0; r < rounds; r++) {
+			b0 = _mm_xor_si128(b0, k[0]);
+			for (i = 1; i < nr; i++)
+				b0 = _mm_aesenc_si128(b0, k[i]);
+			b0 = _mm_aesenclast_si128(b0, k[nr]);
+		}
+		_mm_storeu_si128((__m128i *)blocks, b0);
+		blocks += 16;
+	}
+
+	return 1;
+}
+
+#endif /* AES_ITER_NI */
+
+void AES_ecb_iterate(const unsigned char *key, int bits,
+	unsigned char *blocks, size_t count, uint64_t rounds)
+{
+	AES_KEY akey;
+	size_t i;
+	uint64_t r;
+
+#if AES_ITER_NI
+	if (aes_iter_have_ni() &&
+	    aes_iter_ni(key, bits, blocks, count, rounds))
+		return;
+#endif
+
+/*
+ * Without AES-NI, table based AES is bound by its loads rather than by
+ * latency, so there's little to gain from interleaving more than two blocks.
+ */
+	AES_set_encrypt_key(key, bits, &akey);
+	for (i = 0; i + 1 < count; i += 2) {
+		unsigned char *p = blocks + i * 16;
+
+		for (r = 0; r < rounds; r++) {
+			AES_encrypt(p, p, &akey);
+			AES_encrypt(p + 16, p + 16, &akey);
+		}
+	}
+	if (i < count) {
+		unsigned char *p = blocks + i * 16;
+
+		for (r = 0; r < rounds; r++)
+			AES_encrypt(p, p, &akey);
+	}
+}
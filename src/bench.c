@@ -55,6 +55,13 @@
 
 #ifndef BENCH_BUILD
 #include "options.h"
+#include "loader.h"
+#include "status.h"
+#include "cracker.h"
+#include "rpp.h"
+#include "rules.h"
+#include "timer.h"
+#include "path.h"
 #else
 /*
  * This code was copied from loader.c.  It has been stripped to bare bones
@@ -145,6 +152,7 @@ struct db_main *ldr_init_test_db(struct fmt_main *format, struct db_main *real)
 				format->params.salt_align);
 			current_salt->index = fmt_dummy_hash;
 			current_salt->bitmap = NULL;
+			current_salt->filter = NULL;
 			current_salt->list = NULL;
 			current_salt->hash = &current_salt->list;
 			current_salt->hash_size = -1;
@@ -196,6 +204,7 @@ void clk_tck_init(void)
 
 int benchmark_time = BENCHMARK_TIME;
 int benchmark_level = -1;
+int benchmark_pipeline = -1;
 
 volatile int bench_running;
 
@@ -637,6 +646,266 @@ void gather_results(struct bench_results *results)
 }
 #endif
 
+#ifndef BENCH_BUILD
+/*
+ * Machine-readable results (--bench-output) and comparison against the
+ * results of a previous run (--bench-compare).
+ */
+struct bench_baseline {
+	struct bench_baseline *next;
+	char *format, *mode;
+	double cps;
+};
+
+static FILE *bench_file;
+static int bench_csv, bench_records, bench_threshold, bench_regressions;
+static struct bench_baseline *bench_baseline;
+
+/*
+ * Extracts a field from one of our JSON records, which are one per line.
+ */
+static int bench_json_field(char *line, char *name, char *value, int size)
+{
+	char key[64], *p;
+	int n = 0;
+
+	sprintf(key, "\"%s\": ", name);
+	if (!(p = strstr(line, key)))
+		return 0;
+
+	p += strlen(key);
+	if (*p == '"') {
+		p++;
+		while (*p && *p != '"' && n < size - 1) {
+			if (*p == '\\' && p[1])
+				p++;
+			value[n++] = *p++;
+		}
+	} else
+		while (*p && *p != ',' && *p != '}' && n < size - 1)
+			value[n++] = *p++;
+	value[n] = 0;
+
+	return n > 0;
+}
+
+/*
+ * Reads one CSV field, which may be quoted (with "" for a quote), to value.
+ * Returns a pointer past the field and its separator, or NULL if empty.
+ */
+static char *bench_csv_field(char *p, char *value, int size)
+{
+	int n = 0;
+
+	if (*p == '"') {
+		p++;
+		while (*p && (*p != '"' || p[1] == '"')) {
+			if (*p == '"')
+				p++;
+			if (n < size - 1)
+				value[n++] = *p;
+			p++;
+		}
+		if (*p)
+			p++;
+	} else
+		while (*p && *p != ',' && *p != '\n') {
+			if (n < size - 1)
+				value[n++] = *p;
+			p++;
+		}
+	value[n] = 0;
+	if (*p == ',')
+		p++;
+
+	return n ? p : NULL;
+}
+
+static void bench_load_baseline(char *name)
+{
+	FILE *file;
+	char line[LINE_BUFFER_SIZE];
+
+	if (!(file = fopen(path_expand(name), "r")))
+		pexit("fopen: %s", path_expand(name));
+
+	while (fgets(line, sizeof(line), file)) {
+		char format[LINE_BUFFER_SIZE], mode[64], cps[64];
+		struct bench_baseline *entry;
+
+		if (*line == '{') {
+			if (!bench_json_field(line, "format", format,
+			                      sizeof(format)) ||
+			    !bench_json_field(line, "mode", mode, sizeof(mode)) ||
+			    !bench_json_field(line, "cps", cps, sizeof(cps)))
+				continue;
+		} else {
+			char *p = line;
+
+			if (!(p = bench_csv_field(p, format, sizeof(format))) ||
+			    !(p = bench_csv_field(p, mode, sizeof(mode))) ||
+			    !bench_csv_field(p, cps, sizeof(cps)) ||
+			    !strcmp(format, "format"))
+				continue;
+		}
+
+		entry = mem_alloc(sizeof(*entry));
+		entry->format = str_alloc_copy(format);
+		entry->mode = str_alloc_copy(mode);
+		entry->cps = atof(cps);
+		entry->next = bench_baseline;
+		bench_baseline = entry;
+	}
+
+	if (ferror(file))
+		pexit("fgets");
+	fclose(file);
+
+	if (!bench_baseline) {
+		fprintf(stderr, "No benchmark results in %s\n", name);
+		error();
+	}
+}
+
+static void bench_output_init(void)
+{
+	char *name;
+	int len;
+
+	if (!john_main_process || !benchmark_time)
+		return;
+
+	if (options.bench_output) {
+		name = path_expand(options.bench_output);
+		if (!(bench_file = fopen(name, "w")))
+			pexit("fopen: %s", name);
+		len = strlen(name);
+		bench_csv = len > 4 && !strcasecmp(&name[len - 4], ".csv");
+		if (bench_csv)
+			fputs("format,mode,cps,real,virtual,crypts,salts,"
+			      "threads,simd,algorithm\n", bench_file);
+		else
+			fputs("[\n", bench_file);
+	}
+
+	if (options.bench_compare) {
+		bench_load_baseline(options.bench_compare);
+		if ((bench_threshold = cfg_get_int(SECTION_OPTIONS, NULL,
+		    "BenchRegressionThreshold")) < 0)
+			bench_threshold = 5;
+	}
+}
+
+/*
+ * Writes a string quoted for CSV (quotes doubled) or JSON (escaped).
+ */
+static void bench_put_string(char *str)
+{
+	unsigned char *p = (unsigned char *)str;
+
+	putc('"', bench_file);
+	for (; *p; p++) {
+		if (*p == '"')
+			fputs(bench_csv ? "\"\"" : "\\\"", bench_file);
+		else if (bench_csv)
+			putc(*p, bench_file);
+		else if (*p == '\\')
+			fputs("\\\\", bench_file);
+		else if (*p < 0x20)
+			fprintf(bench_file, "\\u%04x", *p);
+		else
+			putc(*p, bench_file);
+	}
+	putc('"', bench_file);
+}
+
+static void bench_record(struct fmt_main *format, char *mode,
+	struct bench_results *results, int threads)
+{
+	struct bench_baseline *entry;
+	unsigned long long crypts;
+	double real, virtual, cps;
+	int simd = 0;
+
+	if (!john_main_process || !benchmark_time)
+		return;
+
+	crypts = ((unsigned long long)results->crypts.hi << 32) +
+		results->crypts.lo;
+	real = (double)results->real / clk_tck;
+	virtual = (double)results->virtual / clk_tck;
+	/* Too short to time: no c/s figure at all rather than inf or nan */
+	cps = real > 0 ? crypts / real : 0;
+#ifdef SIMD_COEF_32
+	simd = SIMD_COEF_32;
+#endif
+
+	if (bench_file && bench_csv) {
+		bench_put_string(format->params.label);
+		fprintf(bench_file, ",%s,%.0f,%.3f,%.3f,%llu,%d,%d,%d,", mode,
+		        cps, real, virtual, crypts, results->salts_done,
+		        threads, simd);
+		bench_put_string(format->params.algorithm_name);
+		putc('\n', bench_file);
+	} else if (bench_file) {
+		fprintf(bench_file, "%s{\"format\": ",
+		        bench_records ? ",\n" : "");
+		bench_put_string(format->params.label);
+		fprintf(bench_file, ", \"mode\": \"%s\", \"cps\": ", mode);
+		if (real > 0)
+			fprintf(bench_file, "%.0f", cps);
+		else
+			fputs("null", bench_file);
+		fprintf(bench_file, ", \"real\": %.3f, \"virtual\": %.3f, "
+		        "\"crypts\": %llu, \"salts\": %d, \"threads\": %d, "
+		        "\"simd\": %d, \"algorithm\": ", real, virtual, crypts,
+		        results->salts_done, threads, simd);
+		bench_put_string(format->params.algorithm_name);
+		putc('}', bench_file);
+	}
+	bench_records++;
+
+	if (real <= 0)
+		return;
+
+	for (entry = bench_baseline; entry; entry = entry->next) {
+		if (strcmp(entry->format, format->params.label) ||
+		    strcmp(entry->mode, mode))
+			continue;
+		if (cps < entry->cps * (100 - bench_threshold) / 100) {
+			printf("Regression:\t%.0f c/s vs. %.0f c/s (%.1f%%)\n",
+			       cps, entry->cps,
+			       100.0 * (cps - entry->cps) / entry->cps);
+			bench_regressions++;
+		}
+		break;
+	}
+}
+
+static void bench_output_done(void)
+{
+	struct bench_baseline *entry;
+
+	if (bench_file) {
+		if (!bench_csv)
+			fputs(bench_records ? "\n]\n" : "]\n", bench_file);
+		if (fclose(bench_file))
+			pexit("fclose");
+		bench_file = NULL;
+	}
+
+	if (bench_baseline && !event_abort)
+		printf("%d regression%s beyond %d%% compared to %s\n",
+		       bench_regressions, bench_regressions == 1 ? "" : "s",
+		       bench_threshold, options.bench_compare);
+
+	while ((entry = bench_baseline)) {
+		bench_baseline = entry->next;
+		MEM_FREE(entry);
+	}
+}
+#endif
+
 int benchmark_all(void)
 {
 	struct fmt_main *format;
@@ -670,6 +939,7 @@ int benchmark_all(void)
 #endif
 
 #ifndef BENCH_BUILD
+	bench_output_init();
 AGAIN:
 #endif
 	total = failed = 0;
@@ -685,6 +955,8 @@ AGAIN:
 #if defined(HAVE_OPENCL)
 		int n = 0;
 #endif
+		int threads = 1;
+
 		memHand = MEMDBG_getSnapshot(0);
 #ifndef BENCH_BUILD
 /* Silently skip formats for which we have no tests, unless forced */
@@ -727,6 +999,8 @@ AGAIN:
 #ifdef _OPENMP
 		// MPIOMPmutex may have capped the number of threads
 		ompt = omp_get_max_threads();
+		if (format->params.flags & FMT_OMP)
+			threads = ompt;
 #endif /* _OPENMP */
 
 #ifdef HAVE_MPI
@@ -893,6 +1167,9 @@ AGAIN:
 		printf("%s:\t%s c/s\n",
 			msg_m, s_real);
 #endif
+#ifndef BENCH_BUILD
+		bench_record(format, msg_m, &results_m, threads);
+#endif
 
 		if (!msg_1) {
 #ifdef HAVE_MPI
@@ -910,13 +1187,21 @@ AGAIN:
 #endif
 #if !defined(__DJGPP__) && !defined(__BEOS__) && !defined(__MINGW32__) && !defined (_MSC_VER)
 		if (benchmark_time)
-		printf("%s:\t%s c/s real, %s c/s virtual\n\n",
+		printf("%s:\t%s c/s real, %s c/s virtual\n",
 			msg_1, s_real, s_virtual);
 #else
 		if (benchmark_time)
-		printf("%s:\t%s c/s\n\n",
+		printf("%s:\t%s c/s\n",
 			msg_1, s_real);
 #endif
+#ifndef BENCH_BUILD
+		bench_record(format, msg_1, &results_1, threads);
+#endif
+#ifdef HAVE_MPI
+		if (john_main_process)
+#endif
+		if (benchmark_time)
+			putchar('\n');
 
 next:
 		fflush(stdout);
@@ -943,7 +1228,195 @@ next:
 #ifndef BENCH_BUILD
 	if (options.flags & FLG_LOOPTEST && !event_abort)
 		goto AGAIN;
+
+	bench_output_done();
+	failed += bench_regressions;
 #endif
 
 	return failed || event_abort;
 }
+
+#ifndef BENCH_BUILD
+/*
+ * Number of base words for the pipeline benchmark.  The test vectors'
+ * plaintexts come first, so the cracker also gets some real guesses.
+ */
+#define PIPELINE_WORDS			0x1000
+
+static double pipeline_now(void)
+{
+	hr_timer t;
+
+	HRSETCURRENT(t);
+	return HRGETTICKS(t);
+}
+
+static void pipeline_stage(const char *name, double ticks, double total,
+	double tps)
+{
+	printf("  %-12s%9.3f s %6.2f%%\n", name, ticks / tps,
+	       total > 0 ? 100.0 * ticks / total : 0.0);
+}
+
+/*
+ * Runs wordlist rules over our words against the database until
+ * benchmark_time seconds have passed, or until a whole pass through the
+ * rules produces no candidates.  Returns the number of candidates.
+ */
+static unsigned long long pipeline_run(struct db_main *db, char **words,
+	int count, double until)
+{
+	struct rpp_context ctx;
+	unsigned long long cands = 0, pass = 0;
+	char *prerule, *rule, *word, *last;
+	int i;
+
+	if (rpp_init(&ctx, options.activewordlistrules)) {
+		fprintf(stderr, "No \"%s\" mode rules found in %s\n",
+		        options.activewordlistrules, cfg_name);
+		error();
+	}
+	rules_init(db->format->params.plaintext_length);
+
+	while (1) {
+		last = NULL;
+		if (pipeline_now() >= until || event_abort)
+			return cands;
+		if (!(prerule = rpp_next(&ctx))) {
+			if (cands == pass ||
+			    rpp_init(&ctx, options.activewordlistrules))
+				return cands;
+			pass = cands;
+			continue;
+		}
+		if (!(rule = rules_reject(prerule, -1, NULL, db)))
+			continue;
+
+		for (i = 0; i < count; i++) {
+			if (!(word = rules_apply(words[i], rule, -1, last)))
+				continue;
+			last = word;
+			cands++;
+			if (crk_process_key(word) || event_abort)
+				return cands;
+			if (!(cands & 0xff) && pipeline_now() >= until)
+				return cands;
+		}
+	}
+}
+
+int benchmark_pipeline_all(void)
+{
+	struct fmt_main *format;
+	struct db_main *db;
+	struct crk_stage_times times;
+	char *words[PIPELINE_WORDS];
+	char s_cands[64], s_crypts[64];
+	unsigned int seed = 0x5eed;
+	int verbosity = options.verbosity;
+	int failed = 0;
+
+	if (benchmark_time <= 0)
+		benchmark_time = BENCHMARK_TIME;
+	clk_tck_init();
+	options.loader.field_sep_char = 31;
+
+	if ((format = fmt_list))
+	do {
+		struct fmt_tests *test;
+		unsigned long long cands;
+		double start, total, tps, other;
+		int length, len, n = 0;
+
+		if (!format->params.tests && format != fmt_list)
+			continue;
+		if (format->params.flags & FMT_DYNAMIC)
+			fmt_init(format);
+
+		if (!(db = ldr_init_pipeline_db(format, benchmark_pipeline))) {
+			printf("Pipeline: %s: FAILED (no test vectors)\n\n",
+			       format->params.label);
+			failed++;
+			continue;
+		}
+
+		length = format->params.plaintext_length;
+		for (test = format->params.tests;
+		     test && test->ciphertext && n < PIPELINE_WORDS / 2; test++)
+			if (test->plaintext &&
+			    (len = strlen(test->plaintext)) <= length)
+				words[n++] = strcpy(mem_alloc(len + 1),
+				                    test->plaintext);
+		while (n < PIPELINE_WORDS) {
+			char word[PLAINTEXT_BUFFER_SIZE];
+			int j;
+
+			if ((len = 4 + n % 5) > length)
+				len = length;
+			for (j = 0; j < len; j++) {
+				seed = seed * 1103515245 + 12345;
+				word[j] = 'a' + (seed >> 16) % 26;
+			}
+			word[len] = 0;
+			words[n++] = strcpy(mem_alloc(len + 1), word);
+		}
+
+		memset(&times, 0, sizeof(times));
+		/* Don't print the test vectors as we crack them */
+		options.verbosity = 1;
+		status_init(NULL, 1);
+		crk_stage_times = &times;
+		crk_init(db, NULL, NULL);
+
+		printf("Pipeline: %s%s%s%s [%s]... ",
+		    format->params.label,
+		    format->params.format_name[0] ? ", " : "",
+		    format->params.format_name,
+		    format->params.benchmark_comment,
+		    format->params.algorithm_name);
+		fflush(stdout);
+
+		HRGETTICKS_PER_SEC(tps);
+		start = pipeline_now();
+		cands = pipeline_run(db, words, n,
+		                     start + benchmark_time * tps);
+		crk_done();
+		total = pipeline_now() - start;
+
+		crk_stage_times = NULL;
+		options.verbosity = verbosity;
+
+		printf("DONE\n");
+		printf("Loaded %d hashes with %d different salts, "
+		       "cracked %u\n", db->password_count +
+		       status.guess_count, db->salt_count ? db->salt_count : 1,
+		       status.guess_count);
+
+		sprintf(s_cands, "%.0f", cands * tps / total);
+		sprintf(s_crypts, "%.0f",
+		        (((unsigned long long)status.crypts.hi << 32) +
+		         status.crypts.lo) * tps / total);
+		printf("%llu candidates in %.3f s: %s c/s, %s C/s\n",
+		       cands, total / tps, s_cands, s_crypts);
+
+		other = total - times.generate - times.set_key -
+			times.crypt_all - times.compare - times.guess;
+		pipeline_stage("generate", times.generate, total, tps);
+		pipeline_stage("set_key", times.set_key, total, tps);
+		pipeline_stage("crypt_all", times.crypt_all, total, tps);
+		pipeline_stage("compare", times.compare, total, tps);
+		pipeline_stage("guess", times.guess, total, tps);
+		pipeline_stage("other", other, total, tps);
+		putchar('\n');
+		fflush(stdout);
+
+		while (n--)
+			MEM_FREE(words[n]);
+		ldr_free_test_db(db);
+		fmt_done(format);
+		initUnicode(UNICODE_UNICODE);
+	} while ((format = format->next) && !event_abort);
+
+	return failed || event_abort;
+}
+#endif
@@ -52,6 +52,12 @@ extern void clk_tck_init(void);
 extern int benchmark_time;
 extern int benchmark_level;  /* for full test */
 
+/*
+ * Number of random hashes to load for --test=pipeline, -1 for normal
+ * benchmarks.
+ */
+extern int benchmark_pipeline;
+
 /*
  * Benchmarks the supplied cracking algorithm. Returns NULL on success,
  * an error message if the self-test fails or there are no test vectors
@@ -72,4 +78,14 @@ extern void benchmark_cps(int64 *crypts, clock_t time, char *buffer);
  */
 extern int benchmark_all(void);
 
+#ifndef BENCH_BUILD
+/*
+ * Runs a wordlist-rules cracking session for benchmark_time seconds against
+ * benchmark_pipeline random hashes (plus the test vectors) for each of the
+ * registered cracking algorithms, and prints the c/s along with the time
+ * spent in each stage of the pipeline. Returns zero on success.
+ */
+extern int benchmark_pipeline_all(void);
+#endif
+
 #endif
@@ -13,7 +13,11 @@
 #endif
 #include <math.h>
 #include <string.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include "memory.h"
+#include "line_block.h"
 #include "memdbg.h"
 
 #define C2I(c) ((unsigned int)(unsigned char)(c))
@@ -22,6 +26,53 @@ unsigned int *proba1;
 unsigned int *proba2;
 unsigned int *first;
 
+/*
+ * Counts the lines from ptr to end into p1 and p2.  Warnings about skipped
+ * characters go to out, numbering lines from nb_lignes.
+ */
+static void count_lines(const char *ptr, const char *end, int npflag,
+                        unsigned int nb_lignes,
+                        unsigned int *p1, unsigned int *p2,
+                        struct line_out *out)
+{
+	char ligne[4096];
+	unsigned int lines = 0;
+	int i, skip, prev;
+
+	while (line_block_gets(ligne, sizeof(ligne), &ptr, end)) {
+		if (ligne[0] == 0)
+			continue;
+		i = strlen(ligne) - 1;
+		while ((i > 0) && ((ligne[i] == '\n') || (ligne[i] == '\r'))) {
+			ligne[i] = 0;
+			i--;
+		}
+/*
+ * Without -p, characters outside 32 to 127 are skipped, as are the pairs
+ * they're the first of.
+ */
+		prev = 0;
+		for (i = 0; ligne[i]; i++) {
+			unsigned int c = C2I(ligne[i]);
+
+			skip = !npflag && (c < 32 || c > 127);
+			if (skip)
+				line_out_printf(out,
+				        "Warning, skipping %s character 0x%02x line %d offset %d: %s\n",
+				        c < 32 ? "non printable" : "non-ASCII",
+				        c, nb_lignes + lines, i, ligne);
+			else if (!prev) {
+				if (i == 0)
+					p1[c]++;
+				else
+					p2[C2I(ligne[i - 1]) * 256 + c]++;
+			}
+			prev = skip;
+		}
+		lines++;
+	}
+}
+
 #ifdef HAVE_LIBFUZZER
 int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
 {
@@ -36,14 +87,17 @@ int main(int argc, char **argv)
 #endif
 {
 	FILE *fichier;
-	char *ligne;
 	int i;
 	int j;
-	int np;
+	int t;
+	int threads;
 	int npflag;
 	int args;
 	unsigned int nb_lignes;
 	unsigned int nb_lettres;
+	unsigned int *p1, *p2, *lines;
+	struct line_block block;
+	struct line_out *out;
 
 	FILE *statfile;
 
@@ -80,19 +134,29 @@ int main(int argc, char **argv)
 		exit(EXIT_FAILURE);
 	}
 
-	ligne = malloc(4096);
-	if (ligne == NULL) {
+#ifdef _OPENMP
+	threads = omp_get_max_threads();
+#else
+	threads = 1;
+#endif
+
+/* Each thread counts into its own tables, which are added up at the end */
+	p2 = calloc((size_t)threads * 256 * 256, sizeof(unsigned int));
+	if (p2 == NULL) {
 		fprintf(stderr, "%s:%d: malloc failed\n", __FUNCTION__, __LINE__);
 		exit(EXIT_FAILURE);
 	}
-
-	proba2 = calloc(256 * 256, sizeof(unsigned int));
-	if (proba2 == NULL) {
+	p1 = calloc((size_t)threads * 256, sizeof(unsigned int));
+	if (p1 == NULL) {
 		fprintf(stderr, "%s:%d: malloc failed\n", __FUNCTION__, __LINE__);
 		exit(EXIT_FAILURE);
 	}
-	proba1 = calloc(256, sizeof(unsigned int));
-	if (proba1 == NULL) {
+	proba2 = p2;
+	proba1 = p1;
+
+	lines = malloc(sizeof(unsigned int) * threads);
+	out = calloc(threads, sizeof(struct line_out));
+	if (lines == NULL || out == NULL) {
 		fprintf(stderr, "%s:%d: malloc failed\n", __FUNCTION__, __LINE__);
 		exit(EXIT_FAILURE);
 	}
@@ -100,42 +164,50 @@ int main(int argc, char **argv)
 	statfile = fopen(argv[2 + args], "w");
 
 	nb_lignes = 0;
-	while (fgets(ligne, 4096, fichier)) {
-		if (ligne[0] == 0)
-			continue;
-		i = strlen(ligne) - 1;
-		while ((i > 0) && ((ligne[i] == '\n') || (ligne[i] == '\r'))) {
-			ligne[i] = 0;
-			i--;
-		}
-		for (i = 0; ligne[i]; i++) {
-			np = 0;
-			if (!npflag) {
-				if (C2I(ligne[i]) < 32) {
-					fprintf(stderr,
-					        "Warning, skipping non printable character 0x%02x line %d offset %d: %s\n",
-					        (unsigned char)ligne[i], nb_lignes, i, ligne);
-					np += 1;
-				}
-				if (C2I(ligne[i]) > 127) {
-					fprintf(stderr,
-					        "Warning, skipping non-ASCII character 0x%02x line %d offset %d: %s\n",
-					        (unsigned char)ligne[i], nb_lignes, i, ligne);
-					np += 1;
-				}
-				if ((i > 0) && (C2I(ligne[i - 1]) < 32)) {
-					np += 2;
-				}
-				if ((i > 0) && (C2I(ligne[i - 1]) > 127)) {
-					np += 2;
-				}
-			}
-			if ((i == 0) && ((np == 0) || (npflag == 1)))
-				proba1[C2I(ligne[0])]++;
-			if ((i > 0) && ((np == 0) || (npflag == 1)))
-				proba2[C2I(ligne[i - 1]) * 256 + C2I(ligne[i])]++;
+	line_block_init(&block, fichier, 4096);
+	while (line_block_read(&block)) {
+/*
+ * Each thread takes a part of the block.  Lines are counted first, so that
+ * warnings can give line numbers, and those are written in order after.
+ */
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(threads)
+#endif
+		for (t = 0; t < threads; t++)
+			lines[t] = line_block_count(4096,
+			    line_block_part(&block, t, threads),
+			    line_block_part(&block, t + 1, threads));
+
+		for (t = 0; t < threads; t++) {
+			unsigned int count = lines[t];
+
+			lines[t] = nb_lignes;
+			nb_lignes += count;
 		}
-		nb_lignes++;
+
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(threads)
+#endif
+		for (t = 0; t < threads; t++)
+			count_lines(line_block_part(&block, t, threads),
+			            line_block_part(&block, t + 1, threads),
+			            npflag, lines[t], p1 + t * 256,
+			            p2 + t * 256 * 256, &out[t]);
+
+		for (t = 0; t < threads; t++)
+			line_out_flush(&out[t], stderr);
+	}
+	line_block_done(&block);
+	for (t = 0; t < threads; t++)
+		line_out_done(&out[t]);
+	MEM_FREE(out);
+	MEM_FREE(lines);
+
+	for (t = 1; t < threads; t++) {
+		for (i = 0; i < 256; i++)
+			proba1[i] += p1[t * 256 + i];
+		for (i = 0; i < 256 * 256; i++)
+			proba2[i] += p2[t * 256 * 256 + i];
 	}
 
 	for (i = 0; i < 256; i++) {
@@ -194,7 +266,6 @@ int main(int argc, char **argv)
 
 	MEM_FREE(first);
 
-	MEM_FREE(ligne);
 	fclose(fichier);
 
 	MEMDBG_PROGRAM_EXIT_CHECKS(stderr);
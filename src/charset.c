@@ -25,100 +25,125 @@
 #include "charset.h"
 #include "memdbg.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 typedef unsigned int (*char_counters)
 	[CHARSET_SIZE + 1][CHARSET_SIZE + 1][CHARSET_SIZE];
 
 typedef unsigned int (*crack_counters)
 	[CHARSET_LENGTH][CHARSET_LENGTH][CHARSET_SIZE];
 
+/*
+ * Counting a {length, pos} pair over fewer plaintexts than this isn't worth
+ * starting threads and adding up their tables for.
+ */
+#define CHARSET_PARALLEL_MIN		0x10000
+
+/* Which rows of a char_counters table have been counted into */
+typedef unsigned char (*row_flags)[CHARSET_SIZE + 1];
+
 static CRC32_t checksum;
 
-static unsigned long charset_filter_plaintexts(struct db_main *db,
-    struct list_main **lists)
+/*
+ * Plaintexts are counted as they're loaded rather than kept in a list.  Those
+ * of a given length (zero-based, like elsewhere in here) are stored back to
+ * back with no terminator, as that's all we need of them.  The catch-all
+ * length used to be kept for its characters only, so we just count those.
+ */
+static struct {
+	char *data;
+	size_t count, size;
+} plaintexts[CHARSET_LENGTH];
+static unsigned int char_totals[CHARSET_SIZE];
+static unsigned long plaintexts_total, plaintexts_kept;
+
+void charset_add_plaintext(char *plaintext)
 {
-	int length, old_length;
-	unsigned long count;
-	struct list_entry *current, *next;
+	int length;
 	char *ptr, key[PLAINTEXT_BUFFER_SIZE];
 
-	for (length = 0; length <= CHARSET_LENGTH; length++)
-		list_init(&lists[length]);
-
-	count = 0;
-
-	if ((current = db->plaintexts->head))
-	do {
-		next = current->next;
+	plaintexts_total++;
 
-		if (!current->data[0])
-			continue;
+	if (!*plaintext)
+		return;
 
-		old_length = 0;
-		ptr = current->data;
-		if (f_filter) {
-			old_length = strlen(current->data);
+	ptr = plaintext;
+	if (f_filter) {
+		length = strlen(plaintext);
 /*
- * The current->data string might happen to end near page boundary and the next
- * page might not be mapped, whereas ext_filter_body() may pre-read a few chars
+ * The plaintext might happen to end near page boundary and the next page
+ * might not be mapped, whereas ext_filter_body() may pre-read a few chars
  * beyond NUL for greater speed in uses during cracking.  Also, the external
  * filter() may make the string longer.  Finally, ext_filter_body() assumes
  * that the string passed to it fits in PLAINTEXT_BUFFER_SIZE.  Hence, we copy
  * the string here.
  */
-			if (old_length < sizeof(key)) {
-				memcpy(key, current->data, old_length + 1);
-			} else {
-				memcpy(key, current->data, sizeof(key) - 1);
-				key[sizeof(key) - 1] = 0;
-			}
-			if (!ext_filter_body(key, key))
-				continue;
-			ptr = key;
+		if (length < sizeof(key)) {
+			memcpy(key, plaintext, length + 1);
+		} else {
+			memcpy(key, plaintext, sizeof(key) - 1);
+			key[sizeof(key) - 1] = 0;
 		}
+		if (!ext_filter_body(key, key))
+			return;
+		ptr = key;
+	}
 
-		length = 0;
-		while (*ptr) {
-			int c = *(unsigned char *)ptr;
-			if (c < CHARSET_MIN || c > CHARSET_MAX)
-				break;
-			length++;
-			ptr++;
-		}
+	length = 0;
+	while (ptr[length]) {
+		int c = ((unsigned char *)ptr)[length];
+		if (c < CHARSET_MIN || c > CHARSET_MAX)
+			return;
+		length++;
+	}
+
+	if (!length)
+		return;
+
+	plaintexts_kept++;
 
-		if (!*ptr) {
-			struct list_main *list;
-/*
- * lists[CHARSET_LENGTH] is a catch-all for excessive length strings that
- * nevertheless consist exclusively of characters in the CHARSET_MIN to
- * CHARSET_MAX range (including in their portion beyond CHARSET_LENGTH).
- */
-			if (length > CHARSET_LENGTH)
-				list = lists[CHARSET_LENGTH];
-			else
-				list = lists[length - 1];
-			if (old_length) {
-				if (length > old_length) {
-					list_add(list, key);
-				} else {
-					memcpy(current->data, key, length + 1);
-					list_add_link(list, current);
-				}
-			} else {
 /*
- * Truncate very long strings at PLAINTEXT_BUFFER_SIZE for consistency with
- * what would happen if we applied a dummy filter(), as well as for easy
- * testing against older revisions of this code.
+ * Strings longer than CHARSET_LENGTH only contribute to the overall character
+ * counts.  Very long ones are truncated at PLAINTEXT_BUFFER_SIZE for
+ * consistency with what would happen if we applied a dummy filter(), as well
+ * as for easy testing against older revisions of this code.
  */
-				if (length >= PLAINTEXT_BUFFER_SIZE)
-					current->data
-					    [PLAINTEXT_BUFFER_SIZE - 1] = 0;
-				list_add_link(list, current);
-			}
-			count++;
+	{
+		int i, n = length;
+
+		if (n >= PLAINTEXT_BUFFER_SIZE)
+			n = PLAINTEXT_BUFFER_SIZE - 1;
+		for (i = 0; i < n; i++)
+			char_totals[((unsigned char *)ptr)[i] - CHARSET_MIN]++;
+	}
+
+	if (length <= CHARSET_LENGTH) {
+		size_t used;
+
+		length--;
+		used = plaintexts[length].count * (length + 1);
+		if (used + length + 1 > plaintexts[length].size) {
+			plaintexts[length].size = plaintexts[length].size ?
+			    plaintexts[length].size * 2 : 0x10000;
+			plaintexts[length].data = mem_realloc(
+			    plaintexts[length].data, plaintexts[length].size);
 		}
-	} while ((current = next));
+		memcpy(plaintexts[length].data + used, ptr, length + 1);
+		plaintexts[length].count++;
+	}
+}
 
-	return count;
+static void charset_free_plaintexts(void)
+{
+	int length;
+
+	for (length = 0; length < CHARSET_LENGTH; length++)
+		MEM_FREE(plaintexts[length].data);
+	memset(plaintexts, 0, sizeof(plaintexts));
+	memset(char_totals, 0, sizeof(char_totals));
+	plaintexts_total = plaintexts_kept = 0;
 }
 
 static int cfputc(int c, FILE *stream)
@@ -209,35 +234,136 @@ static int cmp_count(const void *p1, const void *p2)
 	return c1->index - c2->index;
 }
 
-static void charset_generate_chars(struct list_main **lists,
-	FILE *file, struct charset_header *header,
+/*
+ * Counts the character at pos, and the two before it if there are as many,
+ * into those rows of chars that are used for pos.  The rows touched are
+ * flagged in used, if given.
+ */
+static inline void charset_count(const unsigned char *ptr, int pos,
+	char_counters chars, row_flags used)
+{
+	int a, b, c = ARCH_INDEX(ptr[pos] - CHARSET_MIN);
+
+	(*chars)[CHARSET_SIZE][CHARSET_SIZE][c]++;
+	if (used)
+		used[CHARSET_SIZE][CHARSET_SIZE] = 1;
+	if (!pos)
+		return;
+
+	b = ARCH_INDEX(ptr[pos - 1] - CHARSET_MIN);
+	(*chars)[CHARSET_SIZE][b][c]++;
+	if (used)
+		used[CHARSET_SIZE][b] = 1;
+	if (pos == 1)
+		return;
+
+	a = ARCH_INDEX(ptr[pos - 2] - CHARSET_MIN);
+	(*chars)[a][b][c]++;
+	if (used)
+		used[a][b] = 1;
+}
+
+/*
+ * Fills the rows of chars used for {length, pos} from the plaintexts of that
+ * length.  With more than one thread, each counts its share of them into its
+ * own table, and the rows it touched are then added up.  The local tables are
+ * left zeroed for the next call.
+ */
+static void charset_count_pos(int length, int pos, char_counters chars,
+	char_counters *local, row_flags *used, int threads)
+{
+	const unsigned char *data =
+	    (const unsigned char *)plaintexts[length].data;
+	size_t count = plaintexts[length].count;
+	int width = length + 1;
+
+	switch (pos) {
+	case 0:
+		memset((*chars)[CHARSET_SIZE][CHARSET_SIZE], 0,
+		    sizeof((*chars)[CHARSET_SIZE][CHARSET_SIZE]));
+		break;
+	case 1:
+		memset((*chars)[CHARSET_SIZE], 0,
+		    sizeof((*chars)[CHARSET_SIZE]));
+		break;
+	default:
+		memset(chars, 0, sizeof(*chars));
+	}
+
+	if (threads < 2 || count < CHARSET_PARALLEL_MIN) {
+		size_t n;
+
+		for (n = 0; n < count; n++)
+			charset_count(data + n * width, pos, chars, NULL);
+		return;
+	}
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(threads)
+	{
+		int t = omp_get_thread_num();
+		long n;
+
+#pragma omp for schedule(static)
+		for (n = 0; n < (long)count; n++)
+			charset_count(data + n * width, pos, local[t], used[t]);
+	}
+
+	{
+		int i0 = pos > 1 ? 0 : CHARSET_SIZE;
+		int j0 = pos ? 0 : CHARSET_SIZE;
+		int i;
+
+#pragma omp parallel for num_threads(threads) schedule(dynamic)
+		for (i = i0; i <= CHARSET_SIZE; i++) {
+			int j, k, t;
+
+			for (j = j0; j <= CHARSET_SIZE; j++)
+			for (t = 0; t < threads; t++) {
+				unsigned int *src = (*local[t])[i][j];
+
+				if (!used[t][i][j])
+					continue;
+				used[t][i][j] = 0;
+				for (k = 0; k < CHARSET_SIZE; k++)
+					(*chars)[i][j][k] += src[k];
+				memset(src, 0, sizeof((*chars)[i][j]));
+			}
+		}
+	}
+#endif
+}
+
+static void charset_generate_chars(FILE *file,
+	struct charset_header *header,
 	char_counters chars, crack_counters cracks)
 {
-	struct list_entry *current;
 	unsigned char buffer[CHARSET_SIZE];
 	count_sort_t iv[CHARSET_SIZE];
 	int length, pos, count;
 	int i, j, k;
+	int threads = 1;
+	char_counters *local = NULL;
+	row_flags *used = NULL;
 
 	memset(cracks, 0, sizeof(*cracks));
 
-/* Zeroize the same portion of "chars" as is used by the loop below */
-	memset((*chars)[0][0], 0, sizeof((*chars)[0][0]));
-
-	for (length = 0; length <= CHARSET_LENGTH; length++) {
-		if ((current = lists[length]->head))
-		do {
-			char *ptr;
-			for (ptr = current->data; *ptr; ptr++) {
-				int c = *(unsigned char *)ptr;
-				(*chars)[0][0][ARCH_INDEX(c - CHARSET_MIN)]++;
-			}
-		} while ((current = current->next));
+#ifdef _OPENMP
+	if (plaintexts_kept >= CHARSET_PARALLEL_MIN &&
+	    (threads = omp_get_max_threads()) > 1) {
+/* Only the rows actually counted into will get touched */
+		local = mem_alloc(threads * sizeof(*local));
+		used = mem_alloc(threads * sizeof(*used));
+		for (i = 0; i < threads; i++) {
+			local[i] = mem_calloc(1, sizeof(*local[i]));
+			used[i] = mem_calloc(CHARSET_SIZE + 1, sizeof(*used[i]));
+		}
 	}
+#endif
 
 	count = 0;
 	for (k = 0; k < CHARSET_SIZE; k++) {
-		unsigned int value = (*chars)[0][0][k];
+		unsigned int value = char_totals[k];
 		if (value) {
 			iv[count].index = k;
 			iv[count++].value = value;
@@ -257,47 +383,12 @@ static void charset_generate_chars(struct list_main **lists,
 	for (length = 0; charset_new_length(length, header, file); length++)
 	for (pos = 0; pos <= length; pos++) {
 		if (event_abort)
-			return;
+			goto out;
 
-		if (!(current = lists[length]->head))
+		if (!plaintexts[length].count)
 			continue;
 
-		switch (pos) {
-		case 0:
-			memset((*chars)[CHARSET_SIZE][CHARSET_SIZE], 0,
-			    sizeof((*chars)[CHARSET_SIZE][CHARSET_SIZE]));
-			do {
-				unsigned char *ptr =
-				    (unsigned char *)current->data;
-				int c = ARCH_INDEX(ptr[0] - CHARSET_MIN);
-				(*chars)[CHARSET_SIZE][CHARSET_SIZE][c]++;
-			} while ((current = current->next));
-			break;
-		case 1:
-			memset((*chars)[CHARSET_SIZE], 0,
-			    sizeof((*chars)[CHARSET_SIZE]));
-			do {
-				unsigned char *ptr =
-				    (unsigned char *)current->data;
-				int b = ARCH_INDEX(ptr[0] - CHARSET_MIN);
-				int c = ARCH_INDEX(ptr[1] - CHARSET_MIN);
-				(*chars)[CHARSET_SIZE][b][c]++;
-				(*chars)[CHARSET_SIZE][CHARSET_SIZE][c]++;
-			} while ((current = current->next));
-			break;
-		default:
-			memset(chars, 0, sizeof(*chars));
-			do {
-				unsigned char *ptr =
-				    (unsigned char *)current->data;
-				int a = ARCH_INDEX(ptr[pos - 2] - CHARSET_MIN);
-				int b = ARCH_INDEX(ptr[pos - 1] - CHARSET_MIN);
-				int c = ARCH_INDEX(ptr[pos] - CHARSET_MIN);
-				(*chars)[a][b][c]++;
-				(*chars)[CHARSET_SIZE][b][c]++;
-				(*chars)[CHARSET_SIZE][CHARSET_SIZE][c]++;
-			} while ((current = current->next));
-		}
+		charset_count_pos(length, pos, chars, local, used, threads);
 
 		cfputc(CHARSET_ESC, file); cfputc(CHARSET_NEW, file);
 		cfputc(length, file); cfputc(pos, file);
@@ -335,6 +426,16 @@ static void charset_generate_chars(struct list_main **lists,
 
 	cfputc(CHARSET_ESC, file); cfputc(CHARSET_NEW, file);
 	cfputc(CHARSET_LENGTH, file);
+
+out:
+	if (local) {
+		for (i = 0; i < threads; i++) {
+			MEM_FREE(used[i]);
+			MEM_FREE(local[i]);
+		}
+		MEM_FREE(used);
+		MEM_FREE(local);
+	}
 }
 
 static double powi(int x, unsigned int y)
@@ -626,7 +727,7 @@ out:
 	MEM_FREE(ratios);
 }
 
-static void charset_generate_all(struct list_main **lists, char *charset)
+static void charset_generate_all(char *charset)
 {
 	FILE *file;
 	int was_error;
@@ -648,7 +749,7 @@ static void charset_generate_all(struct list_main **lists, char *charset)
 	printf("Generating charsets");
 	fflush(stdout);
 
-	charset_generate_chars(lists, file, header, chars, cracks);
+	charset_generate_chars(file, header, chars, cracks);
 	if (!event_abort) {
 		printf(" DONE\nGenerating cracking order");
 		fflush(stdout);
@@ -693,17 +794,16 @@ static void charset_generate_all(struct list_main **lists, char *charset)
 
 void do_makechars(struct db_main *db, char *charset)
 {
-	struct list_main *lists[CHARSET_LENGTH + 1];
 	unsigned long total, remaining;
 
-	total = db->plaintexts->count;
+	total = plaintexts_total;
 
 	printf("Loaded %lu plaintext%s%s\n",
 		total,
 		total != 1 ? "s" : "",
 		total ? "" : ", exiting...");
 
-	remaining = charset_filter_plaintexts(db, lists);
+	remaining = plaintexts_kept;
 
 	if (remaining < total)
 		printf("Remaining %lu plaintext%s%s\n",
@@ -711,10 +811,11 @@ void do_makechars(struct db_main *db, char *charset)
 			remaining != 1 ? "s" : "",
 			remaining ? "" : ", exiting...");
 
-	if (!remaining)
-		return;
+	if (remaining) {
+		CRC32_Init(&checksum);
 
-	CRC32_Init(&checksum);
+		charset_generate_all(charset);
+	}
 
-	charset_generate_all(lists, charset);
+	charset_free_plaintexts();
 }
@@ -72,7 +72,14 @@ struct charset_header {
 extern int charset_read_header(FILE *file, struct charset_header *header);
 
 /*
- * Generates a charset file, based on plaintexts in the database.
+ * Counts a plaintext towards the next charset file, applying the external
+ * filter() if one is loaded.  The loader calls this for --make-charset
+ * instead of keeping a list of all plaintexts.
+ */
+extern void charset_add_plaintext(char *plaintext);
+
+/*
+ * Generates a charset file, based on the plaintexts added since the last one.
  */
 extern void do_makechars(struct db_main *db, char *charset);
 
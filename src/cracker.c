@@ -49,6 +49,7 @@
 #include "recovery.h"
 #include "external.h"
 #include "options.h"
+#include "config.h"
 #include "mask_ext.h"
 #include "mask.h"
 #include "unicode.h"
@@ -61,6 +62,7 @@
 #endif
 #include "path.h"
 #include "jumbo.h"
+#include "timer.h"
 #if HAVE_LIBDL && defined(HAVE_OPENCL)
 #include "common-gpu.h"
 #endif
@@ -96,6 +98,24 @@ static struct db_keys *crk_guesses;
 static int64 *crk_timestamps;
 static char crk_stdout_key[PLAINTEXT_BUFFER_SIZE];
 int64_t crk_pot_pos;
+struct crk_stage_times *crk_stage_times;
+static double crk_stage_last, crk_stage_cmp;
+/* get_hash_batch() output, for formats that have it */
+static unsigned int *crk_hashes;
+
+/* Candidates per batch as picked by crk_adapt_batch(), the time a batch may
+ * take over all salts (in timer ticks, zero to always use max_keys_per_crypt),
+ * and the lowest time per candidate seen */
+static int crk_max_keys, crk_batch_locked;
+static double crk_pass_target, crk_key_cost;
+
+static MAYBE_INLINE double crk_stage_now(void)
+{
+	hr_timer t;
+
+	HRSETCURRENT(t);
+	return HRGETTICKS(t);
+}
 
 static void crk_dummy_set_salt(void *salt)
 {
@@ -105,6 +125,63 @@ static void crk_dummy_fix_state(void)
 {
 }
 
+/*
+ * With many salts, or a slow enough format, a full batch over all salts can
+ * take long.  When it takes longer than crk_pass_target, halve the batch, but
+ * only as long as this costs little per candidate: many formats have a fixed
+ * cost per salt per crypt_all() call, which smaller batches spread over fewer
+ * candidates.
+ */
+static void crk_init_batch(struct db_main *db)
+{
+	int seconds;
+	double ticks_per_sec;
+
+	crk_max_keys = crk_params.max_keys_per_crypt;
+	crk_pass_target = crk_key_cost = 0;
+	crk_batch_locked = 0;
+
+	if (!db->loaded || db->salt_count < 2 || options.force_maxkeys ||
+	    crk_params.min_keys_per_crypt >= crk_params.max_keys_per_crypt ||
+	    strstr(crk_params.label, "-opencl"))
+		return;
+
+	if ((seconds = cfg_get_int(SECTION_OPTIONS, NULL, "SaltPassTime")) < 0)
+		seconds = CRK_PASS_TIME;
+	HRGETTICKS_PER_SEC(ticks_per_sec);
+	crk_pass_target = seconds * ticks_per_sec;
+}
+
+static void crk_adapt_batch(double elapsed, int count)
+{
+	int min = crk_params.min_keys_per_crypt;
+	int max = crk_params.max_keys_per_crypt;
+	int keys = crk_max_keys;
+	double cost = elapsed / count;
+
+/* A partial batch (such as the last one of a wordlist) tells us little */
+	if (count < crk_max_keys)
+		return;
+
+	if (!crk_key_cost || cost < crk_key_cost)
+		crk_key_cost = cost;
+
+	if (cost > crk_key_cost * 1.1) {
+		keys = MIN(max, keys * 2);
+		crk_batch_locked = 1;
+	} else if (elapsed > crk_pass_target && keys > min &&
+	           !crk_batch_locked)
+		keys = MAX(min, keys / 2 / min * min);
+	else if (elapsed < crk_pass_target / 4 && keys < max)
+		keys = MIN(max, keys * 2);
+
+	if (keys != crk_max_keys) {
+		log_event("- Batch size %d for %d salts", keys,
+		          crk_db->salt_count);
+		crk_max_keys = keys;
+	}
+}
+
 static void crk_init_salt(void)
 {
 	if (!crk_db->salts->next) {
@@ -189,8 +266,10 @@ void crk_init(struct db_main *db, void (*fix_state)(void),
 #endif
 
 	if (db->loaded) crk_init_salt();
+	crk_init_batch(db);
 	crk_last_key = crk_key_index = 0;
 	crk_last_salt = NULL;
+	crk_stage_last = 0;
 
 	if (fix_state)
 		(crk_fix_state = fix_state)();
@@ -202,10 +281,15 @@ void crk_init(struct db_main *db, void (*fix_state)(void),
 
 	crk_guesses = guesses;
 
+	crk_hashes = NULL;
 	if (db->loaded) {
 		size = crk_params.max_keys_per_crypt * sizeof(int64);
 		memset(crk_timestamps = mem_alloc_tiny(size, sizeof(int64)),
 		       -1, size);
+		if (crk_methods.get_hash_batch)
+			crk_hashes = mem_alloc_tiny(
+			    crk_params.max_keys_per_crypt * sizeof(*crk_hashes),
+			    MEM_ALIGN_CACHE);
 	} else
 		crk_stdout_key[0] = 0;
 
@@ -324,6 +408,20 @@ static void crk_remove_hash(struct db_salt *salt, struct db_password *pw)
 		pw->binary = NULL;
 }
 
+/*
+ * Called between crypt_all() calls.  Once enough of a salt's hashes are gone
+ * that the loader would have picked a smaller bitmap and hash table, switch
+ * to that size so that lookups touch fewer cache lines.  The count
+ * only drops so this happens at most once per size.
+ */
+static MAYBE_INLINE void crk_shrink_hash(struct db_salt *salt)
+{
+	if (salt->hash_size > 0 && salt->count &&
+	    salt->count < password_hash_thresholds[salt->hash_size] &&
+	    !options.regen_lost_salts)
+		ldr_shrink_hash(crk_db, salt);
+}
+
 /* Negative index is not counted/reported (got it from pot sync) */
 static int crk_process_guess(struct db_salt *salt, struct db_password *pw,
 	int index)
@@ -333,6 +431,9 @@ static int crk_process_guess(struct db_salt *salt, struct db_password *pw,
 	char tmp8[PLAINTEXT_BUFFER_SIZE + 1];
 	int dupe;
 	char *key, *utf8key, *repkey, *replogin, *repuid;
+	double start = crk_stage_times ? crk_stage_now() : 0;
+
+	STATUS_COUNT(guesses, 1);
 
 	if (index >= 0 && index < crk_params.max_keys_per_crypt) {
 		dupe = !memcmp(&crk_timestamps[index],
@@ -434,6 +535,9 @@ static int crk_process_guess(struct db_salt *salt, struct db_password *pw,
 	if (!(crk_params.flags & FMT_NOT_EXACT))
 		crk_remove_hash(salt, pw);
 
+	if (crk_stage_times)
+		crk_stage_times->guess += crk_stage_now() - start;
+
 	if (!crk_db->salts)
 		return 1;
 
@@ -776,6 +880,11 @@ static int crk_process_event(void)
 		status_print();
 	}
 
+	if (event_status_file) {
+		event_status_file = 0;
+		status_write_file(crk_db);
+	}
+
 	if (event_ticksafety) {
 		event_ticksafety = 0;
 		status_ticks_overflow_safety();
@@ -797,10 +906,37 @@ void crk_set_hybrid_fix_state_func_ptr(fix_state_fp fp)
 	fp_fix_state = fp;
 }
 
+/*
+ * These wrap the format's comparison methods so that we can count their
+ * calls.  Without STATUS_COUNTERS, they're just the methods.
+ */
+static MAYBE_INLINE int crk_cmp_all(void *binary, int count)
+{
+	int match = crk_methods.cmp_all(binary, count);
+
+	STATUS_COUNT(probes, 1);
+	if (match)
+		STATUS_COUNT(hits, 1);
+
+	return match;
+}
+
+static MAYBE_INLINE int crk_cmp_one(void *binary, int index)
+{
+	STATUS_COUNT(cmp_one, 1);
+	return crk_methods.cmp_one(binary, index);
+}
+
+static MAYBE_INLINE int crk_cmp_exact(char *source, int index)
+{
+	STATUS_COUNT(cmp_exact, 1);
+	return crk_methods.cmp_exact(source, index);
+}
+
 static int crk_password_loop(struct db_salt *salt)
 {
 	int count;
-	unsigned int match, index;
+	unsigned int match, index, *hashes;
 #if CRK_PREFETCH
 	unsigned int target;
 #endif
@@ -818,8 +954,16 @@ static int crk_password_loop(struct db_salt *salt)
 		fp_fix_state();
 
 	count = crk_key_index;
-	match = crk_methods.crypt_all(&count, salt);
+	if (crk_stage_times) {
+		double start = crk_stage_now();
+
+		match = crk_methods.crypt_all(&count, salt);
+		crk_stage_cmp = crk_stage_now();
+		crk_stage_times->crypt_all += crk_stage_cmp - start;
+	} else
+		match = crk_methods.crypt_all(&count, salt);
 	crk_last_key = count;
+	STATUS_COUNT(crypts, count);
 
 	{
 		int64 effective_count;
@@ -833,10 +977,10 @@ static int crk_password_loop(struct db_salt *salt)
 	if (!salt->bitmap) {
 		struct db_password *pw = salt->list;
 		do {
-			if (crk_methods.cmp_all(pw->binary, match))
+			if (crk_cmp_all(pw->binary, match))
 			for (index = 0; index < match; index++)
-			if (crk_methods.cmp_one(pw->binary, index))
-			if (crk_methods.cmp_exact(crk_methods.source(
+			if (crk_cmp_one(pw->binary, index))
+			if (crk_cmp_exact(crk_methods.source(
 			    pw->source, pw->binary), index)) {
 				if (crk_process_guess(salt, pw, index))
 					return 1;
@@ -850,32 +994,61 @@ static int crk_password_loop(struct db_salt *salt)
 		return 0;
 	}
 
+/*
+ * Have the format hash all of its outputs in one go if it can, it's likely
+ * to do so straight from its SIMD buffers.  crypt_all() may return more than
+ * max_keys_per_crypt, in which case we have no room and fall back.
+ */
+	hashes = NULL;
+	if (crk_hashes && match <= crk_params.max_keys_per_crypt) {
+		crk_methods.get_hash_batch(salt->hash_size, match, crk_hashes);
+		hashes = crk_hashes;
+	}
+#define CRK_HASH(i) \
+	(hashes ? hashes[i] : (unsigned int)salt->index(i))
+
 #if CRK_PREFETCH
 	for (index = 0; index < match; index = target) {
-		unsigned int slot, ahead, lucky;
+		unsigned int slot, slots, ahead, lucky;
 		struct {
-			unsigned int i;
+			unsigned int i, n;
 			union {
 				unsigned int *b;
 				struct db_password **p;
 			} u;
 		} a[CRK_PREFETCH];
+#if PASSWORD_HASH_FILTER_SIZE
+		unsigned int *filter = salt->filter;
+#endif
 		target = index + crk_prefetch;
 		if (target > match)
 			target = match;
-		for (slot = 0, ahead = index; ahead < target; slot++, ahead++) {
-			unsigned int h = salt->index(ahead);
-			unsigned int *b = &salt->bitmap[h / (sizeof(*salt->bitmap) * 8)];
+		for (slot = 0, ahead = index; ahead < target; ahead++) {
+			unsigned int h = CRK_HASH(ahead);
+			unsigned int *b;
+#if PASSWORD_HASH_FILTER_SIZE
+/* The filter is meant to stay in cache, so don't bother prefetching it */
+			if (filter) {
+				unsigned int f = h % PASSWORD_HASH_FILTER_SIZE;
+				if (!(filter[f / (sizeof(*filter) * 8)] &
+				    (1U << (f % (sizeof(*filter) * 8)))))
+					continue;
+			}
+#endif
+			b = &salt->bitmap[h / (sizeof(*salt->bitmap) * 8)];
 			a[slot].i = h;
-			a[slot].u.b = b;
+			a[slot].n = ahead;
+			a[slot++].u.b = b;
 #ifdef __SSE__
 			_mm_prefetch((const char *)b, _MM_HINT_NTA);
 #else
 			*(volatile unsigned int *)b;
 #endif
 		}
+		slots = slot;
 		lucky = 0;
-		for (slot = 0, ahead = index; ahead < target; slot++, ahead++) {
+		STATUS_COUNT(probes, target - index);
+		for (slot = 0; slot < slots; slot++) {
 			unsigned int h = a[slot].i;
 			if (*a[slot].u.b & (1U << (h % (sizeof(*salt->bitmap) * 8)))) {
 				struct db_password **pwp = &salt->hash[h >> PASSWORD_HASH_SHR];
@@ -884,10 +1057,11 @@ static int crk_password_loop(struct db_salt *salt)
 #else
 				*(void * volatile *)pwp;
 #endif
-				a[lucky].i = ahead;
+				a[lucky].i = a[slot].n;
 				a[lucky++].u.p = pwp;
 			}
 		}
+		STATUS_COUNT(hits, lucky);
 #if 1
 		if (!lucky)
 			continue;
@@ -909,8 +1083,8 @@ static int crk_password_loop(struct db_salt *salt)
 			struct db_password *pw = *a[slot].u.p;
 			index = a[slot].i;
 			do {
-				if (crk_methods.cmp_one(pw->binary, index))
-				if (crk_methods.cmp_exact(crk_methods.source(
+				if (crk_cmp_one(pw->binary, index))
+				if (crk_cmp_exact(crk_methods.source(
 				    pw->source, pw->binary), index)) {
 					if (crk_process_guess(salt, pw, index))
 						return 1;
@@ -922,7 +1096,7 @@ static int crk_password_loop(struct db_salt *salt)
 					if (slot + 1 < lucky) {
 						struct db_password *first =
 						    salt->hash[
-						    salt->index(index) >>
+						    CRK_HASH(index) >>
 						    PASSWORD_HASH_SHR];
 						if (pw == first || !first) {
 							target = a[slot + 1].i;
@@ -934,15 +1108,24 @@ static int crk_password_loop(struct db_salt *salt)
 		}
 	}
 #else
+	STATUS_COUNT(probes, match);
 	for (index = 0; index < match; index++) {
-		unsigned int hash = salt->index(index);
+		unsigned int hash = CRK_HASH(index);
+#if PASSWORD_HASH_FILTER_SIZE
+		if (salt->filter &&
+		    !(salt->filter[hash % PASSWORD_HASH_FILTER_SIZE /
+		    (sizeof(*salt->filter) * 8)] &
+		    (1U << (hash % (sizeof(*salt->filter) * 8)))))
+			continue;
+#endif
 		if (salt->bitmap[hash / (sizeof(*salt->bitmap) * 8)] &
 		    (1U << (hash % (sizeof(*salt->bitmap) * 8)))) {
 			struct db_password *pw =
 			    salt->hash[hash >> PASSWORD_HASH_SHR];
+			STATUS_COUNT(hits, 1);
 			do {
-				if (crk_methods.cmp_one(pw->binary, index))
-				if (crk_methods.cmp_exact(crk_methods.source(
+				if (crk_cmp_one(pw->binary, index))
+				if (crk_cmp_exact(crk_methods.source(
 				    pw->source, pw->binary), index))
 				if (crk_process_guess(salt, pw, index))
 					return 1;
@@ -950,6 +1133,7 @@ static int crk_password_loop(struct db_salt *salt)
 		}
 	}
 #endif
+#undef CRK_HASH
 
 	return 0;
 }
@@ -958,6 +1142,7 @@ static int crk_salt_loop(void)
 {
 	int done;
 	struct db_salt *salt;
+	double pass_start = 0;
 
 	if (event_reload && crk_reload_pot())
 		return 1;
@@ -980,16 +1165,45 @@ static int crk_salt_loop(void)
 			s = s->next;
 		}
 	}
+
+	if (crk_pass_target && salt == crk_db->salts)
+		pass_start = crk_stage_now();
+
+/* Key setup shared by all salts, done once for this batch of keys */
+	if (crk_methods.precompute_keys) {
+		if (crk_stage_times) {
+			double start = crk_stage_now();
+
+			crk_methods.precompute_keys(crk_key_index);
+			crk_stage_times->crypt_all += crk_stage_now() - start;
+		} else
+			crk_methods.precompute_keys(crk_key_index);
+	}
+
 	do {
+		double guess = 0;
+
+		if (crk_stage_times) {
+			crk_stage_cmp = 0;
+			guess = crk_stage_times->guess;
+		}
 		crk_methods.set_salt(salt->salt);
 		status.resume_salt_md5 = (crk_db->salt_count > 1) ?
 			salt->salt_md5 : NULL;
-		if ((done = crk_password_loop(salt)))
+		done = crk_password_loop(salt);
+		crk_shrink_hash(salt);
+		if (crk_stage_times && crk_stage_cmp)
+			crk_stage_times->compare += crk_stage_now() -
+				crk_stage_cmp - (crk_stage_times->guess - guess);
+		if (done)
 			break;
 	} while ((salt = salt->next));
 	if (!salt || crk_db->salt_count < 2)
 		status.resume_salt_md5 = NULL;
 
+	if (pass_start && !salt)
+		crk_adapt_batch(crk_stage_now() - pass_start, crk_key_index);
+
 	if (done >= 0) {
 #if !HAVE_OPENCL
 		/* Assumes we'll never overrun 32-bit in one crypt */
@@ -1033,15 +1247,51 @@ static int crk_salt_loop(void)
 	return ext_abort;
 }
 
+/*
+ * crk_process_key() with stage timing: the time since we last returned is
+ * spent generating candidates.
+ */
+static int crk_process_key_timed(char *key)
+{
+	double start = crk_stage_now();
+	int ret = 0;
+
+	if (crk_stage_last)
+		crk_stage_times->generate += start - crk_stage_last;
+
+	STATUS_COUNT(keys, 1);
+
+	if (crk_key_index == 0)
+		crk_methods.clear_keys();
+
+	crk_methods.set_key(key, crk_key_index++);
+	crk_stage_last = crk_stage_now();
+	crk_stage_times->set_key += crk_stage_last - start;
+
+	if (crk_key_index >= crk_max_keys ||
+	    (options.force_maxkeys &&
+	     crk_key_index >= options.force_maxkeys)) {
+		ret = crk_salt_loop();
+		crk_stage_last = crk_stage_now();
+	}
+
+	return ret;
+}
+
 int crk_process_key(char *key)
 {
 	if (crk_db->loaded) {
+		if (crk_stage_times)
+			return crk_process_key_timed(key);
+
+		STATUS_COUNT(keys, 1);
+
 		if (crk_key_index == 0)
 			crk_methods.clear_keys();
 
 		crk_methods.set_key(key, crk_key_index++);
 
-		if (crk_key_index >= crk_params.max_keys_per_crypt ||
+		if (crk_key_index >= crk_max_keys ||
 		    (options.force_maxkeys &&
 		     crk_key_index >= options.force_maxkeys))
 			return crk_salt_loop();
@@ -1118,7 +1368,9 @@ int crk_process_salt(struct db_salt *salt)
 		    (options.force_maxkeys && index >= options.force_maxkeys)) {
 			int done;
 			crk_key_index = index;
-			if ((done = crk_password_loop(salt)) >= 0) {
+			done = crk_password_loop(salt);
+			crk_shrink_hash(salt);
+			if (done >= 0) {
 /*
  * The approach we use here results in status.cands growing slower than it
  * ideally should until this loop completes (at which point status.cands has
@@ -1179,5 +1431,7 @@ void crk_done(void)
 		if (crk_key_index && crk_db->salts && !event_abort)
 			crk_salt_loop();
 	}
+	if (options.status_file_interval)
+		status_write_file(crk_db);
 	c_cleanup();
 }
@@ -16,6 +16,17 @@
 /* Our last read position in pot file (during crack) */
 extern int64_t crk_pot_pos;
 
+/*
+ * Time spent in each stage of cracking, in hr_timer ticks (see timer.h).
+ * Only gathered while crk_stage_times points to a struct, which is what
+ * the pipeline benchmark does.
+ */
+struct crk_stage_times {
+	double generate, set_key, crypt_all, compare, guess;
+};
+
+extern struct crk_stage_times *crk_stage_times;
+
 /*
  * Initializes the cracker for a password database (should not be empty).
  * If fix_state() is not NULL, it will be called when key buffer becomes
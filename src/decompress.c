@@ -0,0 +1,1041 @@
+/*
+ * This file is part of John the Ripper password cracker.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted.
+ *
+ * There's ABSOLUTELY NO WARRANTY, express or implied.
+ *
+ * Streaming decompression of gzip and xz wordlists, behind a stdio stream so
+ * that wordlist mode reads, seeks and tells positions in it like in any file.
+ * Nothing is decompressed before it's read.  Files made of independently
+ * compressed blocks with known sizes are decompressed a batch of blocks at a
+ * time, in parallel: BGZF (bgzip) gzip files carry each block's size in its
+ * header, and xz files list all their blocks in their index.  A seek goes
+ * straight to the block holding the target position.  Other gzip files are
+ * decompressed sequentially with zlib, and seeking back in them starts over.
+ * The xz code uses the in-tree LZMA2 decoder, supports LZMA2 as the only
+ * filter, and verifies CRC32, CRC64 and SHA-256 checks.
+ */
+
+#if defined(__linux__) || defined(__CYGWIN__)
+#define _GNU_SOURCE 1 /* fopencookie() */
+#endif
+
+#if AC_BUILT
+#include "autoconfig.h"
+#else
+#define HAVE_LIBZ 1
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#if HAVE_LIBZ
+#include <zlib.h>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "arch.h"
+#include "jumbo.h"
+#include "misc.h"
+#include "common.h"
+#include "memory.h"
+#include "logger.h"
+#include "crc32.h"
+#include "sha2.h"
+#include "decompress.h"
+#include "lzma/Lzma2Dec.h"
+#include "memdbg.h"
+
+#if defined(__GLIBC__) || defined(__CYGWIN__)
+#define DC_COOKIE			1
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__NetBSD__) || \
+	defined(__OpenBSD__) || defined(__DragonFly__)
+#define DC_FUNOPEN			1
+#endif
+
+/*
+ * Blocks larger than this are decompressed a chunk at a time by one thread,
+ * smaller ones together in batches of up to the larger of DC_BATCH_SIZE
+ * bytes and one block per thread.
+ */
+#define DC_BLOCK_MAX			0x4000000
+#define DC_BATCH_SIZE			0x1000000
+#define DC_CHUNK_SIZE			0x100000
+
+#define GET_LE16(p)	((p)[0] | (unsigned int)(p)[1] << 8)
+#define GET_LE32(p)	(GET_LE16(p) | (uint32_t)GET_LE16((p) + 2) << 16)
+
+/*
+ * An independently decompressible block.  in_pos and in_size cover all of
+ * it, from its header up to the next block.
+ */
+struct dc_block {
+	int64_t in_pos, in_size;
+	int64_t out_pos, out_size;
+	int check;		/* xz check type */
+};
+
+/* Integrity check of an xz block */
+struct dc_check {
+	int type;
+	uint32_t crc32;
+	uint64_t crc64;
+	SHA256_CTX sha256;
+};
+
+struct dc_stream {
+	FILE *file;
+	int type;
+	int64_t in_size;
+	int64_t size;		/* decompressed, -1 until known */
+
+	struct dc_block *blocks;
+	int64_t num_blocks, max_blocks;
+	int64_t next_block;	/* the one after those in out */
+
+/* Decompressed data from out_start to out_start + out_len, read up to pos */
+	char *out;
+	size_t out_len, out_alloc, out_pos;
+	int64_t out_start;
+
+/* One block (or a whole plain gzip file) decompressed a chunk at a time */
+	int streaming;
+	struct dc_block *block;
+	unsigned char *in;
+	size_t in_len, in_used;
+	int64_t in_left;
+	int64_t in_done;	/* bytes of the file consumed, for progress */
+#if HAVE_LIBZ
+	z_stream z;
+#endif
+	CLzma2Dec lzma;
+	int lzma_allocated;
+	struct dc_check check;
+
+	FILE *stream;		/* what dc_open() returned */
+	struct dc_stream *next;
+};
+
+static struct dc_stream *dc_streams;
+
+static uint64_t crc64_table[256];
+
+static void dc_error(const char *type, const char *msg)
+{
+	fprintf(stderr, "Error: %s wordlist: %s\n", type, msg);
+	error();
+}
+
+int dc_detect(FILE *file)
+{
+	unsigned char magic[6];
+	size_t len;
+
+	len = fread(magic, 1, sizeof(magic), file);
+	jtr_fseek64(file, 0, SEEK_SET);
+
+	if (len >= 3 && magic[0] == 0x1f && magic[1] == 0x8b && magic[2] == 8) {
+#if HAVE_LIBZ
+		return DC_GZIP;
+#else
+		dc_error("gzip", "not supported (built without zlib)");
+#endif
+	}
+	if (len == 6 && !memcmp(magic, "\xFD" "7zXZ\0", 6))
+		return DC_XZ;
+	if (len >= 4 && !memcmp(magic, "\x28\xB5\x2F\xFD", 4))
+		dc_error("zstd", "zstd not supported, decompress it and use "
+		         "--stdin");
+
+	return DC_NONE;
+}
+
+const char *dc_name(int type)
+{
+	switch (type) {
+	case DC_GZIP:
+		return "gzip";
+	case DC_XZ:
+		return "xz";
+	}
+	return "uncompressed";
+}
+
+static void add_block(struct dc_stream *s, int64_t in_pos, int64_t in_size,
+	int64_t out_size, int check)
+{
+	if (s->num_blocks == s->max_blocks) {
+		s->max_blocks = s->max_blocks ? s->max_blocks * 2 : 1024;
+		s->blocks = mem_realloc(s->blocks,
+		                        s->max_blocks * sizeof(*s->blocks));
+	}
+	s->blocks[s->num_blocks].in_pos = in_pos;
+	s->blocks[s->num_blocks].in_size = in_size;
+	s->blocks[s->num_blocks].out_size = out_size;
+	s->blocks[s->num_blocks].check = check;
+	s->num_blocks++;
+}
+
+static size_t dc_read_at(struct dc_stream *s, int64_t pos, void *buf,
+	size_t size)
+{
+	size_t len;
+
+	if (jtr_fseek64(s->file, pos, SEEK_SET))
+		pexit("fseek");
+	len = fread(buf, 1, size, s->file);
+	if (ferror(s->file))
+		pexit("fread");
+
+	return len;
+}
+
+/* Size of the check field for each xz check type, 0 for unsupported ones */
+static const int xz_check_size[16] = {
+	0, 4, 0, 0, 8, 0, 0, 0, 0, 0, 32, 0, 0, 0, 0, 0
+};
+
+static void check_init(struct dc_check *c, int type)
+{
+	c->type = type;
+	c->crc32 = 0xffffffff;
+	c->crc64 = ~(uint64_t)0;
+	if (type == 10)
+		SHA256_Init(&c->sha256);
+}
+
+static void check_update(struct dc_check *c, const void *data, size_t size)
+{
+	const unsigned char *p = data;
+
+	switch (c->type) {
+	case 1:
+		while (size--)
+			c->crc32 = jtr_crc32(c->crc32, *p++);
+		break;
+	case 4:
+		while (size--)
+			c->crc64 = crc64_table[(c->crc64 ^ *p++) & 0xff] ^
+				(c->crc64 >> 8);
+		break;
+	case 10:
+		SHA256_Update(&c->sha256, data, size);
+	}
+}
+
+static int check_final(struct dc_check *c, const unsigned char *stored)
+{
+	unsigned char digest[32];
+	int i;
+
+	switch (c->type) {
+	case 1:
+		for (i = 0; i < 4; i++)
+			digest[i] = ~c->crc32 >> (8 * i);
+		break;
+	case 4:
+		for (i = 0; i < 8; i++)
+			digest[i] = ~c->crc64 >> (8 * i);
+		break;
+	case 10:
+		SHA256_Final(digest, &c->sha256);
+		break;
+	default:
+		return 1;
+	}
+
+	return !memcmp(digest, stored, xz_check_size[c->type]);
+}
+
+/* The tables must be set up before threads use them */
+static void check_init_tables(void)
+{
+	CRC32_t dummy;
+	int i, j;
+
+	CRC32_Init(&dummy);
+	if (crc64_table[1])
+		return;
+	for (i = 0; i < 256; i++) {
+		uint64_t r = i;
+
+		for (j = 0; j < 8; j++)
+			r = (r >> 1) ^ (0xC96C5795D7870F42ULL & -(r & 1));
+		crc64_table[i] = r;
+	}
+}
+
+#if HAVE_LIBZ
+/*
+ * If p starts a BGZF block (a gzip member with a "BC" extra subfield),
+ * returns its header length and stores the block's total size in *size.
+ */
+static int bgzf_header(const unsigned char *p, int64_t left, int64_t *size)
+{
+	unsigned int xlen, pos;
+
+	if (left < 18 || p[0] != 0x1f || p[1] != 0x8b || p[2] != 8 ||
+	    p[3] != 4)
+		return 0;
+
+	xlen = GET_LE16(p + 10);
+	if (12 + xlen > left)
+		return 0;
+
+	for (pos = 12; pos + 4 <= 12 + xlen;
+	     pos += 4 + GET_LE16(p + pos + 2)) {
+		if (p[pos] == 'B' && p[pos + 1] == 'C' &&
+		    GET_LE16(p + pos + 2) == 2) {
+			*size = GET_LE16(p + pos + 4) + 1;
+			if (*size < 12 + xlen + 8)
+				return 0;
+			return 12 + xlen;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Lists the blocks of a BGZF file by reading each one's header and trailer.
+ * Returns zero if it's not all BGZF.
+ */
+static int bgzf_scan(struct dc_stream *s)
+{
+	unsigned char hdr[0x200];
+	int64_t pos = 0, size;
+
+	while (pos < s->in_size) {
+		size_t len = dc_read_at(s, pos, hdr, sizeof(hdr));
+
+		if (!bgzf_header(hdr, len, &size) || pos + size > s->in_size ||
+		    dc_read_at(s, pos + size - 4, hdr, 4) != 4)
+			return 0;
+		add_block(s, pos, size, GET_LE32(hdr), 0);
+		pos += size;
+	}
+
+	return 1;
+}
+
+static int bgzf_inflate(const unsigned char *in, struct dc_block *b,
+	char *out)
+{
+	int64_t size, hdr = bgzf_header(in, b->in_size, &size);
+	z_stream z;
+	CRC32_t crc;
+	unsigned char stored[4];
+	int ok;
+
+	if (!hdr || size != b->in_size)
+		return 0;
+
+	memset(&z, 0, sizeof(z));
+	if (inflateInit2(&z, -MAX_WBITS) != Z_OK)
+		return 0;
+	z.next_in = (Bytef*)in + hdr;
+	z.avail_in = b->in_size - hdr - 8;
+	z.next_out = (Bytef*)out;
+	z.avail_out = b->out_size;
+	ok = inflate(&z, Z_FINISH) == Z_STREAM_END &&
+		z.total_out == b->out_size;
+	inflateEnd(&z);
+
+	CRC32_Init(&crc);
+	CRC32_Update(&crc, out, b->out_size);
+	CRC32_Final(stored, crc);
+
+	return ok && !memcmp(stored, in + b->in_size - 8, 4);
+}
+#endif /* HAVE_LIBZ */
+
+static int xz_varint(const unsigned char **p, const unsigned char *end,
+	int64_t *value)
+{
+	int i;
+
+	*value = 0;
+	for (i = 0; i < 9 && *p < end; i++) {
+		unsigned char c = *(*p)++;
+
+		*value |= (int64_t)(c & 0x7f) << (i * 7);
+		if (!(c & 0x80))
+			return 1;
+	}
+
+	return 0;
+}
+
+static int cmp_block(const void *a, const void *b)
+{
+	int64_t x = ((const struct dc_block*)a)->in_pos;
+	int64_t y = ((const struct dc_block*)b)->in_pos;
+
+	return (x > y) - (x < y);
+}
+
+/*
+ * Walks the stream footers and indexes from the end of the file, listing
+ * all blocks of all (possibly concatenated) streams.  Only the footers and
+ * indexes are read.
+ */
+static void xz_scan(struct dc_stream *s)
+{
+	int64_t pos = s->in_size;
+	unsigned char *index = NULL;
+
+	while (pos > 0) {
+		unsigned char footer[12], *p, *end;
+		int64_t back, records, r, total = 0, start;
+		int check;
+
+		/* Stream padding */
+		while (pos >= 4 && dc_read_at(s, pos - 4, footer, 4) == 4 &&
+		       !GET_LE32(footer))
+			pos -= 4;
+		if (pos < 24 || dc_read_at(s, pos - 12, footer, 12) != 12)
+			dc_error("xz", "truncated file");
+
+		if (footer[10] != 'Y' || footer[11] != 'Z')
+			dc_error("xz", "bad stream footer");
+		check = footer[9] & 0x0f;
+		if (check && !xz_check_size[check])
+			dc_error("xz", "unsupported integrity check");
+		back = ((int64_t)GET_LE32(footer + 4) + 1) * 4;
+		if (back > pos - 12 - 12)
+			dc_error("xz", "bad index size");
+
+		index = mem_realloc(index, back);
+		if (dc_read_at(s, pos - 12 - back, index, back) != back)
+			dc_error("xz", "truncated file");
+		p = index;
+		end = index + back;
+		if (*p++ != 0 || !xz_varint((const unsigned char **)&p, end,
+		                            &records))
+			dc_error("xz", "bad index");
+		for (r = 0; r < records; r++) {
+			int64_t unpadded, uncompressed;
+
+			if (!xz_varint((const unsigned char **)&p, end,
+			               &unpadded) ||
+			    !xz_varint((const unsigned char **)&p, end,
+			               &uncompressed) ||
+			    unpadded <= xz_check_size[check])
+				dc_error("xz", "bad index record");
+			add_block(s, total, (unpadded + 3) & ~3, uncompressed,
+			          check);
+			total += (unpadded + 3) & ~3;
+		}
+
+		start = pos - 12 - back - total - 12;
+		if (start < 0 || dc_read_at(s, start, footer, 8) != 8 ||
+		    memcmp(footer, "\xFD" "7zXZ\0", 6) ||
+		    footer[6] != 0 || (footer[7] & 0x0f) != check)
+			dc_error("xz", "bad stream header");
+		for (r = s->num_blocks - records; r < s->num_blocks; r++)
+			s->blocks[r].in_pos += start + 12;
+
+		pos = start;
+	}
+
+	MEM_FREE(index);
+	qsort(s->blocks, s->num_blocks, sizeof(*s->blocks), cmp_block);
+}
+
+static void *SzAlloc(void *p, size_t size) { return mem_alloc(size); }
+static void SzFree(void *p, void *address) { MEM_FREE(address); }
+static ISzAlloc st_alloc = {SzAlloc, SzFree};
+
+/*
+ * Parses an xz block header, which must be for LZMA2 as the only filter.
+ * Returns its length and stores the LZMA2 properties byte in *prop, or
+ * returns zero.
+ */
+static int xz_header(const unsigned char *p, int64_t size, Byte *prop)
+{
+	const unsigned char *end;
+	int64_t header = (p[0] + 1) * 4, value;
+	int flags = p[1];
+
+	if (!p[0] || header > size || (flags & 0x3f))
+		return 0;
+	end = p + header;
+
+	p += 2;
+	if ((flags & 0x40) && !xz_varint(&p, end, &value))
+		return 0;
+	if ((flags & 0x80) && !xz_varint(&p, end, &value))
+		return 0;
+	if (!xz_varint(&p, end, &value) || value != 0x21 ||
+	    !xz_varint(&p, end, &value) || value != 1 || p >= end)
+		return 0;
+	*prop = *p;
+
+	return header;
+}
+
+static int xz_decode(const unsigned char *in, struct dc_block *b, char *out)
+{
+	int check_size = xz_check_size[b->check];
+	int64_t header;
+	SizeT in_len, out_len = b->out_size;
+	ELzmaStatus status;
+	struct dc_check check;
+	Byte prop;
+
+	if (!(header = xz_header(in, b->in_size, &prop)) ||
+	    b->in_size < header + check_size)
+		return 0;
+
+	in_len = b->in_size - header - check_size;
+	if (Lzma2Decode((Byte*)out, &out_len, in + header, &in_len, prop,
+	                LZMA_FINISH_END, &status, &st_alloc) != SZ_OK ||
+	    out_len != b->out_size)
+		return 0;
+
+	check_init(&check, b->check);
+	check_update(&check, out, b->out_size);
+	return check_final(&check, in + b->in_size - check_size);
+}
+
+/*
+ * Decompresses blocks from next_block on, as many as make a batch, to out.
+ */
+static void dc_load_batch(struct dc_stream *s)
+{
+	struct dc_block *first = &s->blocks[s->next_block];
+	int64_t count = 0, in_size = 0, out_size = 0, b;
+	unsigned char *in;
+	int threads = 1, bad = 0;
+
+#ifdef _OPENMP
+	threads = omp_get_max_threads();
+#endif
+	while (s->next_block + count < s->num_blocks) {
+		struct dc_block *next = &first[count];
+
+		if (next->out_size > DC_BLOCK_MAX ||
+		    (count >= threads &&
+		     out_size + next->out_size > DC_BATCH_SIZE))
+			break;
+		in_size += next->in_size;
+		out_size += next->out_size;
+		count++;
+	}
+
+	if (out_size > s->out_alloc) {
+		MEM_FREE(s->out);
+		s->out = mem_alloc(s->out_alloc = out_size);
+	}
+	in = mem_alloc(in_size);
+	if (dc_read_at(s, first->in_pos, in, in_size) != in_size)
+		dc_error(dc_name(s->type), "unexpected end of file");
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1) reduction(|:bad)
+#endif
+	for (b = 0; b < count; b++) {
+		struct dc_block *block = &first[b];
+		const unsigned char *p = in + (block->in_pos - first->in_pos);
+		char *q = s->out + (block->out_pos - first->out_pos);
+
+#if HAVE_LIBZ
+		if (s->type == DC_GZIP)
+			bad |= !bgzf_inflate(p, block, q);
+		else
+#endif
+			bad |= !xz_decode(p, block, q);
+	}
+	MEM_FREE(in);
+
+	if (bad)
+		dc_error(dc_name(s->type), "data error, integrity check "
+		         "failed, or unsupported format");
+
+	s->out_start = first->out_pos;
+	s->out_len = out_size;
+	s->out_pos = 0;
+	s->next_block += count;
+	s->in_done = first->in_pos + in_size;
+}
+
+/*
+ * Starts decompressing the block at next_block, or the whole file if there
+ * are no blocks, a chunk at a time.
+ */
+static void dc_start_stream(struct dc_stream *s)
+{
+	int64_t in_pos = 0;
+
+	if (!s->in)
+		s->in = mem_alloc(DC_CHUNK_SIZE);
+	if (s->out_alloc < DC_CHUNK_SIZE) {
+		MEM_FREE(s->out);
+		s->out = mem_alloc(s->out_alloc = DC_CHUNK_SIZE);
+	}
+
+	s->block = s->num_blocks ? &s->blocks[s->next_block] : NULL;
+	s->streaming = 1;
+	s->in_len = s->in_used = 0;
+	s->out_len = s->out_pos = 0;
+
+	if (!s->block) {
+#if HAVE_LIBZ
+		inflateEnd(&s->z);
+		memset(&s->z, 0, sizeof(s->z));
+		if (inflateInit2(&s->z, MAX_WBITS + 32) != Z_OK)
+			dc_error("gzip", "zlib init failed");
+#endif
+		s->out_start = 0;
+		s->in_left = s->in_size;
+	} else {
+		unsigned char header[0x400];
+		size_t len;
+		int hdr;
+		Byte prop;
+
+		in_pos = s->block->in_pos;
+		len = dc_read_at(s, in_pos, header, sizeof(header));
+		if (!(hdr = xz_header(header, len, &prop)) ||
+		    s->block->in_size < hdr + xz_check_size[s->block->check])
+			dc_error("xz", "bad or unsupported block header");
+		if (s->lzma_allocated)
+			Lzma2Dec_Free(&s->lzma, &st_alloc);
+		Lzma2Dec_Construct(&s->lzma);
+		if (Lzma2Dec_Allocate(&s->lzma, prop, &st_alloc) != SZ_OK)
+			dc_error("xz", "unsupported dictionary size");
+		s->lzma_allocated = 1;
+		Lzma2Dec_Init(&s->lzma);
+		check_init(&s->check, s->block->check);
+
+		in_pos += hdr;
+		s->out_start = s->block->out_pos;
+		s->in_left = s->block->in_size - hdr -
+			xz_check_size[s->block->check];
+	}
+
+	if (jtr_fseek64(s->file, in_pos, SEEK_SET))
+		pexit("fseek");
+	s->in_done = in_pos;
+}
+
+/*
+ * Reads more of the file to in if there are fewer than "want" bytes left
+ * in it and there's more to read.
+ */
+static void dc_fill_in(struct dc_stream *s, size_t want)
+{
+	size_t left = s->in_len - s->in_used, len;
+
+	if (left >= want || !s->in_left)
+		return;
+
+	memmove(s->in, s->in + s->in_used, left);
+	len = fread(s->in + left, 1, MIN(s->in_left, DC_CHUNK_SIZE - left),
+	            s->file);
+	if (ferror(s->file))
+		pexit("fread");
+	if (!len)
+		dc_error(dc_name(s->type), "unexpected end of file");
+	s->in_used = 0;
+	s->in_len = left + len;
+	s->in_left -= len;
+	s->in_done += len;
+}
+
+/*
+ * Decompresses the next chunk of a streamed block or file to out.  Returns
+ * zero at its end.
+ */
+static int dc_stream_chunk(struct dc_stream *s)
+{
+	s->out_start += s->out_len;
+	s->out_len = s->out_pos = 0;
+
+	if (!s->streaming)
+		return 0;
+
+#if HAVE_LIBZ
+	if (!s->block) {
+		while (s->out_len < s->out_alloc) {
+			int ret;
+
+			dc_fill_in(s, 1);
+			s->z.next_in = s->in + s->in_used;
+			s->z.avail_in = s->in_len - s->in_used;
+			s->z.next_out = (Bytef*)s->out + s->out_len;
+			s->z.avail_out = s->out_alloc - s->out_len;
+			ret = inflate(&s->z, Z_NO_FLUSH);
+			s->in_used = s->in_len - s->z.avail_in;
+			s->out_len = s->out_alloc - s->z.avail_out;
+			if (ret == Z_STREAM_END) {
+				/* More members follow, or trailing garbage
+				   that gzip would skip */
+				dc_fill_in(s, 2);
+				if (s->in_len - s->in_used < 2 ||
+				    s->in[s->in_used] != 0x1f ||
+				    s->in[s->in_used + 1] != 0x8b) {
+					s->streaming = 0;
+					s->size = s->out_start + s->out_len;
+					break;
+				}
+				inflateReset(&s->z);
+			} else if (ret == Z_BUF_ERROR && !s->z.avail_in &&
+			           !s->in_left) {
+				dc_error("gzip", "unexpected end of file");
+			} else if (ret != Z_OK && ret != Z_BUF_ERROR) {
+				dc_error("gzip", s->z.msg ? s->z.msg :
+				         "data error");
+			}
+		}
+		return s->out_len > 0;
+	}
+#endif
+
+	while (s->out_len < s->out_alloc) {
+		SizeT in_len, out_len = s->out_alloc - s->out_len;
+		ELzmaStatus status;
+
+		dc_fill_in(s, 1);
+		in_len = s->in_len - s->in_used;
+		if (Lzma2Dec_DecodeToBuf(&s->lzma, (Byte*)s->out + s->out_len,
+		    &out_len, s->in + s->in_used, &in_len, LZMA_FINISH_ANY,
+		    &status) != SZ_OK)
+			dc_error("xz", "data error");
+		s->in_used += in_len;
+		s->out_len += out_len;
+
+		if (status == LZMA_STATUS_FINISHED_WITH_MARK) {
+			unsigned char stored[32];
+			int size = xz_check_size[s->block->check];
+
+			check_update(&s->check, s->out, s->out_len);
+			if (s->out_start + s->out_len !=
+			    s->block->out_pos + s->block->out_size ||
+			    dc_read_at(s, s->block->in_pos +
+			               s->block->in_size - size, stored,
+			               size) != size ||
+			    !check_final(&s->check, stored))
+				dc_error("xz", "integrity check failed");
+			s->streaming = 0;
+			s->next_block++;
+			s->in_done = s->block->in_pos + s->block->in_size;
+			return 1;
+		}
+		if (!in_len && !out_len && !s->in_left &&
+		    s->in_used == s->in_len)
+			dc_error("xz", "unexpected end of file");
+	}
+	check_update(&s->check, s->out, s->out_len);
+
+	return 1;
+}
+
+/*
+ * Makes out hold the data following what it holds now.  Returns zero at the
+ * end of the file.
+ */
+static int dc_next(struct dc_stream *s)
+{
+	if (s->streaming)
+		return dc_stream_chunk(s);
+
+	if (s->next_block >= s->num_blocks) {
+		s->out_start += s->out_len;
+		s->out_len = s->out_pos = 0;
+		return 0;
+	}
+
+	if (s->blocks[s->next_block].out_size > DC_BLOCK_MAX) {
+		dc_start_stream(s);
+		return dc_stream_chunk(s);
+	}
+
+	dc_load_batch(s);
+	return 1;
+}
+
+/*
+ * Makes out hold the data at pos, or leaves it empty at the end of the file.
+ */
+static int dc_seek_to(struct dc_stream *s, int64_t pos)
+{
+	if (pos < 0 || (s->size >= 0 && pos > s->size))
+		return -1;
+
+	if (pos >= s->out_start && pos <= s->out_start + s->out_len) {
+		s->out_pos = pos - s->out_start;
+		return 0;
+	}
+
+	if (s->num_blocks) {
+		int64_t lo = 0, hi = s->num_blocks;
+
+		/* Last block starting at or before pos */
+		while (hi - lo > 1) {
+			int64_t mid = (lo + hi) / 2;
+
+			if (s->blocks[mid].out_pos <= pos)
+				lo = mid;
+			else
+				hi = mid;
+		}
+		if (!(s->streaming && s->block == &s->blocks[lo] &&
+		      pos >= s->out_start)) {
+			s->streaming = 0;
+			s->next_block = lo;
+			s->out_len = 0;
+			if (!dc_next(s))
+				return 0;
+		}
+	} else if (pos < s->out_start || !s->streaming) {
+		dc_start_stream(s);
+		if (!dc_stream_chunk(s))
+			return 0;
+	}
+
+	while (pos >= s->out_start + s->out_len)
+		if (!dc_next(s))
+			return pos == s->out_start ? 0 : -1;
+	s->out_pos = pos - s->out_start;
+
+	return 0;
+}
+
+static int64_t dc_read(struct dc_stream *s, char *buf, size_t size)
+{
+	size_t done = 0;
+
+	while (done < size) {
+		size_t len;
+
+		if (s->out_pos == s->out_len && !dc_next(s))
+			break;
+		len = MIN(size - done, s->out_len - s->out_pos);
+		memcpy(buf + done, s->out + s->out_pos, len);
+		s->out_pos += len;
+		done += len;
+	}
+
+	return done;
+}
+
+#if DC_COOKIE || DC_FUNOPEN
+static int64_t dc_seek(struct dc_stream *s, int64_t offset, int whence)
+{
+	int64_t pos;
+
+	switch (whence) {
+	case SEEK_SET:
+		pos = offset;
+		break;
+	case SEEK_CUR:
+		pos = s->out_start + s->out_pos + offset;
+		break;
+	case SEEK_END:
+		if (s->size < 0) {
+			errno = ESPIPE;
+			return -1;
+		}
+		pos = s->size + offset;
+		break;
+	default:
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (dc_seek_to(s, pos)) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	return pos;
+}
+#endif
+
+static int dc_close(struct dc_stream *s)
+{
+	struct dc_stream **p;
+	int ret;
+
+	for (p = &dc_streams; *p; p = &(*p)->next)
+		if (*p == s) {
+			*p = s->next;
+			break;
+		}
+
+	ret = fclose(s->file);
+#if HAVE_LIBZ
+	inflateEnd(&s->z);
+#endif
+	if (s->lzma_allocated)
+		Lzma2Dec_Free(&s->lzma, &st_alloc);
+	MEM_FREE(s->in);
+	MEM_FREE(s->out);
+	MEM_FREE(s->blocks);
+	MEM_FREE(s);
+
+	return ret;
+}
+
+#if DC_COOKIE
+static ssize_t dc_cookie_read(void *cookie, char *buf, size_t size)
+{
+	return dc_read(cookie, buf, size);
+}
+
+static int dc_cookie_seek(void *cookie, off64_t *offset, int whence)
+{
+	int64_t pos = dc_seek(cookie, *offset, whence);
+
+	if (pos < 0)
+		return -1;
+	*offset = pos;
+	return 0;
+}
+
+static int dc_cookie_close(void *cookie)
+{
+	return dc_close(cookie);
+}
+#elif DC_FUNOPEN
+static int dc_funopen_read(void *cookie, char *buf, int size)
+{
+	return dc_read(cookie, buf, size);
+}
+
+static fpos_t dc_funopen_seek(void *cookie, fpos_t offset, int whence)
+{
+	return dc_seek(cookie, offset, whence);
+}
+
+static int dc_funopen_close(void *cookie)
+{
+	return dc_close(cookie);
+}
+#else
+/*
+ * Without a way to wrap our own stdio stream, we decompress it all to a
+ * temporary file up front and hand that out instead.
+ */
+static FILE *dc_to_tmpfile(struct dc_stream *s, int64_t *size)
+{
+	FILE *tmp;
+	char buf[0x10000];
+	int64_t len;
+
+	log_event("- Decompressing %s wordlist to a temporary file",
+	          dc_name(s->type));
+	if (!(tmp = tmpfile()))
+		pexit("tmpfile");
+
+	*size = 0;
+	while ((len = dc_read(s, buf, sizeof(buf))) > 0) {
+		if (fwrite(buf, 1, len, tmp) != len)
+			pexit("fwrite");
+		*size += len;
+	}
+	if (fflush(tmp))
+		pexit("fflush");
+	rewind(tmp);
+	dc_close(s);
+
+	return tmp;
+}
+#endif
+
+FILE *dc_open(FILE *file, int type, int64_t *size)
+{
+	struct dc_stream *s;
+	FILE *stream = NULL;
+	int64_t b;
+
+	s = mem_calloc(1, sizeof(*s));
+	s->file = file;
+	s->type = type;
+	s->size = -1;
+
+	jtr_fseek64(file, 0, SEEK_END);
+	if ((s->in_size = jtr_ftell64(file)) < 0)
+		pexit("ftell");
+
+	check_init_tables();
+#if HAVE_LIBZ
+	if (type == DC_GZIP && !bgzf_scan(s)) {
+		s->num_blocks = 0;
+		log_event("- %s wordlist is not BGZF, so it will be "
+		          "decompressed by one thread and seeking back in it "
+		          "(on restore) starts over", dc_name(type));
+	}
+#endif
+	if (type == DC_XZ)
+		xz_scan(s);
+
+	if (s->num_blocks) {
+		s->size = 0;
+		for (b = 0; b < s->num_blocks; b++) {
+			s->blocks[b].out_pos = s->size;
+			s->size += s->blocks[b].out_size;
+		}
+		log_event("- %s wordlist: "LLd" bytes, "LLd" to decompress "
+		          "in "LLd" blocks", dc_name(type),
+		          (long long)s->in_size, (long long)s->size,
+		          (long long)s->num_blocks);
+	} else
+		dc_start_stream(s);
+
+#if DC_COOKIE
+	{
+		cookie_io_functions_t io = {
+			dc_cookie_read, NULL, dc_cookie_seek, dc_cookie_close
+		};
+
+		stream = fopencookie(s, "rb", io);
+	}
+#elif DC_FUNOPEN
+	stream = funopen(s, dc_funopen_read, NULL, dc_funopen_seek,
+	                 dc_funopen_close);
+#else
+	return dc_to_tmpfile(s, size);
+#endif
+	if (!stream)
+		pexit("fopencookie");
+
+	s->stream = stream;
+	s->next = dc_streams;
+	dc_streams = s;
+
+	*size = s->size;
+	return stream;
+}
+
+void dc_progress(FILE *stream, int64_t *pos, int64_t *size)
+{
+	struct dc_stream *s;
+
+	for (s = dc_streams; s; s = s->next) {
+		if (s->stream != stream)
+			continue;
+		if (s->size < 0) {
+			*pos = s->in_done;
+			*size = s->in_size;
+		} else {
+			*pos = jtr_ftell64(stream);
+			*size = s->size;
+		}
+		return;
+	}
+
+	/* A temporary file from dc_to_tmpfile() */
+	*pos = jtr_ftell64(stream);
+	jtr_fseek64(stream, 0, SEEK_END);
+	*size = jtr_ftell64(stream);
+	jtr_fseek64(stream, *pos, SEEK_SET);
+}
@@ -0,0 +1,56 @@
+/*
+ * This file is part of John the Ripper password cracker.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted.
+ *
+ * There's ABSOLUTELY NO WARRANTY, express or implied.
+ */
+
+/*
+ * Streaming decompression of gzip and xz wordlists.
+ */
+
+#ifndef _JOHN_DECOMPRESS_H
+#define _JOHN_DECOMPRESS_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+/* Compression formats known to dc_detect() */
+#define DC_NONE				0
+#define DC_GZIP				1
+#define DC_XZ				2
+
+/*
+ * Returns the compression format of a file from its magic bytes, or
+ * DC_NONE if it's not compressed.  Formats we recognize but can't
+ * decompress (zstd, or gzip when built without zlib) are a fatal error.
+ * Leaves the file position at the start.
+ */
+extern int dc_detect(FILE *file);
+
+/*
+ * Returns the name of a compression format, for messages.
+ */
+extern const char *dc_name(int type);
+
+/*
+ * Returns a read-only stdio stream of the decompressed contents of file,
+ * which it takes over (fclose() the stream instead).  Data is decompressed
+ * as it's read, and positions for fseek() and ftell() are those in the
+ * decompressed data.  Stores the decompressed size in *size, or -1 if it
+ * isn't known without decompressing it all (gzip other than BGZF); seeking
+ * relative to the end doesn't work then.  Where stdio can't wrap our own
+ * streams (no fopencookie() or funopen()), it decompresses it all to a
+ * temporary file first and returns that, with its size.  Errors are fatal.
+ */
+extern FILE *dc_open(FILE *file, int type, int64_t *size);
+
+/*
+ * Progress through a stream from dc_open(): the position in and size of the
+ * decompressed data, or of the compressed file if the former isn't known.
+ */
+extern void dc_progress(FILE *stream, int64_t *pos, int64_t *size);
+
+#endif
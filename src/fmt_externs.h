@@ -0,0 +1,235 @@
+extern struct fmt_main fmt_agile_keychain;
+extern struct fmt_main fmt_aixssha1;
+extern struct fmt_main fmt_aixssha256;
+extern struct fmt_main fmt_aixssha512;
+extern struct fmt_main fmt_argon2;
+extern struct fmt_main fmt_as400des;
+extern struct fmt_main fmt_AS400_ssha1;
+extern struct fmt_main fmt_asaMD5;
+extern struct fmt_main fmt_axcrypt;
+extern struct fmt_main fmt_AzureAD;
+extern struct fmt_main fmt_bestcrypt;
+extern struct fmt_main fmt_BFEgg;
+extern struct fmt_main fmt_bitcoin;
+extern struct fmt_main fmt_bitlocker;
+extern struct fmt_main fmt_bks;
+extern struct fmt_main fmt_blackberry1;
+extern struct fmt_main fmt_blizzard;
+extern struct fmt_main fmt_blockchain;
+extern struct fmt_main fmt_chap;
+extern struct fmt_main fmt_clipperz;
+extern struct fmt_main fmt_cloud_keychain;
+extern struct fmt_main fmt_CompiledDynamic;
+extern struct fmt_main fmt_cq;
+extern struct fmt_main fmt_crc32;
+extern struct fmt_main fmt_cryptsha1;
+extern struct fmt_main fmt_cryptsha256;
+extern struct fmt_main fmt_cryptsha512;
+extern struct fmt_main fmt_ctrxns;
+extern struct fmt_main fmt_dahua;
+extern struct fmt_main fmt_dashlane;
+extern struct fmt_main fmt_django;
+extern struct fmt_main fmt_django_scrypt;
+extern struct fmt_main fmt_DMD5;
+extern struct fmt_main fmt_dmg;
+extern struct fmt_main fmt_DOMINOSEC8;
+extern struct fmt_main fmt_DOMINOSEC;
+extern struct fmt_main fmt_DPAPImk;
+extern struct fmt_main fmt_dragonfly3_32;
+extern struct fmt_main fmt_dragonfly3_64;
+extern struct fmt_main fmt_dragonfly4_32;
+extern struct fmt_main fmt_dragonfly4_64;
+extern struct fmt_main fmt_drupal7;
+extern struct fmt_main fmt_ecryptfs1;
+extern struct fmt_main fmt_eigrp;
+extern struct fmt_main fmt_electrum;
+extern struct fmt_main fmt_encfs;
+extern struct fmt_main fmt_enpass;
+extern struct fmt_main fmt_EPI;
+extern struct fmt_main fmt_episerver;
+extern struct fmt_main fmt_ethereum;
+extern struct fmt_main fmt_fde;
+extern struct fmt_main fmt_FGT;
+extern struct fmt_main fmt_FORMSPRING;
+extern struct fmt_main fmt_fvde;
+extern struct fmt_main fmt_geli;
+extern struct fmt_main fmt_gost;
+extern struct fmt_main fmt_gpg;
+extern struct fmt_main fmt_haval_128_4;
+extern struct fmt_main fmt_haval_256_3;
+extern struct fmt_main fmt_HDAA;
+extern struct fmt_main fmt_hmacMD5;
+extern struct fmt_main fmt_hmacSHA1;
+extern struct fmt_main fmt_hmacSHA224;
+extern struct fmt_main fmt_hmacSHA256;
+extern struct fmt_main fmt_hmacSHA384;
+extern struct fmt_main fmt_hmacSHA512;
+extern struct fmt_main fmt_hmailserver;
+extern struct fmt_main fmt_hsrp;
+extern struct fmt_main fmt_ike;
+extern struct fmt_main fmt_IPB2;
+extern struct fmt_main fmt_itunes;
+extern struct fmt_main fmt_iwork;
+extern struct fmt_main fmt_KeePass;
+extern struct fmt_main fmt_keychain;
+extern struct fmt_main fmt_keyring;
+extern struct fmt_main fmt_keystore;
+extern struct fmt_main fmt_known_hosts;
+extern struct fmt_main fmt_KRB4;
+extern struct fmt_main fmt_KRB5;
+extern struct fmt_main fmt_krb5asrep;
+extern struct fmt_main fmt_krb5pa;
+extern struct fmt_main fmt_krb5tgs;
+extern struct fmt_main fmt_krb5_18;
+extern struct fmt_main fmt_kwallet;
+extern struct fmt_main fmt_lastpass;
+extern struct fmt_main fmt_lastpass_cli;
+extern struct fmt_main fmt_leet;
+extern struct fmt_main fmt_lotus5;
+extern struct fmt_main fmt_lotus_85;
+extern struct fmt_main fmt_luks;
+extern struct fmt_main fmt_md2_;
+extern struct fmt_main fmt_mdc2;
+extern struct fmt_main fmt_mediawiki;
+extern struct fmt_main fmt_money;
+extern struct fmt_main fmt_mongodb;
+extern struct fmt_main fmt_mongodb_scram;
+extern struct fmt_main fmt_mozilla;
+extern struct fmt_main fmt_mscash2;
+extern struct fmt_main fmt_mscash;
+extern struct fmt_main fmt_MSCHAPv2_new;
+extern struct fmt_main fmt_MSCHAPv2_old;
+extern struct fmt_main fmt_mskrb5;
+extern struct fmt_main fmt_mssql05;
+extern struct fmt_main fmt_mssql12;
+extern struct fmt_main fmt_mssql;
+extern struct fmt_main fmt_multibit;
+extern struct fmt_main fmt_mysqlna;
+extern struct fmt_main fmt_mysqlSHA1;
+extern struct fmt_main fmt_MYSQL_fast;
+extern struct fmt_main fmt_netah;
+extern struct fmt_main fmt_NETHALFLM;
+extern struct fmt_main fmt_NETLM;
+extern struct fmt_main fmt_NETLMv2;
+extern struct fmt_main fmt_netmd5;
+extern struct fmt_main fmt_NETNTLMv2;
+extern struct fmt_main fmt_NETNTLM_new;
+extern struct fmt_main fmt_NETNTLM_old;
+extern struct fmt_main fmt_netsha1;
+extern struct fmt_main fmt_nk;
+extern struct fmt_main fmt_NS;
+extern struct fmt_main fmt_nsec3;
+extern struct fmt_main fmt_NT2;
+extern struct fmt_main fmt_o10glogon;
+extern struct fmt_main fmt_o3logon;
+extern struct fmt_main fmt_o5logon;
+extern struct fmt_main fmt_odf;
+extern struct fmt_main fmt_office;
+extern struct fmt_main fmt_oldoffice;
+extern struct fmt_main fmt_openbsd_softraid;
+extern struct fmt_main fmt_openssl;
+extern struct fmt_main fmt_oracle11;
+extern struct fmt_main fmt_oracle12c;
+extern struct fmt_main fmt_oracle;
+extern struct fmt_main fmt_OSC;
+extern struct fmt_main fmt_ospf;
+extern struct fmt_main fmt_padlock;
+extern struct fmt_main fmt_palshop;
+extern struct fmt_main fmt_panama_;
+extern struct fmt_main fmt_pbkdf2_hmac_md4;
+extern struct fmt_main fmt_pbkdf2_hmac_md5;
+extern struct fmt_main fmt_pbkdf2_hmac_sha1;
+extern struct fmt_main fmt_pbkdf2_hmac_sha256;
+extern struct fmt_main fmt_pbkdf2_hmac_sha512;
+extern struct fmt_main fmt_pdf;
+extern struct fmt_main fmt_pem;
+extern struct fmt_main fmt_pfx;
+extern struct fmt_main fmt_pgpdisk;
+extern struct fmt_main fmt_pgpsda;
+extern struct fmt_main fmt_pgpwde;
+extern struct fmt_main fmt_phpassmd5;
+extern struct fmt_main fmt_PHPS2;
+extern struct fmt_main fmt_PHPS;
+extern struct fmt_main fmt_pixMD5;
+extern struct fmt_main fmt_pkzip;
+extern struct fmt_main fmt_PO;
+extern struct fmt_main fmt_pomelo;
+extern struct fmt_main fmt_postgres;
+extern struct fmt_main fmt_pst;
+extern struct fmt_main fmt_putty;
+extern struct fmt_main fmt_pwsafe;
+extern struct fmt_main fmt_qnx;
+extern struct fmt_main fmt_racf;
+extern struct fmt_main fmt_radmin;
+extern struct fmt_main fmt_rakp;
+extern struct fmt_main fmt_rar5;
+extern struct fmt_main fmt_rar;
+extern struct fmt_main fmt_raw0_SHA512;
+extern struct fmt_main fmt_rawBLAKE2;
+extern struct fmt_main fmt_rawKeccak;
+extern struct fmt_main fmt_rawKeccak_256;
+extern struct fmt_main fmt_rawMD4;
+extern struct fmt_main fmt_rawMD5;
+extern struct fmt_main fmt_rawmd5uthick;
+extern struct fmt_main fmt_rawSHA1;
+extern struct fmt_main fmt_rawSHA1_axcrypt;
+extern struct fmt_main fmt_rawSHA1_LI;
+extern struct fmt_main fmt_rawSHA224;
+extern struct fmt_main fmt_rawSHA256;
+extern struct fmt_main fmt_rawSHA256_ng;
+extern struct fmt_main fmt_rawSHA384;
+extern struct fmt_main fmt_rawSHA3;
+extern struct fmt_main fmt_rawSHA512_ng;
+extern struct fmt_main fmt_ripemd_128;
+extern struct fmt_main fmt_ripemd_160;
+extern struct fmt_main fmt_rsvp;
+extern struct fmt_main fmt_s7;
+extern struct fmt_main fmt_saltedsha2;
+extern struct fmt_main fmt_saltedsha;
+extern struct fmt_main fmt_sapB;
+extern struct fmt_main fmt_sapG;
+extern struct fmt_main fmt_sapH;
+extern struct fmt_main fmt_sevenzip;
+extern struct fmt_main fmt_sha1_ng;
+extern struct fmt_main fmt_sip;
+extern struct fmt_main fmt_skein_256;
+extern struct fmt_main fmt_skein_512;
+extern struct fmt_main fmt_SKEY;
+extern struct fmt_main fmt_sl3;
+extern struct fmt_main fmt_smd5;
+extern struct fmt_main fmt_snefru_128;
+extern struct fmt_main fmt_snefru_256;
+extern struct fmt_main fmt_sniffed_lastpass;
+extern struct fmt_main fmt_snmp;
+extern struct fmt_main fmt_sshng;
+extern struct fmt_main fmt_stribog_256;
+extern struct fmt_main fmt_stribog_512;
+extern struct fmt_main fmt_strip;
+extern struct fmt_main fmt_sunmd5;
+extern struct fmt_main fmt_sxc;
+extern struct fmt_main fmt_SybaseASE;
+extern struct fmt_main fmt_sybaseprop;
+extern struct fmt_main fmt_tcpmd5;
+extern struct fmt_main fmt_tiger;
+extern struct fmt_main fmt_truecrypt;
+extern struct fmt_main fmt_truecrypt_ripemd160;
+extern struct fmt_main fmt_truecrypt_ripemd160boot;
+extern struct fmt_main fmt_truecrypt_sha512;
+extern struct fmt_main fmt_truecrypt_whirlpool;
+extern struct fmt_main fmt_vdi;
+extern struct fmt_main fmt_VMS;
+extern struct fmt_main fmt_vnc;
+extern struct fmt_main fmt_vtp;
+extern struct fmt_main fmt_wbb3;
+extern struct fmt_main fmt_whirlpool;
+extern struct fmt_main fmt_whirlpool_0;
+extern struct fmt_main fmt_whirlpool_1;
+extern struct fmt_main fmt_wpapsk;
+extern struct fmt_main fmt_wpapsk_pmk;
+extern struct fmt_main fmt_xmpp_scram;
+extern struct fmt_main fmt_XSHA512;
+extern struct fmt_main fmt_XSHA;
+extern struct fmt_main fmt_zip;
+extern struct fmt_main fmt_zipmonster;
+extern struct fmt_main fmt_zzz_plaintext;
+extern struct fmt_main fmt__HAS160;
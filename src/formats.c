@@ -205,6 +205,8 @@ static char* is_key_right(struct fmt_main *format, int index,
 		return "index should be 0 when test_fmt_case";
 
 	count = index + 1;
+	if (format->methods.precompute_keys)
+		format->methods.precompute_keys(count);
 	match = format->methods.crypt_all(&count, dbsalt);
 
 	if ((match && !format->methods.cmp_all(binary, match)) ||
@@ -265,6 +267,27 @@ static char* is_key_right(struct fmt_main *format, int index,
 		return err_buf;
 	}
 
+	if (format->methods.get_hash_batch &&
+	    match <= format->params.max_keys_per_crypt)
+	for (size = 0; size < PASSWORD_HASH_SIZES; size++)
+	if (format->methods.binary_hash[size] &&
+	    format->methods.get_hash[size] &&
+	    format->methods.get_hash[size] != fmt_default_get_hash) {
+		unsigned int *hashes = mem_alloc(
+		    format->params.max_keys_per_crypt * sizeof(*hashes));
+		int j;
+
+		format->methods.get_hash_batch(size, match, hashes);
+		for (j = 0; j < match; j++)
+		if (hashes[j] != (unsigned int)format->methods.get_hash[size](j))
+			break;
+		MEM_FREE(hashes);
+		if (j < match) {
+			sprintf(err_buf, "get_hash_batch[%d](%d)", size, j);
+			return err_buf;
+		}
+	}
+
 	if (!format->methods.cmp_exact(ciphertext, i)) {
 		if (options.verbosity > VERB_LEGACY)
 			snprintf(err_buf, sizeof(err_buf), "cmp_exact(%d) %s", match, ciphertext);
@@ -332,6 +332,26 @@ struct fmt_methods {
 
 /* Compares an ASCII ciphertext against a particular crypt_all() output */
 	int (*cmp_exact)(char *source, int index);
+
+/* Optional (NULL if not implemented).  Does the part of the work that only
+ * depends on the keys (e.g. an NT hash, or HMAC key pad states) for the count
+ * keys set since the last clear_keys().  The results go to the format's own
+ * buffers, sized for max_keys_per_crypt in init(), and are then reused by
+ * crypt_all() for every salt.  The cracker calls this once per batch of keys
+ * before going through the salts.  Other callers (self-test, benchmark,
+ * single crack mode) don't have to, so crypt_all() must notice when keys were
+ * set after the last call and call this itself.
+ * Kept near the end so that formats not implementing it can just leave it
+ * out. */
+	void (*precompute_keys)(int count);
+
+/* Optional (NULL if not implemented).  Stores get_hash[size](index) for every
+ * index from 0 to count - 1 to out[], in one go, e.g. straight from the
+ * format's SIMD output buffers.  When present, the cracker uses this instead
+ * of calling get_hash[]() for each crypt_all() output.  out[] always has room
+ * for max_keys_per_crypt entries, so whole SIMD vectors may be stored even
+ * past count. */
+	void (*get_hash_batch)(int size, int count, unsigned int *out);
 };
 
 /*
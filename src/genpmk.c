@@ -0,0 +1,234 @@
+/*
+ * This file is part of John the Ripper password cracker.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted.
+ *
+ * There's ABSOLUTELY NO WARRANTY, express or implied.
+ *
+ * genpmk computes WPA-PSK pairwise master keys for a list of ESSIDs and a
+ * wordlist ahead of time.  They are added to the PMK cache that the wpapsk
+ * format uses when "WPAPMKCache" is enabled in john.conf, and can also be
+ * printed in hex, which makes them candidates for the wpapsk-pmk format.
+ */
+
+#if AC_BUILT
+#include "autoconfig.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "arch.h"
+#include "jumbo.h"
+#include "params.h"
+#include "memory.h"
+#include "misc.h"
+#include "path.h"
+#include "sha.h"
+#include "simd-intrinsics.h"
+#include "pbkdf2_hmac_sha1.h"
+#include "pmk_cache.h"
+#include "memdbg.h"
+
+#ifdef SIMD_COEF_32
+#define GROUP			SSE_GROUP_SZ_SHA1
+#else
+#define GROUP			1
+#endif
+
+/* WPA passphrases are 8 to 63 characters */
+#define MIN_KEY_LEN		8
+#define MAX_KEY_LEN		63
+
+/* Groups per thread that we fill before computing them */
+#define GROUPS_PER_THREAD	4
+
+static const char hex[] = "0123456789abcdef";
+static int print_hex;
+static unsigned long long computed, cached;
+
+struct group {
+	int count;
+	char key[GROUP][MAX_KEY_LEN + 1];
+	int length[GROUP];
+	unsigned char pmk[GROUP][PMK_CACHE_PMK_LEN];
+};
+
+static struct group *groups;
+static int used, max_groups;
+
+static void print_pmk(unsigned char *pmk)
+{
+	int i;
+
+	if (!print_hex)
+		return;
+
+	for (i = 0; i < PMK_CACHE_PMK_LEN; i++) {
+		putchar(hex[pmk[i] >> 4]);
+		putchar(hex[pmk[i] & 0xf]);
+	}
+	putchar('\n');
+}
+
+static void compute_group(char *essid, struct group *group)
+{
+#ifdef SIMD_COEF_32
+	const unsigned char *keys[GROUP];
+	unsigned char *out[GROUP];
+	int i;
+
+	for (i = 0; i < GROUP; i++) {
+		if (i >= group->count)
+			group->length[i] = 0;
+		keys[i] = (unsigned char*)group->key[i];
+		out[i] = group->pmk[i];
+	}
+	pbkdf2_sha1_sse(keys, group->length, (unsigned char*)essid,
+	                strlen(essid), 4096, out, PMK_CACHE_PMK_LEN, 0);
+#else
+	pbkdf2_sha1((unsigned char*)group->key[0], group->length[0],
+	            (unsigned char*)essid, strlen(essid), 4096,
+	            group->pmk[0], PMK_CACHE_PMK_LEN, 0);
+#endif
+}
+
+/*
+ * Computes the filled groups, one per thread at a time, then adds them to
+ * the cache and prints them in wordlist order.
+ */
+static void compute(char *essid)
+{
+	int g, i;
+
+	if (used < max_groups && groups[used].count)
+		used++;
+	if (!used)
+		return;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+	for (g = 0; g < used; g++)
+		compute_group(essid, &groups[g]);
+
+	for (g = 0; g < used; g++) {
+		struct group *group = &groups[g];
+
+		for (i = 0; i < group->count; i++) {
+			pmk_cache_add(essid, (unsigned char*)group->key[i],
+			              group->length[i], group->pmk[i]);
+			print_pmk(group->pmk[i]);
+		}
+		computed += group->count;
+		group->count = 0;
+	}
+	used = 0;
+}
+
+static void process_essid(char *essid, FILE *wordlist)
+{
+	char line[LINE_BUFFER_SIZE];
+	unsigned char pmk[PMK_CACHE_PMK_LEN];
+
+	rewind(wordlist);
+	while (fgets(line, sizeof(line), wordlist)) {
+		struct group *group = &groups[used];
+		int length = strcspn(line, "\r\n");
+
+		line[length] = 0;
+		if (length < MIN_KEY_LEN || length > MAX_KEY_LEN)
+			continue;
+
+		if (pmk_cache_lookup(essid, (unsigned char*)line, length, pmk)) {
+			if (print_hex)
+				compute(essid);
+			print_pmk(pmk);
+			cached++;
+			continue;
+		}
+
+		strcpy(group->key[group->count], line);
+		group->length[group->count] = length;
+		if (++group->count == GROUP && ++used == max_groups)
+			compute(essid);
+	}
+	compute(essid);
+
+	pmk_cache_flush();
+}
+
+#ifdef HAVE_LIBFUZZER
+int main_dummy(int argc, char **argv)
+#else
+int main(int argc, char **argv)
+#endif
+{
+	FILE *essids, *wordlist;
+	char essid[LINE_BUFFER_SIZE];
+	char *cache_name;
+
+	path_init(argv);
+
+	if (argc > 1 && !strcmp(argv[1], "-x")) {
+		print_hex = 1;
+		argc--;
+		argv++;
+	}
+
+	if (argc < 3 || argc > 4) {
+		fprintf(stderr, "Usage: genpmk [-x] ESSID-FILE WORDLIST "
+		        "[PMK-CACHE]\n\n"
+		        "Adds the PMK of every ESSID and word to PMK-CACHE "
+		        "(default %s).\n"
+		        "-x also prints the PMKs in hex, for use as candidates "
+		        "with --format=wpapsk-pmk.\n", PMK_CACHE_NAME);
+		return 1;
+	}
+
+	cache_name = argc > 3 ? argv[3] : path_expand(PMK_CACHE_NAME);
+
+	if (!(essids = fopen(argv[1], "r")))
+		pexit("fopen: %s", argv[1]);
+	if (!(wordlist = fopen(argv[2], "r")))
+		pexit("fopen: %s", argv[2]);
+
+	if (pmk_cache_open(cache_name))
+		return 1;
+
+	max_groups = GROUPS_PER_THREAD;
+#ifdef _OPENMP
+	max_groups *= omp_get_max_threads();
+#endif
+	groups = mem_calloc(max_groups, sizeof(*groups));
+
+	while (fgets(essid, sizeof(essid), essids)) {
+		int length = strcspn(essid, "\r\n");
+
+		essid[length] = 0;
+		if (!length || length > PMK_CACHE_ESSID_LEN) {
+			if (length)
+				fprintf(stderr, "Skipping ESSID longer than %d "
+				        "characters: %s\n",
+				        PMK_CACHE_ESSID_LEN, essid);
+			continue;
+		}
+		process_essid(essid, wordlist);
+	}
+
+	pmk_cache_close();
+	MEM_FREE(groups);
+	fclose(wordlist);
+	fclose(essids);
+
+	fprintf(stderr, "%llu PMKs computed, %llu already in cache\n",
+	        computed, cached);
+
+	return 0;
+}
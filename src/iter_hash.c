@@ -0,0 +1,216 @@
+/*
+ * This file is part of John the Ripper password cracker.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted.
+ *
+ * There's ABSOLUTELY NO WARRANTY, express or implied.
+ */
+
+#include <string.h>
+
+#include "iter_hash.h"
+
+#if defined(SIMD_COEF_32) && defined(SIMD_PARA_SHA1) && \
+	defined(SIMD_PARA_SHA256)
+
+#include "memory.h"
+#include "simd-intrinsics.h"
+#include "memdbg.h"
+
+#define BLOCK_BYTES			64
+
+/* Where lane j's block starts, in the SIMD_COEF_32 interleaved layout */
+#define LANE(j) \
+	(((j) & (SIMD_COEF_32 - 1)) * 4 + \
+	(j) / SIMD_COEF_32 * BLOCK_BYTES * SIMD_COEF_32)
+
+/* Byte i of lane j's block */
+#define GETPOS(i, j) \
+	(LANE(j) + ((i) & ~3U) * SIMD_COEF_32 + (3 - ((i) & 3)))
+
+/* Word i of lane j's block */
+#define GETWORD(i, j) \
+	(((j) & (SIMD_COEF_32 - 1)) + (i) * SIMD_COEF_32 + \
+	(j) / SIMD_COEF_32 * (BLOCK_BYTES / 4) * SIMD_COEF_32)
+
+struct iter_hash_patch {
+	unsigned short offset;	/* in the block, for lane 0 */
+	unsigned char shift;	/* of the counter byte */
+	unsigned char round;	/* from the start of the period */
+};
+
+static unsigned int gcd(unsigned int a, unsigned int b)
+{
+	while (b) {
+		unsigned int t = a % b;
+
+		a = b;
+		b = t;
+	}
+
+	return a;
+}
+
+static void iter_hash_body(struct iter_hash *ih, unsigned char *in,
+	uint32_t *out, uint32_t *reload)
+{
+	unsigned int flags = SSEi_MIXED_IN | (reload ? SSEi_RELOAD : 0);
+
+	if (ih->type == ITER_HASH_SHA1)
+		SIMDSHA1body(in, out, reload, flags);
+	else
+		SIMDSHA256body(in, out, reload, flags);
+}
+
+/*
+ * Writes the counter bytes of the block's rounds into the template for
+ * block number "block", of all lanes.
+ */
+static void iter_hash_patch(struct iter_hash *ih, unsigned char *dst,
+	uint64_t block)
+{
+	unsigned int t = block % ih->period;
+	uint64_t base = block / ih->period * ih->period_rounds;
+	struct iter_hash_patch *p = &ih->patch[ih->first_patch[t]];
+	struct iter_hash_patch *end = &ih->patch[ih->first_patch[t + 1]];
+
+	for (; p < end; p++) {
+		unsigned char value = (base + p->round) >> p->shift;
+		unsigned char *q = dst + p->offset;
+		unsigned int j;
+
+		for (j = 0; j < ih->lanes; j++)
+			q[LANE(j)] = value;
+	}
+}
+
+void iter_hash_init(struct iter_hash *ih, int type,
+	unsigned char *const *prefix, unsigned int prefix_length,
+	unsigned int counter_length)
+{
+	unsigned int block_size, patches, t, i, j;
+
+	memset(ih, 0, sizeof(*ih));
+	ih->type = type;
+	if (type == ITER_HASH_SHA1) {
+		ih->lanes = ITER_HASH_SHA1_LANES;
+		ih->words = 5;
+	} else {
+		ih->lanes = ITER_HASH_SHA256_LANES;
+		ih->words = 8;
+	}
+	ih->length = prefix_length + counter_length;
+	ih->counter_length = counter_length;
+	ih->period = ih->length / gcd(ih->length, BLOCK_BYTES);
+	ih->period_rounds = BLOCK_BYTES * ih->period / ih->length;
+
+	block_size = BLOCK_BYTES * ih->lanes;
+	ih->block = mem_alloc_align(block_size * ih->period, MEM_ALIGN_SIMD);
+	ih->tail = mem_alloc_align(block_size, MEM_ALIGN_SIMD);
+	ih->state = mem_alloc_align(ih->words * 4 * ih->lanes, MEM_ALIGN_SIMD);
+	ih->out = mem_alloc_align(ih->words * 4 * ih->lanes, MEM_ALIGN_SIMD);
+
+/*
+ * A period has period_rounds counters, and each of their bytes lands in
+ * exactly one block.
+ */
+	patches = ih->period_rounds * counter_length;
+	ih->patch = mem_alloc(patches * sizeof(*ih->patch));
+	ih->first_patch = mem_alloc((ih->period + 1) *
+	                            sizeof(*ih->first_patch));
+
+	patches = 0;
+	for (t = 0; t < ih->period; t++) {
+		unsigned char *dst = ih->block + t * block_size;
+
+		ih->first_patch[t] = patches;
+		for (i = 0; i < BLOCK_BYTES; i++) {
+			unsigned int s = t * BLOCK_BYTES + i;
+			unsigned int offset = s % ih->length;
+
+			if (offset < prefix_length) {
+				for (j = 0; j < ih->lanes; j++)
+					dst[GETPOS(i, j)] = prefix[j][offset];
+			} else {
+				struct iter_hash_patch *p =
+					&ih->patch[patches++];
+
+				p->offset = GETPOS(i, 0);
+				p->shift = 8 * (offset - prefix_length);
+				p->round = s / ih->length;
+			}
+		}
+	}
+	ih->first_patch[t] = patches;
+}
+
+void iter_hash_add(struct iter_hash *ih, uint64_t rounds)
+{
+	unsigned int block_size = BLOCK_BYTES * ih->lanes;
+	uint64_t end;
+
+	ih->rounds += rounds;
+	end = ih->rounds * ih->length / BLOCK_BYTES;
+
+	while (ih->blocks < end) {
+		unsigned char *dst =
+			ih->block + ih->blocks % ih->period * block_size;
+
+		iter_hash_patch(ih, dst, ih->blocks);
+		iter_hash_body(ih, dst, ih->state,
+		               ih->blocks ? ih->state : NULL);
+		ih->blocks++;
+	}
+}
+
+uint32_t *iter_hash_final(struct iter_hash *ih)
+{
+	unsigned int block_size = BLOCK_BYTES * ih->lanes;
+	uint64_t bits = ih->rounds * ih->length * 8;
+	unsigned int used = ih->rounds * ih->length - ih->blocks * BLOCK_BYTES;
+	unsigned int i, j;
+
+	memcpy(ih->tail, ih->block + ih->blocks % ih->period * block_size,
+	       block_size);
+	iter_hash_patch(ih, ih->tail, ih->blocks);
+
+	for (j = 0; j < ih->lanes; j++) {
+		ih->tail[GETPOS(used, j)] = 0x80;
+		for (i = used + 1; i < BLOCK_BYTES; i++)
+			ih->tail[GETPOS(i, j)] = 0;
+	}
+
+	if (used >= BLOCK_BYTES - 8) {
+		iter_hash_body(ih, ih->tail, ih->out,
+		               ih->blocks ? ih->state : NULL);
+		memset(ih->tail, 0, block_size);
+	}
+
+	for (j = 0; j < ih->lanes; j++) {
+		uint32_t *w = (uint32_t *)ih->tail;
+
+		w[GETWORD(14, j)] = bits >> 32;
+		w[GETWORD(15, j)] = bits;
+	}
+
+	if (used >= BLOCK_BYTES - 8)
+		iter_hash_body(ih, ih->tail, ih->out, ih->out);
+	else
+		iter_hash_body(ih, ih->tail, ih->out,
+		               ih->blocks ? ih->state : NULL);
+
+	return ih->out;
+}
+
+void iter_hash_free(struct iter_hash *ih)
+{
+	MEM_FREE(ih->block);
+	MEM_FREE(ih->tail);
+	MEM_FREE(ih->state);
+	MEM_FREE(ih->out);
+	MEM_FREE(ih->patch);
+	MEM_FREE(ih->first_patch);
+}
+
+#endif /* SIMD_COEF_32 */
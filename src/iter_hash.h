@@ -0,0 +1,78 @@
+/*
+ * This file is part of John the Ripper password cracker.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted.
+ *
+ * There's ABSOLUTELY NO WARRANTY, express or implied.
+ */
+
+/*
+ * SIMD SHA-1 and SHA-256 of a stream that repeats the same prefix (password,
+ * salt) followed by a little-endian round counter, as used by the RAR3 and
+ * 7-Zip KDFs.  The stream has the same layout every lcm(length, 64) bytes, so
+ * those blocks are laid out in the SIMD lanes once and only the counter bytes
+ * are patched in before each block is hashed.  All lanes of a batch must
+ * have the same prefix length.
+ */
+
+#ifndef _JOHN_ITER_HASH_H
+#define _JOHN_ITER_HASH_H
+
+#include "arch.h"
+
+#if defined(SIMD_COEF_32) && defined(SIMD_PARA_SHA1) && \
+	defined(SIMD_PARA_SHA256)
+
+#include <stdint.h>
+
+#define ITER_HASH_SHA1			1
+#define ITER_HASH_SHA256		2
+
+#define ITER_HASH_SHA1_LANES		(SIMD_COEF_32 * SIMD_PARA_SHA1)
+#define ITER_HASH_SHA256_LANES		(SIMD_COEF_32 * SIMD_PARA_SHA256)
+
+struct iter_hash_patch;
+
+struct iter_hash {
+	int type;
+	unsigned int lanes, words;
+	unsigned int length;		/* bytes per round */
+	unsigned int counter_length;
+	unsigned int period;		/* blocks before the layout repeats */
+	unsigned int period_rounds;	/* rounds in those blocks */
+	uint64_t rounds;		/* rounds added so far */
+	uint64_t blocks;		/* blocks hashed so far */
+	unsigned char *block;		/* period blocks of all lanes */
+	unsigned char *tail;		/* scratch for iter_hash_final() */
+	uint32_t *state, *out;
+	struct iter_hash_patch *patch;
+	unsigned int *first_patch;	/* per block, then one past the end */
+};
+
+/*
+ * Sets up the stream of prefix[lane] (prefix_length bytes each) followed by
+ * a counter_length byte counter, for all lanes of the hash type.
+ */
+extern void iter_hash_init(struct iter_hash *ih, int type,
+	unsigned char *const *prefix, unsigned int prefix_length,
+	unsigned int counter_length);
+
+/*
+ * Adds the next "rounds" rounds to the stream, hashing the blocks that are
+ * complete.
+ */
+extern void iter_hash_add(struct iter_hash *ih, uint64_t rounds);
+
+/*
+ * Returns the digest of the stream so far, in the usual interleaved SIMD
+ * output layout (raw state words, not byte swapped).  The stream can be
+ * added to afterwards; the buffer is reused by the next call.
+ */
+extern uint32_t *iter_hash_final(struct iter_hash *ih);
+
+extern void iter_hash_free(struct iter_hash *ih);
+
+#endif /* SIMD_COEF_32 */
+
+#endif
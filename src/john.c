@@ -92,6 +92,7 @@ static int john_omp_threads_new;
 #include "options.h"
 #include "config.h"
 #include "bench.h"
+#include "omp_autotune.h"
 #ifdef HAVE_FUZZ
 #include "fuzz.h"
 #endif
@@ -1205,7 +1206,10 @@ static void john_load(void)
 			if (!(options.acc_devices->count && options.fork &&
 			      strstr(database.format->params.label, "-opencl")))
 #endif
-			fmt_init(database.format);
+			{
+				fmt_init(database.format);
+				omp_autotune(database.format);
+			}
 			if (john_main_process)
 			printf("Loaded %s (%s%s%s [%s])\n",
 			    john_loaded_counts(),
@@ -1600,8 +1604,12 @@ static void john_run(void)
 	struct stat trigger_stat;
 	int trigger_reset = 0;
 
-	if (options.flags & FLG_TEST_CHK)
-		exit_status = benchmark_all() ? 1 : 0;
+	if (options.flags & FLG_TEST_CHK) {
+		if (benchmark_pipeline >= 0)
+			exit_status = benchmark_pipeline_all() ? 1 : 0;
+		else
+			exit_status = benchmark_all() ? 1 : 0;
+	}
 #ifdef HAVE_FUZZ
 	else
 	if (options.flags & FLG_FUZZ_CHK || options.flags & FLG_FUZZ_DUMP_CHK) {
@@ -1839,6 +1847,7 @@ static void john_done(void)
 #if defined(HAVE_OPENCL)
 	gpu_log_temp();
 #endif
+	status_log_counters();
 	log_done();
 #if HAVE_OPENCL
 	if (!(options.flags & FLG_FORK) || john_main_process)
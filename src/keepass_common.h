@@ -24,8 +24,8 @@
 // salt align of 4 was crashing on sparc due to the long long value.
 #define SALT_ALIGN		sizeof(long long)
 #endif
-#define MIN_KEYS_PER_CRYPT	1
-#define MAX_KEYS_PER_CRYPT	1
+#define MIN_KEYS_PER_CRYPT	4 /* whole groups, see keepass_fmt_plug.c */
+#define MAX_KEYS_PER_CRYPT	4 /* AES_ITER_STREAMS / 2 */
 
 extern struct fmt_tests keepass_tests[];
 
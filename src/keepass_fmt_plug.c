@@ -52,71 +52,67 @@ john_register_one(&fmt_KeePass);
 #define FORMAT_NAME		""
 #define ALGORITHM_NAME		"SHA256 AES 32/" ARCH_BITS_STR " " SHA2_LIB
 
+/* Candidates whose key transformations run together, two AES blocks each */
+#define KEYS_PER_GROUP		(AES_ITER_STREAMS / 2)
+#if KEYS_PER_GROUP != MAX_KEYS_PER_CRYPT || KEYS_PER_GROUP != MIN_KEYS_PER_CRYPT
+#error KEYS_PER_GROUP and MIN/MAX_KEYS_PER_CRYPT are out of sync
+#endif
+
 static keepass_salt_t *cur_salt;
 static int any_cracked, *cracked;
 static size_t cracked_size;
 
-// GenerateKey32 from CompositeKey.cs
-static void transform_key(char *masterkey, keepass_salt_t *csp,
-                          unsigned char *final_key)
+// GenerateKey32 from CompositeKey.cs, for count candidates at once
+static void transform_keys(int index, int count, keepass_salt_t *csp,
+                           unsigned char (*final_key)[32])
 {
 	SHA256_CTX ctx;
-	unsigned char hash[32];
+	unsigned char hash[KEYS_PER_GROUP][32];
 	int i;
-	AES_KEY akey;
 
-	// First, hash the masterkey
-	SHA256_Init(&ctx);
-	SHA256_Update(&ctx, masterkey, strlen(masterkey));
-	SHA256_Final(hash, &ctx);
+	for (i = 0; i < count; i++) {
+		char *masterkey = keepass_key[index + i];
 
-	if (csp->version == 2 && cur_salt->have_keyfile == 0) {
+		// First, hash the masterkey
 		SHA256_Init(&ctx);
-		SHA256_Update(&ctx, hash, 32);
-		SHA256_Final(hash, &ctx);
-	}
+		SHA256_Update(&ctx, masterkey, strlen(masterkey));
+		SHA256_Final(hash[i], &ctx);
 
-	if (cur_salt->have_keyfile) {
-		SHA256_Init(&ctx);
-		SHA256_Update(&ctx, hash, 32);
-		SHA256_Update(&ctx, cur_salt->keyfile, 32);
-		SHA256_Final(hash, &ctx);
-	}
+		if (csp->version == 2 && cur_salt->have_keyfile == 0) {
+			SHA256_Init(&ctx);
+			SHA256_Update(&ctx, hash[i], 32);
+			SHA256_Final(hash[i], &ctx);
+		}
 
-	// Next, encrypt the created hash
-	AES_set_encrypt_key(csp->transf_randomseed, 256, &akey);
-	i = csp->key_transf_rounds >> 2;
-	while (i--) {
-		AES_encrypt(hash, hash, &akey);
-		AES_encrypt(hash, hash, &akey);
-		AES_encrypt(hash, hash, &akey);
-		AES_encrypt(hash, hash, &akey);
-		AES_encrypt(hash+16, hash+16, &akey);
-		AES_encrypt(hash+16, hash+16, &akey);
-		AES_encrypt(hash+16, hash+16, &akey);
-		AES_encrypt(hash+16, hash+16, &akey);
-	}
-	i = csp->key_transf_rounds & 3;
-	while (i--) {
-		AES_encrypt(hash, hash, &akey);
-		AES_encrypt(hash+16, hash+16, &akey);
+		if (cur_salt->have_keyfile) {
+			SHA256_Init(&ctx);
+			SHA256_Update(&ctx, hash[i], 32);
+			SHA256_Update(&ctx, cur_salt->keyfile, 32);
+			SHA256_Final(hash[i], &ctx);
+		}
 	}
 
-	// Finally, hash it again...
-	SHA256_Init(&ctx);
-	SHA256_Update(&ctx, hash, 32);
-	SHA256_Final(hash, &ctx);
+	// Next, encrypt the created hashes, both halves of all of them together
+	AES_ecb_iterate(csp->transf_randomseed, 256, hash[0], 2 * count,
+	                csp->key_transf_rounds);
 
-	// ...and hash the result together with the random seed
-	SHA256_Init(&ctx);
-	if (csp->version == 1) {
-		SHA256_Update(&ctx, csp->final_randomseed, 16);
-	}
-	else {
-		SHA256_Update(&ctx, csp->final_randomseed, 32);
+	for (i = 0; i < count; i++) {
+		// Finally, hash it again...
+		SHA256_Init(&ctx);
+		SHA256_Update(&ctx, hash[i], 32);
+		SHA256_Final(hash[i], &ctx);
+
+		// ...and hash the result together with the random seed
+		SHA256_Init(&ctx);
+		if (csp->version == 1) {
+			SHA256_Update(&ctx, csp->final_randomseed, 16);
+		}
+		else {
+			SHA256_Update(&ctx, csp->final_randomseed, 32);
+		}
+		SHA256_Update(&ctx, hash[i], 32);
+		SHA256_Final(final_key[i], &ctx);
 	}
-	SHA256_Update(&ctx, hash, 32);
-	SHA256_Final(final_key, &ctx);
 }
 
 static void init(struct fmt_main *self)
@@ -148,118 +144,126 @@ static void set_salt(void *salt)
 	cur_salt = (keepass_salt_t*)salt;
 }
 
-static int crypt_all(int *pcount, struct db_salt *salt)
+static void check_key(int index, unsigned char *final_key)
 {
-	const int count = *pcount;
-	int index = 0;
+	unsigned char *decrypted_content;
+	SHA256_CTX ctx;
+	unsigned char iv[16];
+	unsigned char out[32];
+	int pad_byte;
+	int datasize;
+	AES_KEY akey;
+	Twofish_key tkey;
+	struct chacha_ctx ckey;
 
-	if (any_cracked) {
-		memset(cracked, 0, cracked_size);
-		any_cracked = 0;
+	// set decryption key
+	if (cur_salt->algorithm == 0) {
+		/* AES decrypt cur_salt->contents with final_key */
+		memcpy(iv, cur_salt->enc_iv, 16);
+		memset(&akey, 0, sizeof(AES_KEY));
+		AES_set_decrypt_key(final_key, 256, &akey);
+	} else if (cur_salt->algorithm == 1) {
+		memcpy(iv, cur_salt->enc_iv, 16);
+		memset(&tkey, 0, sizeof(Twofish_key));
+		Twofish_prepare_key(final_key, 32, &tkey);
+	} else if (cur_salt->algorithm == 2) { // ChaCha20
+		memcpy(iv, cur_salt->enc_iv, 16);
+		chacha_keysetup(&ckey, final_key, 256);
+		chacha_ivsetup(&ckey, iv, NULL, 12);
 	}
 
+	if (cur_salt->version == 1 && cur_salt->algorithm == 0) {
+		decrypted_content = mem_alloc(cur_salt->contentsize);
+		AES_cbc_encrypt(cur_salt->contents, decrypted_content,
+		                cur_salt->contentsize, &akey, iv, AES_DECRYPT);
+		pad_byte = decrypted_content[cur_salt->contentsize - 1];
+		datasize = cur_salt->contentsize - pad_byte;
+		SHA256_Init(&ctx);
+		SHA256_Update(&ctx, decrypted_content, datasize);
+		SHA256_Final(out, &ctx);
+		MEM_FREE(decrypted_content);
+		if (!memcmp(out, cur_salt->contents_hash, 32)) {
+			cracked[index] = 1;
 #ifdef _OPENMP
-#pragma omp parallel for
+#pragma omp atomic
 #endif
-	for (index = 0; index < count; index++) {
-		unsigned char final_key[32];
-		unsigned char *decrypted_content;
-		SHA256_CTX ctx;
-		unsigned char iv[16];
-		unsigned char out[32];
-		int pad_byte;
-		int datasize;
-		AES_KEY akey;
-		Twofish_key tkey;
-		struct chacha_ctx ckey;
-
-		// derive and set decryption key
-		transform_key(keepass_key[index], cur_salt, final_key);
-		if (cur_salt->algorithm == 0) {
-			/* AES decrypt cur_salt->contents with final_key */
-			memcpy(iv, cur_salt->enc_iv, 16);
-			memset(&akey, 0, sizeof(AES_KEY));
-			AES_set_decrypt_key(final_key, 256, &akey);
-		} else if (cur_salt->algorithm == 1) {
-			memcpy(iv, cur_salt->enc_iv, 16);
-			memset(&tkey, 0, sizeof(Twofish_key));
-			Twofish_prepare_key(final_key, 32, &tkey);
-		} else if (cur_salt->algorithm == 2) { // ChaCha20
-			memcpy(iv, cur_salt->enc_iv, 16);
-			chacha_keysetup(&ckey, final_key, 256);
-			chacha_ivsetup(&ckey, iv, NULL, 12);
+			any_cracked |= 1;
 		}
+	}
+	else if (cur_salt->version == 2 && cur_salt->algorithm == 0) {
+		unsigned char dec_buf[32];
 
-		if (cur_salt->version == 1 && cur_salt->algorithm == 0) {
-			decrypted_content = mem_alloc(cur_salt->contentsize);
-			AES_cbc_encrypt(cur_salt->contents, decrypted_content,
-			                cur_salt->contentsize, &akey, iv, AES_DECRYPT);
-			pad_byte = decrypted_content[cur_salt->contentsize - 1];
-			datasize = cur_salt->contentsize - pad_byte;
-			SHA256_Init(&ctx);
-			SHA256_Update(&ctx, decrypted_content, datasize);
-			SHA256_Final(out, &ctx);
-			MEM_FREE(decrypted_content);
-			if (!memcmp(out, cur_salt->contents_hash, 32)) {
-				cracked[index] = 1;
+		AES_cbc_encrypt(cur_salt->contents, dec_buf, 32,
+		                &akey, iv, AES_DECRYPT);
+		if (!memcmp(dec_buf, cur_salt->expected_bytes, 32)) {
+			cracked[index] = 1;
 #ifdef _OPENMP
 #pragma omp atomic
 #endif
-				any_cracked |= 1;
-			}
+			any_cracked |= 1;
 		}
-		else if (cur_salt->version == 2 && cur_salt->algorithm == 0) {
-			unsigned char dec_buf[32];
+	}
+	else if (cur_salt->version == 2 && cur_salt->algorithm == 2) {
+		unsigned char dec_buf[32];
 
-			AES_cbc_encrypt(cur_salt->contents, dec_buf, 32,
-			                &akey, iv, AES_DECRYPT);
-			if (!memcmp(dec_buf, cur_salt->expected_bytes, 32)) {
-				cracked[index] = 1;
+		chacha_decrypt_bytes(&ckey, cur_salt->contents, dec_buf, 32);
+		if (!memcmp(dec_buf, cur_salt->expected_bytes, 32)) {
+			cracked[index] = 1;
 #ifdef _OPENMP
 #pragma omp atomic
 #endif
-				any_cracked |= 1;
-			}
+			any_cracked |= 1;
 		}
-		else if (cur_salt->version == 2 && cur_salt->algorithm == 2) {
-			unsigned char dec_buf[32];
 
-			chacha_decrypt_bytes(&ckey, cur_salt->contents, dec_buf, 32);
-			if (!memcmp(dec_buf, cur_salt->expected_bytes, 32)) {
+	}
+	else if (cur_salt->version == 1 && cur_salt->algorithm == 1) { /* KeePass 1.x with Twofish */
+		int crypto_size;
+
+		decrypted_content = mem_alloc(cur_salt->contentsize);
+		crypto_size = Twofish_Decrypt(&tkey, cur_salt->contents,
+		                              decrypted_content,
+		                              cur_salt->contentsize, iv);
+		datasize = crypto_size;  // awesome, right?
+		if (datasize <= cur_salt->contentsize && datasize > 0) {
+			SHA256_Init(&ctx);
+			SHA256_Update(&ctx, decrypted_content, datasize);
+			SHA256_Final(out, &ctx);
+			if (!memcmp(out, cur_salt->contents_hash, 32)) {
 				cracked[index] = 1;
 #ifdef _OPENMP
 #pragma omp atomic
 #endif
 				any_cracked |= 1;
 			}
-
 		}
-		else if (cur_salt->version == 1 && cur_salt->algorithm == 1) { /* KeePass 1.x with Twofish */
-			int crypto_size;
-
-			decrypted_content = mem_alloc(cur_salt->contentsize);
-			crypto_size = Twofish_Decrypt(&tkey, cur_salt->contents,
-			                              decrypted_content,
-			                              cur_salt->contentsize, iv);
-			datasize = crypto_size;  // awesome, right?
-			if (datasize <= cur_salt->contentsize && datasize > 0) {
-				SHA256_Init(&ctx);
-				SHA256_Update(&ctx, decrypted_content, datasize);
-				SHA256_Final(out, &ctx);
-				if (!memcmp(out, cur_salt->contents_hash, 32)) {
-					cracked[index] = 1;
+		MEM_FREE(decrypted_content);
+	} else {
+		// KeePass version 2 with Twofish is TODO. Twofish support under KeePass version 2
+		// requires a third-party plugin. See http://keepass.info/plugins.html for details.
+		error_msg("KeePass v2 w/ Twofish not supported yet");
+	}
+}
+
+static int crypt_all(int *pcount, struct db_salt *salt)
+{
+	const int count = *pcount;
+	int index = 0;
+
+	if (any_cracked) {
+		memset(cracked, 0, cracked_size);
+		any_cracked = 0;
+	}
+
 #ifdef _OPENMP
-#pragma omp atomic
+#pragma omp parallel for
 #endif
-					any_cracked |= 1;
-				}
-			}
-			MEM_FREE(decrypted_content);
-		} else {
-			// KeePass version 2 with Twofish is TODO. Twofish support under KeePass version 2
-			// requires a third-party plugin. See http://keepass.info/plugins.html for details.
-			error_msg("KeePass v2 w/ Twofish not supported yet");
-		}
+	for (index = 0; index < count; index += KEYS_PER_GROUP) {
+		unsigned char final_key[KEYS_PER_GROUP][32];
+		int i, n = MIN(count - index, KEYS_PER_GROUP);
+
+		transform_keys(index, n, cur_salt, final_key);
+		for (i = 0; i < n; i++)
+			check_key(index + i, final_key[i]);
 	}
 	return count;
 }
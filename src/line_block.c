@@ -0,0 +1,181 @@
+/*
+ * This file is part of John the Ripper password cracker.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted.
+ *
+ * There's ABSOLUTELY NO WARRANTY, express or implied.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+
+#include "line_block.h"
+#include "memdbg.h"
+
+void line_block_init(struct line_block *block, FILE *file, int line_max)
+{
+	memset(block, 0, sizeof(*block));
+	block->file = file;
+	block->line_max = line_max;
+	block->size = LINE_BLOCK_SIZE;
+	if (!(block->data = malloc(block->size))) {
+		fprintf(stderr, "%s:%d: malloc failed\n", __FUNCTION__, __LINE__);
+		exit(EXIT_FAILURE);
+	}
+}
+
+int line_block_read(struct line_block *block)
+{
+	size_t total, length;
+
+	memmove(block->data, block->data + block->length, block->carry);
+	total = block->carry;
+	block->length = block->carry = 0;
+
+	if (!block->eof) {
+		size_t want = block->size - total;
+		size_t got = fread(block->data + total, 1, want, block->file);
+
+		total += got;
+		block->eof = (got < want);
+	}
+
+	if (block->eof) {
+		block->length = total;
+		return total > 0;
+	}
+
+/*
+ * Stop after the last newline.  The block always starts where fgets() would
+ * start a line, so if there's no newline at all it's one very long line and
+ * we can stop where fgets() would have split it.
+ */
+	length = total;
+	while (length && block->data[length - 1] != '\n')
+		length--;
+	if (!length)
+		length = total - total % (block->line_max - 1);
+
+	block->length = length;
+	block->carry = total - length;
+
+	return 1;
+}
+
+char *line_block_part(struct line_block *block, int part, int parts)
+{
+	char *end = block->data + block->length;
+	char *p;
+
+	if (part <= 0)
+		return block->data;
+	if (part >= parts)
+		return end;
+
+	p = block->data + block->length / parts * part;
+	if (p > block->data && p[-1] == '\n')
+		return p;
+	p = memchr(p, '\n', end - p);
+
+	return p ? p + 1 : end;
+}
+
+size_t line_block_gets(char *line, int line_max, const char **ptr,
+	const char *end)
+{
+	const char *p = *ptr, *nl;
+	size_t length = end - p;
+
+	if (!length)
+		return 0;
+
+	if (length > (size_t)line_max - 1)
+		length = line_max - 1;
+	if ((nl = memchr(p, '\n', length)))
+		length = nl + 1 - p;
+
+	memcpy(line, p, length);
+	line[length] = 0;
+	*ptr = p + length;
+
+	return length;
+}
+
+unsigned int line_block_count(int line_max, const char *ptr,
+	const char *end)
+{
+	unsigned int lines = 0;
+
+	while (ptr < end) {
+		size_t length = end - ptr;
+		const char *nl;
+
+		if (length > (size_t)line_max - 1)
+			length = line_max - 1;
+		if ((nl = memchr(ptr, '\n', length)))
+			length = nl + 1 - ptr;
+
+		lines += (*ptr != 0);
+		ptr += length;
+	}
+
+	return lines;
+}
+
+void line_block_done(struct line_block *block)
+{
+	free(block->data);
+	block->data = NULL;
+}
+
+void line_out_printf(struct line_out *out, const char *fmt, ...)
+{
+	va_list args;
+	int length;
+
+	if (!out->size) {
+		out->size = 0x10000;
+		if (!(out->data = malloc(out->size))) {
+			fprintf(stderr, "%s:%d: malloc failed\n",
+			        __FUNCTION__, __LINE__);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	while (1) {
+		va_start(args, fmt);
+		length = vsnprintf(out->data + out->length,
+		                   out->size - out->length, fmt, args);
+		va_end(args);
+		if (length < 0) {
+			perror("vsnprintf");
+			exit(EXIT_FAILURE);
+		}
+		if (out->length + length < out->size)
+			break;
+		out->size = 2 * out->size + length + 1;
+		if (!(out->data = realloc(out->data, out->size))) {
+			fprintf(stderr, "%s:%d: realloc failed\n",
+			        __FUNCTION__, __LINE__);
+			exit(EXIT_FAILURE);
+		}
+	}
+	out->length += length;
+}
+
+void line_out_flush(struct line_out *out, FILE *file)
+{
+	if (out->length)
+		fwrite(out->data, 1, out->length, file);
+	out->length = 0;
+}
+
+void line_out_done(struct line_out *out)
+{
+	free(out->data);
+	out->data = NULL;
+	out->length = out->size = 0;
+}
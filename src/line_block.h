@@ -0,0 +1,87 @@
+/*
+ * This file is part of John the Ripper password cracker.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted.
+ *
+ * There's ABSOLUTELY NO WARRANTY, express or implied.
+ */
+
+/*
+ * Reads a text file in large blocks of whole lines, so that the lines of a
+ * block can be split between threads.  Lines are what a loop of fgets() with
+ * a buffer of line_max bytes would have returned, including how it breaks up
+ * lines that don't fit, so tools can switch to this without any change to
+ * their output.
+ */
+
+#ifndef _JOHN_LINE_BLOCK_H
+#define _JOHN_LINE_BLOCK_H
+
+#include <stdio.h>
+
+#define LINE_BLOCK_SIZE			(16 << 20)
+
+struct line_block {
+	FILE *file;
+	char *data;
+	size_t length;	/* bytes of whole lines at data */
+	size_t carry;	/* bytes after those, read ahead for the next block */
+	size_t size;
+	int line_max;
+	int eof;
+};
+
+extern void line_block_init(struct line_block *block, FILE *file,
+	int line_max);
+
+/*
+ * Reads the next block.  Returns zero once the file is exhausted.
+ */
+extern int line_block_read(struct line_block *block);
+
+/*
+ * Returns where part number "part" of "parts" roughly equal parts of the
+ * current block starts, always at the start of a line.  Part "parts" is the
+ * end of the block.
+ */
+extern char *line_block_part(struct line_block *block, int part, int parts);
+
+/*
+ * Same as fgets(line, line_max, ...) reading from *ptr up to end.  Returns
+ * the number of bytes copied to line, zero when there are none left.
+ */
+extern size_t line_block_gets(char *line, int line_max, const char **ptr,
+	const char *end);
+
+/*
+ * Counts the lines from ptr to end that line_block_gets() would return, not
+ * counting those starting with a NUL (which fgets() users tend to skip).
+ */
+extern unsigned int line_block_count(int line_max, const char *ptr,
+	const char *end);
+
+extern void line_block_done(struct line_block *block);
+
+/*
+ * Output of one thread's part of a block, to be written after those of the
+ * threads before it.
+ */
+struct line_out {
+	char *data;
+	size_t length, size;
+};
+
+#if __GNUC__
+__attribute__ ((format (printf, 2, 3)))
+#endif
+extern void line_out_printf(struct line_out *out, const char *fmt, ...);
+
+/*
+ * Writes out what was printed so far, and starts over.
+ */
+extern void line_out_flush(struct line_out *out, FILE *file);
+
+extern void line_out_done(struct line_out *out);
+
+#endif
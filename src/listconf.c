@@ -113,7 +113,8 @@ static void listconf_list_method_names()
 {
 	puts("init, done, reset, prepare, valid, split, binary, salt, tunable_cost_value,");
 	puts("source, binary_hash, salt_hash, salt_compare, set_salt, set_key, get_key,");
-	puts("clear_keys, crypt_all, get_hash, cmp_all, cmp_one, cmp_exact");
+	puts("clear_keys, crypt_all, get_hash, cmp_all, cmp_one, cmp_exact,");
+	puts("precompute_keys, get_hash_batch");
 }
 
 static void listconf_list_build_info(void)
@@ -735,6 +736,8 @@ void listconf_parse_late(void)
 				         strcasecmp(&options.listconf[15], "split") &&
 				         strcasecmp(&options.listconf[15], "binary") &&
 				         strcasecmp(&options.listconf[15], "clear_keys") &&
+				         strcasecmp(&options.listconf[15], "precompute_keys") &&
+				         strcasecmp(&options.listconf[15], "get_hash_batch") &&
 				         strcasecmp(&options.listconf[15], "salt") &&
 				         strcasecmp(&options.listconf[15], "tunable_cost_value") &&
 				         strcasecmp(&options.listconf[15], "tunable_cost_value[0]") &&
@@ -800,6 +803,10 @@ void listconf_parse_late(void)
 					ShowIt = 1;
 				if (format->methods.clear_keys != fmt_default_clear_keys && !strcasecmp(&options.listconf[15], "clear_keys"))
 					ShowIt = 1;
+				if (format->methods.precompute_keys && !strcasecmp(&options.listconf[15], "precompute_keys"))
+					ShowIt = 1;
+				if (format->methods.get_hash_batch && !strcasecmp(&options.listconf[15], "get_hash_batch"))
+					ShowIt = 1;
 				for (i = 0; i < PASSWORD_HASH_SIZES; ++i) {
 					char Buf[20];
 					sprintf(Buf, "get_hash[%d]", i);
@@ -882,6 +889,10 @@ void listconf_parse_late(void)
 				printf("\tcmp_one()\n");
 // there is no default for cmp_exact() it must be defined.
 				printf("\tcmp_exact()\n");
+				if (format->methods.precompute_keys)
+					printf("\tprecompute_keys()\n");
+				if (format->methods.get_hash_batch)
+					printf("\tget_hash_batch()\n");
 				printf("\n\n");
 			}
 			fmt_done(format);
@@ -25,6 +25,10 @@
 #include <string.h>
 #include <ctype.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include "arch.h"
 #include "misc.h"
 #include "params.h"
@@ -46,12 +50,28 @@
 #include "base64_convert.h"
 #include "md5.h"
 #include "single.h"
+#include "charset.h"
 #include "memdbg.h"
 
 #ifdef HAVE_CRYPT
 extern struct fmt_main fmt_crypt;
 #endif
 
+/*
+ * Salts with fewer hashes than this get their hash table built by one thread.
+ * Larger ones are done LDR_HASH_CHUNK hashes at a time by all threads.
+ */
+#define LDR_HASH_PARALLEL_MIN		0x10000
+#define LDR_HASH_CHUNK			0x100000
+
+/*
+ * Salts are sorted in runs of this many, which are then merged.  The runs
+ * don't depend on the number of threads, so neither does the order of salts
+ * that compare equal, and up to this many salts are sorted as they always
+ * were.
+ */
+#define LDR_SORT_RUN			0x10000
+
 /*
  * If this is set, we are loading john.pot so we should
  * probably not emit warnings from valid().
@@ -302,6 +322,7 @@ void ldr_init_database(struct db_main *db, struct db_options *db_options)
 	list_init(&db->plaintexts);
 
 	db->salt_count = db->password_count = db->guess_count = 0;
+	db->random_hashes = NULL;
 
 	db->format = NULL;
 }
@@ -1069,6 +1090,7 @@ static void ldr_load_pw_line(struct db_main *db, char *line)
 
 			current_salt->index = fmt_dummy_hash;
 			current_salt->bitmap = NULL;
+			current_salt->filter = NULL;
 			current_salt->list = NULL;
 			current_salt->hash = &current_salt->list;
 			current_salt->hash_size = -1;
@@ -1255,7 +1277,73 @@ static void ldr_load_pot_line(struct db_main *db, char *line)
 		db->options->flags |= DB_NEED_REMOVAL;
 }
 
-struct db_main *ldr_init_test_db(struct fmt_main *format, struct db_main *real)
+/*
+ * Adds count hashes with random binaries to the salts loaded so far, for
+ * formats where binaries are plain hash values.  These never match, but fill
+ * the bitmaps and hash tables like real loaded hashes would.
+ */
+static void ldr_add_random_hashes(struct db_main *db, int count)
+{
+	struct fmt_main *format = db->format;
+	struct db_salt **salts, *salt;
+	unsigned int seed = 0x5eed;
+	size_t align, pw_step, binary_step, pws_size;
+	char *pws, *binaries;
+	int i, n = 0;
+
+	if (!count || !db->salt_count || !format->params.binary_size ||
+	    format->methods.binary_hash[0] == fmt_default_binary_hash)
+		return;
+
+/*
+ * One block for all of them, so that the db can be freed after each format
+ * of an all-formats run instead of piling up in the mem_alloc_tiny() pool.
+ */
+	align = MAX(MEM_ALIGN_WORD, format->params.binary_align);
+	pw_step = (db->pw_size + MEM_ALIGN_WORD - 1) & ~(MEM_ALIGN_WORD - 1);
+	binary_step = (format->params.binary_size + align - 1) & ~(align - 1);
+	pws_size = (pw_step * count + align - 1) & ~(align - 1);
+	pws = db->random_hashes = mem_calloc_align(1,
+	    pws_size + binary_step * count, align);
+	binaries = pws + pws_size;
+
+	salts = mem_alloc(db->salt_count * sizeof(*salts));
+	for (i = 0; i < SALT_HASH_SIZE; i++)
+		for (salt = db->salt_hash[i]; salt; salt = salt->next)
+			salts[n++] = salt;
+
+	for (i = 0; i < count; i++) {
+		struct db_password *pw;
+		unsigned char *binary;
+		int j;
+
+		salt = salts[i % n];
+		pw = (struct db_password *)(pws + i * pw_step);
+		binary = (unsigned char *)binaries + i * binary_step;
+		for (j = 0; j < format->params.binary_size; j++) {
+			seed = seed * 1103515245 + 12345;
+			binary[j] = seed >> 16;
+		}
+		pw->binary = binary;
+		if (format->methods.source == fmt_default_source)
+			pw->source = salt->list->source;
+		if (db->options->flags & DB_LOGIN)
+			pw->login = pw->uid = "";
+		if (db->options->flags & DB_WORDS)
+			pw->words = salt->list->words;
+
+		pw->next = salt->list;
+		salt->list = pw;
+		salt->count++;
+		db->password_count++;
+	}
+
+	MEM_FREE(salts);
+}
+
+static struct db_main *ldr_init_test_db_hashes(struct fmt_main *format,
+                                               struct db_main *real,
+                                               int hashes)
 {
 	struct fmt_main *real_list = fmt_list;
 	struct fmt_main fake_list;
@@ -1313,6 +1401,7 @@ struct db_main *ldr_init_test_db(struct fmt_main *format, struct db_main *real)
 	}
 	bench_running--;
 
+	ldr_add_random_hashes(testdb, hashes);
 	ldr_fix_database(testdb);
 	ldr_loading_testdb = 0;
 
@@ -1325,6 +1414,16 @@ struct db_main *ldr_init_test_db(struct fmt_main *format, struct db_main *real)
 	return testdb;
 }
 
+struct db_main *ldr_init_test_db(struct fmt_main *format, struct db_main *real)
+{
+	return ldr_init_test_db_hashes(format, real, 0);
+}
+
+struct db_main *ldr_init_pipeline_db(struct fmt_main *format, int hashes)
+{
+	return ldr_init_test_db_hashes(format, NULL, hashes);
+}
+
 void ldr_free_test_db(struct db_main *db)
 {
 	if (db) {
@@ -1337,6 +1436,17 @@ void ldr_free_test_db(struct db_main *db)
 				psalt = psalt->next;
 			}
 		}
+		if (db->random_hashes) {
+			struct db_salt *salt;
+
+			for (salt = db->salts; salt; salt = salt->next) {
+				if (salt->hash != &salt->list)
+					MEM_FREE(salt->hash);
+				MEM_FREE(salt->bitmap);
+				MEM_FREE(salt->filter);
+			}
+			MEM_FREE(db->random_hashes);
+		}
 		MEM_FREE(db->salt_hash);
 		MEM_FREE(db->cracked_hash);
 		MEM_FREE(db);
@@ -1446,6 +1556,65 @@ static int ldr_salt_cmp_num(const void *x, const void *y) {
 	return cmp;
 }
 
+/*
+ * qsort() of LDR_SORT_RUN salts at a time in parallel, then merges of pairs
+ * of sorted runs, also in parallel while there are several pairs.
+ */
+static void ldr_sort_salt_array(salt_cmp_t *ar, int count,
+	int (*cmp)(const void *x, const void *y))
+{
+	salt_cmp_t *src, *dst, *tmp;
+	int runs = (count + LDR_SORT_RUN - 1) / LDR_SORT_RUN;
+	int width, i;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+	for (i = 0; i < runs; i++) {
+		int start = i * LDR_SORT_RUN;
+		int n = count - start < LDR_SORT_RUN ? count - start : LDR_SORT_RUN;
+
+		qsort(ar + start, n, sizeof(*ar), cmp);
+	}
+
+	if (runs < 2)
+		return;
+
+	src = ar;
+	dst = tmp = mem_alloc(count * sizeof(*tmp));
+	for (width = LDR_SORT_RUN; width < count; width *= 2) {
+		int pairs = (count - 1) / width / 2 + 1;
+		salt_cmp_t *swap;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+		for (i = 0; i < pairs; i++) {
+			int lo = i * 2 * width;
+			int mid = count - lo < width ? count : lo + width;
+			int hi = count - mid < width ? count : mid + width;
+			int l = lo, r = mid, o = lo;
+
+/* Left first on ties, so that merges keep the order that qsort() picked */
+			while (l < mid && r < hi)
+				dst[o++] = cmp(&src[r], &src[l]) < 0 ?
+				    src[r++] : src[l++];
+			while (l < mid)
+				dst[o++] = src[l++];
+			while (r < hi)
+				dst[o++] = src[r++];
+		}
+
+		swap = src;
+		src = dst;
+		dst = swap;
+	}
+
+	if (src != ar)
+		memcpy(ar, src, count * sizeof(*ar));
+	MEM_FREE(tmp);
+}
+
 static void ldr_gen_salt_md5(struct db_salt *s, int dynamic) {
 	if (dynamic) {
 		dynamic_salt_md5(s);
@@ -1513,9 +1682,9 @@ static void ldr_sort_salts(struct db_main *db)
 
 	dyna_salt_init(db->format);
 	if (fmt_salt_compare)
-		qsort(ar, db->salt_count, sizeof(ar[0]), ldr_salt_cmp);
+		ldr_sort_salt_array(ar, db->salt_count, ldr_salt_cmp);
 	else /* Most used salt first */
-		qsort(ar, db->salt_count, sizeof(ar[0]), ldr_salt_cmp_num);
+		ldr_sort_salt_array(ar, db->salt_count, ldr_salt_cmp_num);
 
 	/* Reset salt hash table, if we still have one */
 	if (db->salt_hash) {
@@ -1523,10 +1692,20 @@ static void ldr_sort_salts(struct db_main *db)
 		       SALT_HASH_SIZE * sizeof(struct db_salt *));
 	}
 
+	{
+		int dynamic =
+		    (db->format->params.flags & FMT_DYNAMIC) == FMT_DYNAMIC;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+		for (i = 0; i < db->salt_count; ++i)
+			ldr_gen_salt_md5(ar[i].p, dynamic);
+	}
+
 	/* finally, we re-build the linked list of salts */
 	db->salts = ar[0].p;
 	s = db->salts;
-	ldr_gen_salt_md5(s, (db->format->params.flags & FMT_DYNAMIC) == FMT_DYNAMIC);
 	for (i = 1; i <= db->salt_count; ++i) {
 		/* Rebuild salt hash table, if we still had one */
 		if (db->salt_hash) {
@@ -1539,7 +1718,6 @@ static void ldr_sort_salts(struct db_main *db)
 		if (i < db->salt_count) {
 			s->next = ar[i].p;
 			s = s->next;
-			ldr_gen_salt_md5(s, (db->format->params.flags & FMT_DYNAMIC) == FMT_DYNAMIC);
 		}
 	}
 	s->next = 0;
@@ -1706,6 +1884,110 @@ static void ldr_filter_costs(struct db_main *db)
 	} while ((current = current->next));
 }
 
+/*
+ * A pipeline benchmark db gets freed after its format is done, so its tables
+ * can't come from the mem_alloc_tiny() pool.
+ */
+static void *ldr_alloc_table(struct db_main *db, size_t size, size_t align)
+{
+	if (db->random_hashes)
+		return mem_alloc_align(size, align);
+
+	return mem_alloc_tiny(size, align);
+}
+
+/*
+ * Build salt->filter from its bitmap, if the bitmap is larger and not so full
+ * that the filter would pass nearly everything.  A bit of the filter is the OR
+ * of the bitmap bits with the same low bits of the hash, which are what the
+ * get_hash function of a smaller size would return.
+ */
+static void ldr_init_filter(struct db_main *db, struct db_salt *salt)
+{
+#if PASSWORD_HASH_FILTER_SIZE
+	size_t bitmap_words, filter_words, i;
+#endif
+
+	salt->filter = NULL;
+
+#if PASSWORD_HASH_FILTER_SIZE
+	if (password_hash_sizes[salt->hash_size] <= PASSWORD_HASH_FILTER_SIZE ||
+	    salt->count > PASSWORD_HASH_FILTER_THRESHOLD)
+		return;
+
+	bitmap_words = password_hash_sizes[salt->hash_size] /
+	    (sizeof(*salt->bitmap) * 8);
+	filter_words = PASSWORD_HASH_FILTER_SIZE / (sizeof(*salt->filter) * 8);
+	salt->filter = ldr_alloc_table(db,
+	    filter_words * sizeof(*salt->filter), MEM_ALIGN_CACHE);
+	memcpy(salt->filter, salt->bitmap,
+	    filter_words * sizeof(*salt->filter));
+	for (i = filter_words; i < bitmap_words; i++)
+		salt->filter[i % filter_words] |= salt->bitmap[i];
+#endif
+}
+
+#ifdef _OPENMP
+/*
+ * The same as the loop in ldr_init_hash_for_salt(), for salts with a lot of
+ * hashes.  For each chunk of the list, the hashes are computed in parallel,
+ * then each thread links in those that fall in its own range of bitmap words
+ * (and thus of hash buckets).  Every thread goes over the chunk in list order,
+ * so the chains come out the same as when built serially.
+ */
+static void ldr_init_hash_parallel(struct db_salt *salt,
+	int (*hash_func)(void *binary))
+{
+	struct db_password *current, **chunk;
+	unsigned int *hashes;
+	size_t words;
+
+	chunk = mem_alloc(LDR_HASH_CHUNK * sizeof(*chunk));
+	hashes = mem_alloc(LDR_HASH_CHUNK * sizeof(*hashes));
+	words = (password_hash_sizes[salt->hash_size] +
+	    sizeof(*salt->bitmap) * 8 - 1) / (sizeof(*salt->bitmap) * 8);
+
+	salt->count = 0;
+	current = salt->list;
+	while (current) {
+		int count = 0, i;
+
+		do {
+			chunk[count++] = current;
+		} while ((current = current->next) && count < LDR_HASH_CHUNK);
+
+#pragma omp parallel for schedule(static)
+		for (i = 0; i < count; i++)
+			hashes[i] = hash_func(chunk[i]->binary);
+
+#pragma omp parallel
+		{
+			int t = omp_get_thread_num(), n = omp_get_num_threads();
+			size_t start = words * t / n * sizeof(*salt->bitmap) * 8;
+			size_t end = words * (t + 1) / n * sizeof(*salt->bitmap) * 8;
+			int j;
+
+			for (j = 0; j < count; j++) {
+				unsigned int hash = hashes[j];
+
+				if (hash < start || hash >= end)
+					continue;
+				salt->bitmap[hash / (sizeof(*salt->bitmap) * 8)] |=
+				    1U << (hash % (sizeof(*salt->bitmap) * 8));
+				hash >>= PASSWORD_HASH_SHR;
+				chunk[j]->next_hash = salt->hash[hash];
+				salt->hash[hash] = chunk[j];
+			}
+		}
+
+		salt->count += count;
+	}
+
+	MEM_FREE(hashes);
+	MEM_FREE(chunk);
+}
+#endif
+
 /*
  * Allocate memory for and initialize the hash table for this salt if needed.
  * Also initialize salt->count (the number of password hashes for this salt).
@@ -1733,14 +2015,14 @@ static void ldr_init_hash_for_salt(struct db_main *db, struct db_salt *salt)
 		size_t size = (bitmap_size +
 		    sizeof(*salt->bitmap) * 8 - 1) /
 		    (sizeof(*salt->bitmap) * 8) * sizeof(*salt->bitmap);
-		salt->bitmap = mem_alloc_tiny(size, sizeof(*salt->bitmap));
+		salt->bitmap = ldr_alloc_table(db, size, sizeof(*salt->bitmap));
 		memset(salt->bitmap, 0, size);
 	}
 
 	hash_size = bitmap_size >> PASSWORD_HASH_SHR;
 	if (hash_size > 1) {
 		size_t size = hash_size * sizeof(struct db_password *);
-		salt->hash = mem_alloc_tiny(size, MEM_ALIGN_WORD);
+		salt->hash = ldr_alloc_table(db, size, MEM_ALIGN_WORD);
 		memset(salt->hash, 0, size);
 	}
 
@@ -1748,6 +2030,13 @@ static void ldr_init_hash_for_salt(struct db_main *db, struct db_salt *salt)
 
 	hash_func = db->format->methods.binary_hash[salt->hash_size];
 
+#ifdef _OPENMP
+	if (hash_size > 1 && salt->count >= LDR_HASH_PARALLEL_MIN &&
+	    omp_get_max_threads() > 1)
+		ldr_init_hash_parallel(salt, hash_func);
+	else
+#endif
+	{
 	salt->count = 0;
 	if ((current = salt->list))
 	do {
@@ -1762,15 +2051,17 @@ static void ldr_init_hash_for_salt(struct db_main *db, struct db_salt *salt)
 			current->next_hash = current->next;
 		salt->count++;
 	} while ((current = current->next));
+	}
+
+	ldr_init_filter(db, salt);
 }
 
 /*
- * Decide on whether to use a hash table and on its size for each salt, call
- * ldr_init_hash_for_salt() to allocate and initialize the hash tables.
+ * Decide on whether to use a hash table and on its size for a salt with this
+ * many password hashes.  Returns the hash table size code, negative for none.
  */
-static void ldr_init_hash(struct db_main *db)
+static int ldr_hash_size(struct db_main *db, int count)
 {
-	struct db_salt *current;
 	int threshold, size;
 
 	threshold = password_hash_thresholds[0];
@@ -1784,22 +2075,32 @@ static void ldr_init_hash(struct db_main *db)
 		threshold = 5 * ARCH_BITS / ARCH_BITS_LOG + 1;
 	}
 
-	if ((current = db->salts))
-	do {
-		size = -1;
-		if (current->count >= threshold && mem_saving_level < 3)
-			for (size = PASSWORD_HASH_SIZES - 1; size >= 0; size--)
-				if (current->count >=
-				    password_hash_thresholds[size] &&
-				    db->format->methods.binary_hash[size] &&
-				    db->format->methods.binary_hash[size] !=
-				    fmt_default_binary_hash)
-					break;
+	size = -1;
+	if (count >= threshold && mem_saving_level < 3)
+		for (size = PASSWORD_HASH_SIZES - 1; size >= 0; size--)
+			if (count >= password_hash_thresholds[size] &&
+			    db->format->methods.binary_hash[size] &&
+			    db->format->methods.binary_hash[size] !=
+			    fmt_default_binary_hash)
+				break;
+
+	if (mem_saving_level >= 2)
+		size--;
 
-		if (mem_saving_level >= 2)
-			size--;
+	return size;
+}
+
+/*
+ * Call ldr_hash_size() and ldr_init_hash_for_salt() to allocate and
+ * initialize the hash tables for each salt.
+ */
+static void ldr_init_hash(struct db_main *db)
+{
+	struct db_salt *current;
 
-		current->hash_size = size;
+	if ((current = db->salts))
+	do {
+		current->hash_size = ldr_hash_size(db, current->count);
 		ldr_init_hash_for_salt(db, current);
 #ifdef DEBUG_HASH
 		if (current->hash_size > 0)
@@ -1816,6 +2117,86 @@ static void ldr_init_hash(struct db_main *db)
 	} while ((current = current->next));
 }
 
+int ldr_shrink_hash(struct db_main *db, struct db_salt *salt)
+{
+	struct db_password **old_hash = salt->hash, *current, *next;
+	unsigned int *old_bitmap = salt->bitmap;
+	int (*old_func)(void *binary), (*hash_func)(void *binary);
+	size_t old_hash_size, bitmap_size, hash_size, i;
+	int size, hash;
+
+	size = ldr_hash_size(db, salt->count);
+	if (size < 0)
+		size = 0;
+	if (!old_bitmap || size >= salt->hash_size ||
+	    !db->format->methods.binary_hash[size] ||
+	    db->format->methods.binary_hash[size] == fmt_default_binary_hash)
+		return 0;
+
+	old_hash_size =
+	    password_hash_sizes[salt->hash_size] >> PASSWORD_HASH_SHR;
+	bitmap_size = password_hash_sizes[size];
+	hash_size = bitmap_size >> PASSWORD_HASH_SHR;
+	if (old_hash_size <= 1 || hash_size <= 1)
+		return 0;
+
+	old_func = db->format->methods.binary_hash[salt->hash_size];
+	hash_func = db->format->methods.binary_hash[size];
+
+/*
+ * The old tables are from mem_alloc_tiny() so they aren't freed (unless this
+ * is a pipeline benchmark db, see below), but they won't be touched again.  Each size is at least 8 times smaller than the
+ * next one up, so all shrinks of a salt add less than 1/7 to its memory.
+ */
+	{
+		size_t size = (bitmap_size +
+		    sizeof(*salt->bitmap) * 8 - 1) /
+		    (sizeof(*salt->bitmap) * 8) * sizeof(*salt->bitmap);
+		salt->bitmap = ldr_alloc_table(db, size, sizeof(*salt->bitmap));
+		memset(salt->bitmap, 0, size);
+	}
+	{
+		size_t size = hash_size * sizeof(struct db_password *);
+		salt->hash = ldr_alloc_table(db, size, MEM_ALIGN_WORD);
+		memset(salt->hash, 0, size);
+	}
+
+/*
+ * The list may still hold cracked entries (crk_remove_hash() leaves them
+ * there unless "single crack" mode or the format needs them gone), so
+ * rebuild from the old hash table instead.  A removed entry may also have
+ * been left alone in its bucket, with its bitmap bit cleared.
+ */
+	for (i = 0; i < old_hash_size; i++)
+	for (current = old_hash[i]; current; current = next) {
+		next = current->next_hash;
+		if (!current->binary)
+			continue;
+		hash = old_func(current->binary);
+		if (!(old_bitmap[hash / (sizeof(*old_bitmap) * 8)] &
+		    (1U << (hash % (sizeof(*old_bitmap) * 8)))))
+			continue;
+		hash = hash_func(current->binary);
+		salt->bitmap[hash / (sizeof(*salt->bitmap) * 8)] |=
+		    1U << (hash % (sizeof(*salt->bitmap) * 8));
+		hash >>= PASSWORD_HASH_SHR;
+		current->next_hash = salt->hash[hash];
+		salt->hash[hash] = current;
+	}
+
+	if (db->random_hashes) {
+		MEM_FREE(old_hash);
+		MEM_FREE(old_bitmap);
+		MEM_FREE(salt->filter);
+	}
+
+	salt->hash_size = size;
+	salt->index = db->format->methods.get_hash[size];
+	ldr_init_filter(db, salt);
+
+	return 1;
+}
+
 /*
  * compute cost ranges after all unneeded salts have been removed
  */
@@ -1951,7 +2332,7 @@ static void ldr_show_pot_line(struct db_main *db, char *line)
 		} while (*pos++);
 
 		if (db->options->flags & DB_PLAINTEXTS) {
-			list_add(db->plaintexts, line);
+			charset_add_plaintext(line);
 			return;
 		}
 /*
@@ -2129,7 +2510,7 @@ static void ldr_show_pw_line(struct db_main *db, char *line)
 				} else if (loop) {
 					strcat(joined, current->plaintext);
 				} else
-					list_add(db->plaintexts,
+					charset_add_plaintext(
 						current->plaintext);
 
 				db->guess_count++;
@@ -55,10 +55,10 @@ struct db_password {
  */
 struct db_keys_hash_entry {
 /* Index of next key with the same hash, or -1 if none */
-	short next;
+	int next;
 
 /* Byte offset of this key in the buffer */
-	unsigned short offset;
+	unsigned int offset;
 };
 
 /*
@@ -66,9 +66,9 @@ struct db_keys_hash_entry {
  */
 struct db_keys_hash {
 /* The hash table, maps to indices for the list below; -1 means empty bucket */
-	short hash[SINGLE_HASH_SIZE];
+	int hash[SINGLE_HASH_SIZE];
 
-/* List of keys with the same hash, allocated as min_keys_per_crypt entries */
+/* List of keys with the same hash, allocated as one entry per buffered key */
 	struct db_keys_hash_entry list[1];
 };
 
@@ -100,7 +100,7 @@ struct db_keys {
 /* Number of recursive calls for this salt */
 	int lock;
 
-/* The keys, allocated as (plaintext_length * min_keys_per_crypt) bytes */
+/* The keys, allocated as (plaintext_length * buffered keys) bytes */
 	char buffer[1];
 };
 
@@ -122,6 +122,10 @@ struct db_salt {
  * bits are zero. */
 	unsigned int *bitmap;
 
+/* The bitmap above folded to PASSWORD_HASH_FILTER_SIZE bits, small enough to
+ * stay in cache and checked first, or NULL if not worth it for this salt. */
+	unsigned int *filter;
+
 /* Pointer to a hash function to get the bit index into the bitmap above for
  * the crypt_all() method output with given index.  The function always returns
  * zero if there's no bitmap for this salt. */
@@ -259,6 +263,13 @@ struct db_main {
 /* Ciphertext format */
 	struct fmt_main *format;
 
+/*
+ * Memory block holding the random password hashes of a pipeline benchmark
+ * db, NULL if there are none.  Such a db also mem_alloc()s its per-salt
+ * tables, so that ldr_free_test_db() can give it all back.
+ */
+	void *random_hashes;
+
 /*
  * Pointer to real db. NULL if there is none. If this db *is* the real db
  * this points back to ourself (db->real == db).
@@ -296,6 +307,14 @@ extern void ldr_load_pot_file(struct db_main *db, char *name);
  */
 extern void ldr_fix_database(struct db_main *db);
 
+/*
+ * Rebuilds a salt's bitmap and hash table at the smaller size the loader
+ * would pick for its current password count, if that is smaller than what
+ * it has.  Returns non-zero if it did.  Must not be called while the old
+ * tables are in use, such as from the middle of crk_password_loop().
+ */
+extern int ldr_shrink_hash(struct db_main *db, struct db_salt *salt);
+
 /*
  * Create a fake database from a format's test vectors and return a pointer
  * to it.
@@ -303,6 +322,14 @@ extern void ldr_fix_database(struct db_main *db);
 extern struct db_main *ldr_init_test_db(struct fmt_main *format,
                                         struct db_main *real);
 
+/*
+ * Like ldr_init_test_db(), but also adds the given number of hashes with
+ * random binaries (spread over the test vectors' salts), for benchmarking
+ * the cracker with many loaded hashes.
+ */
+extern struct db_main *ldr_init_pipeline_db(struct fmt_main *format,
+                                            int hashes);
+
 /*
  * Destroy a fake database.
  */
@@ -7,6 +7,9 @@
 
 #include <stdio.h>
 #include <string.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include "arch.h"
 #include "misc.h"
@@ -42,15 +45,22 @@ static int regex_case;
 static char *regex;
 #endif
 
+/*
+ * The iterator counts candidates from 1, while the session file keeps
+ * the 0-based index older versions wrote, so their .rec files still
+ * resume at the same candidate.  0 means not started, use the start.
+ */
 static void save_state(FILE *file)
 {
-	fprintf(file, LLd "\n", tidx);
+	fprintf(file, LLd "\n", tidx ? tidx - 1 : 0);
 }
 
 static int restore_state(FILE *file)
 {
 	if (fscanf(file, LLd "\n", &gidx) != 1)
 		return 1;
+	if (gidx)
+		gidx++;
 
 	return 0;
 }
@@ -69,259 +79,114 @@ void mkv_hybrid_fix_state(void)
 	hybrid_tidx = gidx;
 }
 
-static int show_pwd_rnbs(struct db_main *db, struct s_pwd *pwd)
+static int process_key(struct db_main *db, char *word)
 {
-	unsigned long long i;
-	unsigned int k;
-	unsigned long lvl;
 	char pass_filtered[PLAINTEXT_BUFFER_SIZE];
-	char *pass;
-
-	k = 0;
-	i = nbparts[pwd->password[pwd->len - 1] + pwd->len * 256 +
-	            pwd->level * 256 * gmax_len];
-	pwd->len++;
-	lvl = pwd->level;
-	pwd->password[pwd->len] = 0;
-	while (i > 1) {
-		pwd->password[pwd->len - 1] =
-		    charsorted[pwd->password[pwd->len - 2] * 256 + k];
-		pwd->level =
-		    lvl + proba2[pwd->password[pwd->len - 2] * 256 +
-		                 pwd->password[pwd->len - 1]];
-		i -= nbparts[pwd->password[pwd->len - 1] + pwd->len * 256 +
-		             pwd->level * 256 * gmax_len];
-		if (pwd->len <= gmax_len) {
-			if (show_pwd_rnbs(db, pwd))
-				return 1;
-		}
-		if ((pwd->len >= gmin_len) && (pwd->level >= gmin_level)) {
-			pass = (char *)pwd->password;
+	char *pass = word;
+
 #if HAVE_REXGEN
-			if (regex) {
-				if (do_regex_hybrid_crack(db, regex, pass,
-				                          regex_case, regex_alpha))
-					return 1;
-				mkv_hybrid_fix_state();
-			} else
+	if (regex) {
+		if (do_regex_hybrid_crack(db, regex, pass, regex_case, regex_alpha))
+			return 1;
+		mkv_hybrid_fix_state();
+	} else
 #endif
-			if (f_new) {
-				if (do_external_hybrid_crack(db, pass))
-					return 1;
-				mkv_hybrid_fix_state();
-			} else
-			if (options.mask) {
-				if (do_mask_crack(pass))
-					return 1;
-			} else
-			if (!f_filter ||
-			    ext_filter_body((char *)pwd->password, pass = pass_filtered))
-				if (crk_process_key(pass))
-					return 1;
-		}
-		gidx++;
-		k++;
-		if (gidx > gend)
+	if (f_new) {
+		if (do_external_hybrid_crack(db, pass))
 			return 1;
-	}
-	pwd->len--;
-	pwd->password[pwd->len] = 0;
-	pwd->level = lvl;
+		mkv_hybrid_fix_state();
+	} else
+	if (options.mask) {
+		if (do_mask_crack(pass))
+			return 1;
+	} else
+	if (!f_filter || ext_filter_body(word, pass = pass_filtered))
+		if (crk_process_key(pass))
+			return 1;
+
 	return 0;
 }
 
-static int show_pwd_r(struct db_main *db, struct s_pwd *pwd, unsigned int bs)
+/*
+ * Candidates are handed to the cracker in index order, with gidx set to
+ * each one's index so that the saved state stays exact.
+ */
+static int process_block(struct db_main *db, struct mkv_block *block)
 {
-	unsigned long long i;
-	unsigned int k;
-	unsigned long lvl;
-	unsigned char curchar;
-	char pass_filtered[PLAINTEXT_BUFFER_SIZE];
-	char *pass;
-
-	k = 0;
-	i = nbparts[pwd->password[pwd->len - 1] + pwd->len * 256 +
-	            pwd->level * 256 * gmax_len];
-	pwd->len++;
-	lvl = pwd->level;
-	if (bs) {
-		while ((curchar =
-		            charsorted[pwd->password[pwd->len - 2] * 256 + k]) !=
-		        pwd->password[pwd->len - 1]) {
-			i -= nbparts[curchar + pwd->len * 256 + (pwd->level +
-			             proba2[pwd->password[pwd->len - 2] * 256 +
-			                    curchar]) * 256 * gmax_len];
-			k++;
-		}
-		pwd->level +=
-		    proba2[pwd->password[pwd->len - 2] * 256 + pwd->password[pwd->len -
-		            1]];
-		if (pwd->password[pwd->len] != 0)
-			if (show_pwd_r(db, pwd, 1))
-				return 1;
-		i -= nbparts[pwd->password[pwd->len - 1] + pwd->len * 256 +
-		             pwd->level * 256 * gmax_len];
-		if ((pwd->len >= gmin_len) && (pwd->level >= gmin_level)) {
-			pass = (char *)pwd->password;
-#if HAVE_REXGEN
-			if (regex) {
-				if (do_regex_hybrid_crack(db, regex, pass,
-				                          regex_case, regex_alpha))
-					return 1;
-				mkv_hybrid_fix_state();
-			} else
-#endif
-			if (f_new) {
-				if (do_external_hybrid_crack(db, pass))
-					return 1;
-				mkv_hybrid_fix_state();
-			} else
-			if (options.mask) {
-				if (do_mask_crack(pass))
-					return 1;
-			} else
-			if (!f_filter ||
-			    ext_filter_body((char *)pwd->password, pass = pass_filtered))
-				if (crk_process_key(pass))
-					return 1;
-		}
-		gidx++;
-		k++;
-	}
-	pwd->password[pwd->len] = 0;
-	while (i > 1) {
-		pwd->password[pwd->len - 1] =
-		    charsorted[pwd->password[pwd->len - 2] * 256 + k];
-		pwd->level =
-		    lvl + proba2[pwd->password[pwd->len - 2] * 256 +
-		                 pwd->password[pwd->len - 1]];
-		i -= nbparts[pwd->password[pwd->len - 1] + pwd->len * 256 +
-		             pwd->level * 256 * gmax_len];
-		if (pwd->len <= gmax_len) {
-			if (show_pwd_r(db, pwd, 0))
-				return 1;
-		}
-		if ((pwd->len >= gmin_len) && (pwd->level >= gmin_level)) {
-			pass = (char *)pwd->password;
-#if HAVE_REXGEN
-			if (regex) {
-				if (do_regex_hybrid_crack(db, regex, pass,
-				                          regex_case, regex_alpha))
-					return 1;
-				mkv_hybrid_fix_state();
-			} else
-#endif
-			if (f_new) {
-				if (do_external_hybrid_crack(db, pass))
-					return 1;
-				mkv_hybrid_fix_state();
-			} else
-			if (options.mask) {
-				if (do_mask_crack(pass))
-					return 1;
-			} else
-			if (!f_filter ||
-			    ext_filter_body((char *)pwd->password, pass = pass_filtered))
-				if (crk_process_key(pass))
-					return 1;
-		}
-		gidx++;
-		k++;
-		if (gidx > gend)
+	int i;
+
+	for (i = 0; i < block->count; i++) {
+		gidx = block->idx[i];
+		if (process_key(db, block->key[i]))
 			return 1;
 	}
-	pwd->len--;
-	pwd->password[pwd->len] = 0;
-	pwd->level = lvl;
+
 	return 0;
 }
 
 static int show_pwd(struct db_main *db, unsigned long long start)
 {
-	struct s_pwd pwd;
-	unsigned int i;
-	char pass_filtered[PLAINTEXT_BUFFER_SIZE];
-	char *pass;
+	struct mkv_block *blocks;
+	unsigned long long base;
+	int threads = 1;
+	int ret = 0;
 
 	if (gidx == 0)
 		gidx = start;
-	i = 0;
-
-	if (gidx > 0) {
-		print_pwd(gidx, &pwd, gmax_level, gmax_len);
-		while (charsorted[i] != pwd.password[0])
-			i++;
-		pwd.len = 1;
-		pwd.level = proba1[pwd.password[0]];
-		if (pwd.level <= gmax_level) {
-			if (show_pwd_r(db, &pwd, 1))
-				return 1;
-
-			if ((pwd.len >= gmin_len) && (pwd.level >= gmin_level)) {
-				pass = (char *)pwd.password;
-#if HAVE_REXGEN
-				if (regex) {
-					if (do_regex_hybrid_crack(db, regex, pass,
-					                          regex_case, regex_alpha))
-						return 1;
-					mkv_hybrid_fix_state();
-				} else
+
+#ifdef _OPENMP
+	threads = omp_get_max_threads();
 #endif
-				if (f_new) {
-					if (do_external_hybrid_crack(db, pass))
-						return 1;
-					mkv_hybrid_fix_state();
-				} else
-				if (options.mask) {
-					if (do_mask_crack(pass))
-						return 1;
-				} else
-				if (!f_filter ||
-				    ext_filter_body((char *)pwd.password, pass = pass_filtered))
-					if (crk_process_key(pass))
-						return 1;
-			}
-		}
-		gidx++;
-		i++;
+
+	blocks = mem_alloc(threads * sizeof(struct mkv_block));
+
+	if (threads == 1) {
+		struct mkv_iter it;
+
+		mkv_iter_init(&it, gidx, gend);
+		while (mkv_iter_fill(&it, blocks))
+			if ((ret = process_block(db, blocks)))
+				break;
+
+		MEM_FREE(blocks);
+		return ret;
 	}
-	while (proba1[charsorted[i]] <= gmax_level) {
-		if (gidx > gend)
-			return 1;
-		pwd.len = 1;
-		pwd.password[0] = charsorted[i];
-		pwd.level = proba1[pwd.password[0]];
-		pwd.password[1] = 0;
-		if (show_pwd_rnbs(db, &pwd))
-			return 1;
-		if ((pwd.len >= gmin_len) && (pwd.level >= gmin_level)) {
-			pass = (char *)pwd.password;
-#if HAVE_REXGEN
-			if (regex) {
-				if (do_regex_hybrid_crack(db, regex, pass,
-				                          regex_case, regex_alpha))
-					return 1;
-				mkv_hybrid_fix_state();
-			} else
+
+	/*
+	 * Each thread enumerates its own [start, end] index range, jumping
+	 * straight to it through nbparts.  The blocks are then processed in
+	 * order, so the candidate sequence is the same as with one thread.
+	 */
+	for (base = gidx ? gidx : 1; base <= gend && !ret;
+	     base += (unsigned long long)threads * MKV_BLOCK_KEYS) {
+		int t;
+
+#ifdef _OPENMP
+#pragma omp parallel for
 #endif
-			if (f_new) {
-				if (do_external_hybrid_crack(db, pass))
-					return 1;
-				mkv_hybrid_fix_state();
-			} else
-			if (options.mask) {
-				if (do_mask_crack(pass))
-					return 1;
-			} else
-			if (!f_filter ||
-			    ext_filter_body((char *)pwd.password, pass = pass_filtered))
-				if (crk_process_key(pass))
-					return 1;
+		for (t = 0; t < threads; t++) {
+			unsigned long long first, last;
+			struct mkv_iter it;
+
+			first = base + (unsigned long long)t * MKV_BLOCK_KEYS;
+			last = first + MKV_BLOCK_KEYS - 1;
+			if (last > gend)
+				last = gend;
+			if (first > last) {
+				blocks[t].count = 0;
+				continue;
+			}
+			mkv_iter_init(&it, first, last);
+			mkv_iter_fill(&it, &blocks[t]);
 		}
-		gidx++;
-		i++;
+
+		for (t = 0; t < threads; t++)
+			if ((ret = process_block(db, &blocks[t])))
+				break;
 	}
-	return 0;
+
+	MEM_FREE(blocks);
+	return ret;
 }
 
 static double get_progress(void)
@@ -719,7 +584,7 @@ void do_markov_crack(struct db_main *db, char *mkv_param)
 	}
 
 	gstart = mkv_start;
-	gend = mkv_end + 10;        /* omg !! */
+	gend = mkv_end;
 
 	if (param)
 		log_event("Proceeding with Markov mode %s", param);
@@ -15,6 +15,9 @@
 #pragma warning ( disable : 4244 )
 #endif
 #include <string.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #define MAX_LEN 7
 
@@ -22,6 +25,7 @@
 #include "mkvlib.h"
 #include "memory.h"
 #include "jumbo.h"
+#include "line_block.h"
 #include "memdbg.h"
 
 #define C2I(c) ((unsigned int)(unsigned char)(c))
@@ -30,6 +34,55 @@ unsigned char *proba1;
 unsigned char *proba2;
 unsigned char *first;
 
+static unsigned char position[256];
+static unsigned int charset;
+
+static void score_lines(const char *ptr, const char *end, struct line_out *out)
+{
+	char ligne[4096];
+	unsigned int i;
+	unsigned int j;
+	unsigned int k;
+	unsigned int l;
+	unsigned long long index;
+
+	while (line_block_gets(ligne, sizeof(ligne), &ptr, end)) {
+		if (ligne[0] == 0)
+			continue;
+		ligne[strlen(ligne) - 1] = 0;   // chop
+		i = 1;
+		j = 0;
+		k = 0;
+		j = C2I(ligne[0]);
+		k = proba1[j];
+		if (ligne[0] == 0)
+			k = 0;
+		line_out_printf(out, "%s\t%d", ligne, k);
+		l = 0;
+		index = position[j];
+		if (position[j] == 255)
+			index = 8.1E18;
+		while (ligne[i]) {
+			if (index < 8E18)
+				index = (index * charset) + position[C2I(ligne[i])];
+			if (position[C2I(ligne[i])] == 255)
+				index = 8.1E18;
+			line_out_printf(out, "+%d", proba2[j * 256 + C2I(ligne[i])]);
+			k += proba2[j * 256 + C2I(ligne[i])];
+			if (l)
+				l += proba2[j * 256 + C2I(ligne[i])];
+			if (i == 2)
+				l = proba1[C2I(ligne[i])];
+			j = C2I(ligne[i]);
+			i++;
+		}
+		if (index < 8E18)
+			line_out_printf(out, "\t%d\t%d\t" LLd "\t%d\n", k, i, index, l);
+		else
+			line_out_printf(out, "\t%d\t%d\t-\t%d\n", k, i, l);
+	}
+}
+
 #ifdef HAVE_LIBFUZZER
 int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
 {
@@ -48,11 +101,10 @@ int main(int argc, char **argv)
 	unsigned int i;
 	unsigned int j;
 	unsigned int k;
-	unsigned int l;
-	unsigned long long index;
-	unsigned char position[256];
-	unsigned int charset;
+	int t, threads;
 	unsigned int nb_lignes;
+	struct line_out *out;
+	struct line_block block;
 
 	if (argc < 2 || argc > 3) {
 		printf("Usage: %s statfile [pwdfile]\n", argv[0]);
@@ -152,41 +204,36 @@ int main(int argc, char **argv)
 		fichier = stdin;
 		fprintf(stderr, "reading from stdin ...\n");
 	}
-	while (fgets(ligne, 4096, fichier)) {
-		if (ligne[0] == 0)
-			continue;
-		ligne[strlen(ligne) - 1] = 0;   // chop
-		i = 1;
-		j = 0;
-		k = 0;
-		j = C2I(ligne[0]);
-		k = proba1[j];
-		if (ligne[0] == 0)
-			k = 0;
-		printf("%s\t%d", ligne, k);
-		l = 0;
-		index = position[j];
-		if (position[j] == 255)
-			index = 8.1E18;
-		while (ligne[i]) {
-			if (index < 8E18)
-				index = (index * charset) + position[C2I(ligne[i])];
-			if (position[C2I(ligne[i])] == 255)
-				index = 8.1E18;
-			printf("+%d", proba2[j * 256 + C2I(ligne[i])]);
-			k += proba2[j * 256 + C2I(ligne[i])];
-			if (l)
-				l += proba2[j * 256 + C2I(ligne[i])];
-			if (i == 2)
-				l = proba1[C2I(ligne[i])];
-			j = C2I(ligne[i]);
-			i++;
-		}
-		if (index < 8E18)
-			printf("\t%d\t%d\t" LLd "\t%d\n", k, i, index, l);
-		else
-			printf("\t%d\t%d\t-\t%d\n", k, i, l);
+
+#ifdef _OPENMP
+	threads = omp_get_max_threads();
+#else
+	threads = 1;
+#endif
+	if (!(out = calloc(threads, sizeof(*out)))) {
+		perror("malloc out");
+		return 3;
 	}
+
+/* Threads score parts of a block each, then their output is written in order */
+	line_block_init(&block, fichier, 4096);
+	while (line_block_read(&block)) {
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(threads)
+#endif
+		for (t = 0; t < threads; t++)
+			score_lines(line_block_part(&block, t, threads),
+			            line_block_part(&block, t + 1, threads),
+			            &out[t]);
+		for (t = 0; t < threads; t++)
+			line_out_flush(&out[t], stdout);
+	}
+	line_block_done(&block);
+
+	for (t = 0; t < threads; t++)
+		line_out_done(&out[t]);
+	free(out);
+
 	fprintf(stderr, "freeing stuff ...\n");
 
 	fclose(fichier);
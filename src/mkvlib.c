@@ -111,6 +111,146 @@ void print_pwd(unsigned long long index, struct s_pwd *pwd,
 	pwd->len = len - 1;
 }
 
+#define MKV_NB(c, len, level) \
+	nbparts[(c) + (len) * 256 + (level) * 256 * gmax_len]
+
+static unsigned int mkv_child_level(struct mkv_iter *it, unsigned int d,
+                                    unsigned char c)
+{
+	if (d == 0)
+		return proba1[c];
+
+	return it->level[d - 1] + proba2[it->password[d - 1] * 256 + c];
+}
+
+/*
+ * Goes down the first-child chain from the current node, so that the
+ * deepest extension of the current prefix becomes the current candidate.
+ */
+static void mkv_descend(struct mkv_iter *it)
+{
+	unsigned int d = it->len - 1;
+	unsigned long long nb;
+
+	while ((nb = MKV_NB(it->password[d], d + 1, it->level[d])) > 1) {
+		unsigned char c = charsorted[it->password[d] * 256];
+
+		d++;
+		it->k[d] = 0;
+		it->password[d] = c;
+		it->level[d] = mkv_child_level(it, d, c);
+		it->left[d] = nb - MKV_NB(c, d + 1, it->level[d]);
+	}
+	it->len = d + 1;
+	it->password[it->len] = 0;
+}
+
+/*
+ * Moves to the next candidate: the next sibling's deepest extension if
+ * there is a sibling left, the parent prefix otherwise.
+ */
+static void mkv_step(struct mkv_iter *it)
+{
+	unsigned int d = it->len - 1;
+
+	it->idx++;
+	if (it->left[d] > 1 && it->k[d] < 255) {
+		unsigned char row = d ? it->password[d - 1] : 0;
+		unsigned char c = charsorted[row * 256 + ++it->k[d]];
+
+		it->password[d] = c;
+		it->level[d] = mkv_child_level(it, d, c);
+		it->left[d] -= MKV_NB(c, d + 1, it->level[d]);
+		mkv_descend(it);
+	} else {
+		it->password[d] = 0;
+		it->len = d;
+	}
+}
+
+void mkv_iter_init(struct mkv_iter *it, unsigned long long start,
+                   unsigned long long end)
+{
+	unsigned long long pos = start ? start - 1 : 0;
+	unsigned long long left = nbparts[0];
+	unsigned int d = 0;
+
+	it->idx = pos + 1;
+	it->end = end;
+	it->len = 0;
+	it->started = 0;
+	it->password[0] = 0;
+
+	/*
+	 * Each subtree holds all extensions of a prefix followed by the
+	 * prefix itself, so we can skip whole subtrees by their nbparts count.
+	 */
+	while (d < MAX_MKV_LEN) {
+		unsigned char row = d ? it->password[d - 1] : 0;
+		unsigned long long nb = 0;
+		unsigned int k;
+		int found = 0;
+
+		for (k = 0; k < 256 && left > 1; k++) {
+			unsigned char c = charsorted[row * 256 + k];
+			unsigned int level = mkv_child_level(it, d, c);
+
+			if (level > gmax_level)
+				break;
+			nb = MKV_NB(c, d + 1, level);
+			left -= nb;
+			if (pos < nb) {
+				it->k[d] = k;
+				it->password[d] = c;
+				it->level[d] = level;
+				it->left[d] = left;
+				found = 1;
+				break;
+			}
+			pos -= nb;
+		}
+		if (!found) {
+			it->len = 0;
+			it->password[0] = 0;
+			return;
+		}
+		it->len = d + 1;
+		it->password[it->len] = 0;
+		if (pos == nb - 1)
+			return;
+		left = nb;
+		d++;
+	}
+}
+
+char *mkv_iter_next(struct mkv_iter *it)
+{
+	if (it->started && it->len)
+		mkv_step(it);
+	it->started = 1;
+
+	while (it->len && it->idx <= it->end) {
+		if (it->len >= gmin_len && it->level[it->len - 1] >= gmin_level)
+			return (char *)it->password;
+		mkv_step(it);
+	}
+
+	return NULL;
+}
+
+int mkv_iter_fill(struct mkv_iter *it, struct mkv_block *block)
+{
+	char *pass;
+	int count = 0;
+
+	while (count < MKV_BLOCK_KEYS && (pass = mkv_iter_next(it))) {
+		block->idx[count] = it->idx;
+		memcpy(block->key[count], pass, it->len + 1);
+		count++;
+	}
+
+	return block->count = count;
+}
 
 static void stupidsort(unsigned char *result, unsigned char *source,
                        unsigned int size)
@@ -15,6 +15,33 @@ struct s_pwd {
 	unsigned char password[MAX_MKV_LEN + 1];
 };
 
+/*
+ * Iterative Markov enumerator.  Candidates come out in the same order as
+ * the recursive generator used to produce them (children in charsorted
+ * order, each prefix after all of its extensions).  Index N is the N-th
+ * candidate counting from 1; index 0 is treated as 1.  The walk state is an
+ * explicit stack, so it can stop after any candidate and can be positioned
+ * at any index directly from the nbparts table.
+ */
+struct mkv_iter {
+	unsigned long long idx;		/* index of the current candidate */
+	unsigned long long end;		/* last index to produce */
+	unsigned int len;		/* 0 when exhausted */
+	unsigned int started;
+	unsigned int k[MAX_MKV_LEN + 1];	/* position in parent's row */
+	unsigned int level[MAX_MKV_LEN + 1];
+	unsigned long long left[MAX_MKV_LEN + 1];	/* parent count left */
+	unsigned char password[MAX_MKV_LEN + 1];
+};
+
+#define MKV_BLOCK_KEYS			0x1000
+
+struct mkv_block {
+	int count;
+	unsigned long long idx[MKV_BLOCK_KEYS];
+	char key[MKV_BLOCK_KEYS][MAX_MKV_LEN + 1];
+};
+
 extern unsigned char *proba1;
 extern unsigned char *proba2;
 extern unsigned long long *nbparts;
@@ -34,4 +61,22 @@ void print_pwd(unsigned long long index, struct s_pwd *pwd,
 unsigned long long nb_parts(unsigned char lettre, unsigned int len,
                             unsigned int level, unsigned int max_lvl, unsigned int max_len);
 void init_probatables(char *filename);
+
+/*
+ * Positions the iterator at index start; it will stop after index end.
+ * The nbparts table must already be filled in by nb_parts().
+ */
+void mkv_iter_init(struct mkv_iter *it, unsigned long long start,
+                   unsigned long long end);
+
+/*
+ * Returns the next candidate that passes the min. length and level checks,
+ * or NULL when done.  Its index is left in it->idx.
+ */
+char *mkv_iter_next(struct mkv_iter *it);
+
+/*
+ * Fills up to MKV_BLOCK_KEYS candidates into block, returns their count.
+ */
+int mkv_iter_fill(struct mkv_iter *it, struct mkv_block *block);
 #endif
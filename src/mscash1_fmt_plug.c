@@ -323,16 +323,22 @@ static void nt_hash(int count)
 	}
 }
 
-static int crypt_all(int *pcount, struct db_salt *salt)
+/* The NT hash doesn't depend on the salt, so it's done once for all salts */
+static void precompute_keys(int count)
 {
-	int count = *pcount;
-	int i;
-
 	if (new_key)
 	{
 		new_key=0;
 		nt_hash(count);
 	}
+}
+
+static int crypt_all(int *pcount, struct db_salt *salt)
+{
+	int count = *pcount;
+	int i;
+
+	precompute_keys(count);
 
 #if MS_NUM_KEYS > 1 && defined(_OPENMP)
 #pragma omp parallel for default(none) private(i) shared(count, last, crypt_out, salt_buffer, output1x)
@@ -504,7 +510,16 @@ inline static void set_key_helper_utf8(unsigned int * keybuffer, unsigned int xB
 {
 	unsigned int *target = keybuffer;
 	UTF32 chl, chh = 0x80;
-	unsigned int outlen = 0;
+	unsigned int outlen;
+
+	outlen = utf8_ascii_to_utf16_words(target, xBuf, source,
+	                                   strlen((char*)source),
+	                                   PLAINTEXT_LENGTH - 1);
+	if (outlen) {
+		source += outlen;
+		target += outlen / 2 * xBuf;
+		chh = 0; /* not a terminator */
+	}
 
 	while (*source) {
 		chl = *source;
@@ -784,7 +799,8 @@ struct fmt_main fmt_mscash = {
 		},
 		cmp_all,
 		cmp_one,
-		cmp_exact
+		cmp_exact,
+		precompute_keys
 	}
 };
 
@@ -53,6 +53,8 @@ void mscash1_adjust_tests(struct fmt_main *self, unsigned target_encoding,
 		mscash1_common_tests[1].plaintext = "\xC3\xBC";         // German u-umlaut in UTF-8
 		mscash1_common_tests[2].ciphertext = "M$user#9121790702dda0fa5d353014c334c2ce";
 		mscash1_common_tests[2].plaintext = "\xe2\x82\xac\xe2\x82\xac"; // 2 x Euro signs
+		mscash1_common_tests[3].ciphertext = "M$user#9c4f3f846594efc7bbed1ae5716aec61";
+		mscash1_common_tests[3].plaintext = "John the Ripper \xe2\x82\xac"; // ASCII run and Euro sign
 	} else if (target_encoding == ASCII || target_encoding == ISO_8859_1) {
 		mscash1_common_tests[1].ciphertext = "M$\xFC#48f84e6f73d6d5305f6558a33fa2c9bb";
 		mscash1_common_tests[1].plaintext = "\xFC";         // German u-umlaut in ISO_8859_1
@@ -22,7 +22,7 @@ john_register_one(&fmt_netah);
 #endif
 
 #include "formats.h"
-#include "hmacmd5.h"
+#include "md5.h"
 #include "misc.h"
 #include "common.h"
 #include "params.h"
@@ -56,6 +56,8 @@ static struct fmt_tests tests[] = {
 
 static char (*saved_key)[PLAINTEXT_LENGTH + 1];
 static uint32_t (*crypt_out)[BINARY_SIZE_ALLOC / sizeof(uint32_t)];
+static MD5_CTX *ipad_ctx, *opad_ctx;
+static int new_keys;
 
 static struct custom_salt {
 	uint32_t length;
@@ -73,10 +75,14 @@ static void init(struct fmt_main *self)
 #endif
 	saved_key = mem_calloc(sizeof(*saved_key), self->params.max_keys_per_crypt);
 	crypt_out = mem_calloc(sizeof(*crypt_out), self->params.max_keys_per_crypt);
+	ipad_ctx = mem_calloc(sizeof(*ipad_ctx), self->params.max_keys_per_crypt);
+	opad_ctx = mem_calloc(sizeof(*opad_ctx), self->params.max_keys_per_crypt);
 }
 
 static void done(void)
 {
+        MEM_FREE(opad_ctx);
+        MEM_FREE(ipad_ctx);
         MEM_FREE(saved_key);
         MEM_FREE(crypt_out);
 }
@@ -160,21 +166,60 @@ static void set_salt(void *salt)
 	cur_salt = (struct custom_salt *)salt;
 }
 
+/*
+ * The HMAC key pads only depend on the key (never longer than a block here),
+ * so their MD5 states are computed once and reused for all salts.
+ */
+static void precompute_keys(int count)
+{
+	int index = 0;
+
+	if (!new_keys)
+		return;
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+	for (index = 0; index < count; index++)
+	{
+		unsigned char ipad[64], opad[64];
+		int i, len = strlen(saved_key[index]);
+
+		memset(ipad, 0x36, sizeof(ipad));
+		memset(opad, 0x5c, sizeof(opad));
+		for (i = 0; i < len; i++) {
+			ipad[i] ^= saved_key[index][i];
+			opad[i] ^= saved_key[index][i];
+		}
+		MD5_Init(&ipad_ctx[index]);
+		MD5_Update(&ipad_ctx[index], ipad, sizeof(ipad));
+		MD5_Init(&opad_ctx[index]);
+		MD5_Update(&opad_ctx[index], opad, sizeof(opad));
+	}
+	new_keys = 0;
+}
+
 static int crypt_all(int *pcount, struct db_salt *salt)
 {
 	const int count = *pcount;
 	int index = 0;
 
+	precompute_keys(count);
+
 #ifdef _OPENMP
 #pragma omp parallel for
 #endif
 	for (index = 0; index < count; index++)
 	{
-		HMACMD5Context ctx;
+		MD5_CTX ctx;
+
+		memcpy(&ctx, &ipad_ctx[index], sizeof(ctx));
+		MD5_Update(&ctx, cur_salt->salt, cur_salt->length);
+		MD5_Final((unsigned char*)crypt_out[index], &ctx);
 
-		hmac_md5_init_rfc2104((const unsigned char*)saved_key[index], strlen(saved_key[index]), &ctx);
-		hmac_md5_update(cur_salt->salt, cur_salt->length, &ctx);
-		hmac_md5_final((unsigned char*)crypt_out[index], &ctx);
+		memcpy(&ctx, &opad_ctx[index], sizeof(ctx));
+		MD5_Update(&ctx, crypt_out[index], 16);
+		MD5_Final((unsigned char*)crypt_out[index], &ctx);
 	}
 
 	return count;
@@ -206,6 +251,7 @@ static void netah_set_key(char *key, int index)
                 saved_len = PLAINTEXT_LENGTH;
         memcpy(saved_key[index], key, saved_len);
         saved_key[index][saved_len] = 0;
+        new_keys = 1;
 }
 
 static char *get_key(int index)
@@ -258,7 +304,8 @@ struct fmt_main fmt_netah = {
 		},
 		cmp_all,
 		cmp_one,
-		cmp_exact
+		cmp_exact,
+		precompute_keys
 	}
 };
 
@@ -196,6 +196,9 @@ static void init(struct fmt_main *self)
 		tests[3].ciphertext = "$NT$030926b781938db4365d46adc7cfbcb8";
 		tests[4].plaintext = "\xE2\x82\xAC\xE2\x82\xAC";
 		tests[4].ciphertext = "$NT$682467b963bb4e61943e170a04f7db46";
+		/* long enough ASCII start for the widening fast path */
+		tests[5].plaintext = "John the Ripper \xE2\x82\xAC";
+		tests[5].ciphertext = "$NT$9390c933302019cd55480591a3308c00";
 	} else {
 		if (options.target_enc != ASCII && options.target_enc != ISO_8859_1) {
 			/* This avoids an if clause for every set_key */
@@ -431,7 +434,15 @@ static void set_key_utf8(char *_key, int index)
 	const UTF8 *source = (UTF8*)_key;
 	unsigned int *keybuf_word = buf_ptr[index];
 	UTF32 chl, chh = 0x80;
-	unsigned int len = 0;
+	unsigned int len;
+
+	len = utf8_ascii_to_utf16_words(keybuf_word, SIMD_COEF_32, source,
+	                                strlen(_key), PLAINTEXT_LENGTH - 1);
+	if (len) {
+		source += len;
+		keybuf_word += len / 2 * SIMD_COEF_32;
+		chh = 0; /* not a terminator */
+	}
 
 	while (*source) {
 		chl = *source;
@@ -689,6 +700,25 @@ static int get_hash_5(int index) { return ((uint32_t*)crypt_key)[1] & PH_MASK_5;
 static int get_hash_6(int index) { return ((uint32_t*)crypt_key)[1] & PH_MASK_6; }
 #endif
 
+static void get_hash_batch(int size, int count, unsigned int *out)
+{
+	uint32_t mask = password_hash_sizes[size] - 1;
+#ifdef SIMD_COEF_32
+	uint32_t *key = (uint32_t*)crypt_key + SIMD_COEF_32;
+	int index, j;
+
+	/* whole vectors, out[] has room for max_keys_per_crypt */
+	for (index = 0; index < count; index += SIMD_COEF_32) {
+		for (j = 0; j < SIMD_COEF_32; j++)
+			out[index + j] = key[j] & mask;
+		key += 4 * SIMD_COEF_32;
+	}
+#else
+	if (count)
+		out[0] = ((uint32_t*)crypt_key)[1] & mask;
+#endif
+}
+
 static int binary_hash_0(void * binary) { return ((uint32_t*)binary)[1] & PH_MASK_0; }
 static int binary_hash_1(void * binary) { return ((uint32_t*)binary)[1] & PH_MASK_1; }
 static int binary_hash_2(void * binary) { return ((uint32_t*)binary)[1] & PH_MASK_2; }
@@ -757,7 +787,9 @@ struct fmt_main fmt_NT2 = {
 		},
 		cmp_all,
 		cmp_one,
-		cmp_exact
+		cmp_exact,
+		NULL,
+		get_hash_batch
 	}
 };
 
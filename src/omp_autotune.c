@@ -0,0 +1,249 @@
+/*
+ * This file is part of John the Ripper password cracker.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted.
+ *
+ * There's ABSOLUTELY NO WARRANTY, express or implied.
+ */
+
+/*
+ * CPU formats scale max_keys_per_crypt by a hard-coded OMP_SCALE in their
+ * init(), which is only right for some core counts and cache sizes.  The
+ * key buffers are allocated for that size, so we can't go larger, but we
+ * can use a smaller batch if that is faster on this host.
+ */
+
+#include "os.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "arch.h"
+#include "misc.h"
+#include "params.h"
+#include "memory.h"
+#include "formats.h"
+#include "loader.h"
+#include "logger.h"
+#include "config.h"
+#include "options.h"
+#include "signals.h"
+#include "path.h"
+#include "timer.h"
+#include "omp_autotune.h"
+#include "memdbg.h"
+
+#ifdef _OPENMP
+/*
+ * Cache entries are "host format threads processes default_keys keys", so
+ * a change of any of these (e.g. OMP_SCALE in a format) makes us measure
+ * again.
+ */
+static void omp_autotune_key(char *key, size_t size,
+	struct fmt_main *format)
+{
+	char host[128] = "localhost";
+
+#if HAVE_UNISTD_H
+	if (gethostname(host, sizeof(host)) || !*host)
+		strcpy(host, "localhost");
+	host[sizeof(host) - 1] = 0;
+#endif
+	snprintf(key, size, "%s %s %d %d %u", host, format->params.label,
+	         omp_get_max_threads(), options.fork ? options.fork : 1,
+	         format->params.max_keys_per_crypt);
+}
+
+static int omp_autotune_load(char *key)
+{
+	FILE *file;
+	char line[LINE_BUFFER_SIZE];
+	size_t len = strlen(key);
+	int keys = 0;
+
+	if (!(file = fopen(path_expand(OMP_AUTOTUNE_NAME), "r")))
+		return 0;
+
+/* Later entries override earlier ones */
+	while (fgets(line, sizeof(line), file))
+		if (!strncmp(line, key, len) && line[len] == ' ')
+			keys = atoi(&line[len + 1]);
+
+	fclose(file);
+
+	return keys;
+}
+
+/*
+ * Rewrites the cache with this entry replacing any older one for the key.
+ * Forked or concurrent sessions may tune at the same time, so the new file is
+ * written under a name of our own and renamed into place: readers see either
+ * file whole, and at worst one session's entry is lost and measured again.
+ */
+static void omp_autotune_save(char *key, int keys)
+{
+	FILE *in, *out;
+	char name[PATH_BUFFER_SIZE], tmp_name[PATH_BUFFER_SIZE + 16];
+	char line[LINE_BUFFER_SIZE];
+	size_t len = strlen(key);
+	int ok;
+
+	strnzcpy(name, path_expand(OMP_AUTOTUNE_NAME), sizeof(name));
+	snprintf(tmp_name, sizeof(tmp_name), "%s.%u", name,
+	         (unsigned int)getpid());
+
+/* The cache is just a convenience, so we don't complain if we can't write */
+	if (!(out = fopen(tmp_name, "w")))
+		return;
+
+	if ((in = fopen(name, "r"))) {
+		while (fgets(line, sizeof(line), in))
+			if (strncmp(line, key, len) || line[len] != ' ')
+				fputs(line, out);
+		fclose(in);
+	}
+
+	fprintf(out, "%s %d\n", key, keys);
+	ok = !ferror(out);
+	if (fclose(out))
+		ok = 0;
+
+#if defined (__MINGW32__) || defined (_MSC_VER)
+	if (ok)
+		unlink(name);
+#endif
+	if (!ok || rename(tmp_name, name))
+		unlink(tmp_name);
+}
+
+static double omp_autotune_now(void)
+{
+	hr_timer t;
+
+	HRSETCURRENT(t);
+	return HRGETTICKS(t);
+}
+
+/*
+ * Returns crypts per tick for batches of the given size.  If call is not
+ * NULL, also returns the duration of the first crypt_all() call.
+ */
+static double omp_autotune_rate(struct fmt_main *format,
+	struct db_main *db, int keys, double tps, double *call)
+{
+	struct fmt_tests *test = format->params.tests;
+	double start, end;
+	unsigned long long done = 0;
+	int index;
+
+	format->methods.clear_keys();
+	for (index = 0; index < keys; index++) {
+		if (!test->ciphertext)
+			test = format->params.tests;
+		format->methods.set_key(test->plaintext, index);
+		test++;
+	}
+
+	start = omp_autotune_now();
+	do {
+		int count = keys;
+
+		format->methods.crypt_all(&count, db->salts);
+		done += count;
+		end = omp_autotune_now();
+		if (call) {
+			*call = end - start;
+			call = NULL;
+		}
+	} while (end - start < OMP_AUTOTUNE_TIME * tps / 1000 && !event_abort);
+
+	return done / (end - start);
+}
+#endif
+
+void omp_autotune(struct fmt_main *format)
+{
+#ifdef _OPENMP
+	struct db_main *db;
+	char key[LINE_BUFFER_SIZE];
+	unsigned int min = format->params.min_keys_per_crypt;
+	unsigned int max = format->params.max_keys_per_crypt;
+	unsigned int keys, best;
+	double tps, call, rate, best_rate;
+	extern volatile int bench_running;
+
+/* OpenCL formats set FMT_OMP for their host side code, but have their own
+ * auto-tuning of the global work size that max_keys_per_crypt comes from */
+	if (!(format->params.flags & FMT_OMP) ||
+	    strstr(format->params.label, "-opencl") || options.force_maxkeys ||
+	    !format->params.tests || !min || max / min < 2 ||
+	    !cfg_get_bool(SECTION_OPTIONS, NULL, "OMPAutoTune", 1))
+		return;
+
+	omp_autotune_key(key, sizeof(key), format);
+
+	if ((best = omp_autotune_load(key))) {
+		if (best < min || best > max || best % min)
+			best = 0;
+		else
+			log_event("- OpenMP auto-tune: using cached %u keys "
+			          "per crypt", best);
+	}
+
+	if (!best) {
+		if (!(db = ldr_init_test_db(format, NULL)))
+			return;
+		if (!db->salts) {
+			ldr_free_test_db(db);
+			return;
+		}
+
+		HRGETTICKS_PER_SEC(tps);
+		bench_running++;
+		format->methods.set_salt(db->salts->salt);
+		best = max;
+		best_rate = omp_autotune_rate(format, db, max, tps, &call);
+
+/*
+ * Formats this slow get all their parallelism from a full batch anyway,
+ * and measuring smaller ones would delay startup too much.
+ */
+		if (call <= OMP_AUTOTUNE_MAX_CALL * tps / 1000)
+		for (keys = max / 2 / min * min; keys >= min && !event_abort;
+		     keys = keys / 2 / min * min) {
+			rate = omp_autotune_rate(format, db, keys, tps, NULL);
+/* Don't give up on a larger batch for what might just be noise */
+			if (rate > best_rate * 1.02) {
+				best = keys;
+				best_rate = rate;
+			}
+		}
+
+		format->methods.clear_keys();
+		bench_running--;
+		ldr_free_test_db(db);
+
+		if (event_abort)
+			return;
+
+		omp_autotune_save(key, best);
+		log_event("- OpenMP auto-tune: %u keys per crypt (default %u)",
+		          best, max);
+	}
+
+	if (best != max && options.verbosity > VERB_DEFAULT)
+		fprintf(stderr, "OpenMP auto-tune: %u keys per crypt "
+		        "(default %u)\n", best, max);
+
+	format->params.max_keys_per_crypt = best;
+#endif
+}
@@ -0,0 +1,28 @@
+/*
+ * This file is part of John the Ripper password cracker.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted.
+ *
+ * There's ABSOLUTELY NO WARRANTY, express or implied.
+ */
+
+/*
+ * Auto-tuning of the batch size for OpenMP-enabled CPU formats.
+ */
+
+#ifndef _JOHN_OMP_AUTOTUNE_H
+#define _JOHN_OMP_AUTOTUNE_H
+
+#include "formats.h"
+
+/*
+ * Times crypt_all() on the format's test vectors for max_keys_per_crypt
+ * and smaller batch sizes (multiples of min_keys_per_crypt), and lowers
+ * max_keys_per_crypt to the fastest one.  Results are cached per host,
+ * format, thread and process count so later sessions don't measure again.
+ * The format must be initialized.  Does nothing unless built with OpenMP.
+ */
+extern void omp_autotune(struct fmt_main *format);
+
+#endif
@@ -241,6 +241,7 @@ static void release_clobj(void)
 
 static void done(void)
 {
+	stage_batch_done(&batch);
 	if (autotuned) {
 		release_clobj();
 
@@ -291,6 +292,8 @@ static void init(struct fmt_main *_self)
 		CRC32_t crc;
 		CRC32_Init(&crc);
 	}
+
+	stage_batch_init(&batch, "RAR", stage_names, 0, sizeof(AES_KEY));
 }
 
 static void reset(struct db_main *db)
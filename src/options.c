@@ -59,7 +59,7 @@
 struct options_main options;
 static char *field_sep_char_str, *show_uncracked_str, *salts_str;
 static char *encoding_str, *target_enc_str, *internal_cp_str;
-static char *costs_str;
+static char *costs_str, *test_str;
 
 static struct opt_entry opt_list[] = {
 	{"", FLG_PASSWD, 0, 0, 0, OPT_FMT_ADD_LIST, &options.passwd},
@@ -170,7 +170,7 @@ static struct opt_entry opt_list[] = {
 	{"test", FLG_TEST_SET, FLG_TEST_CHK,
 		0, ~FLG_TEST_SET & ~FLG_FORMAT & ~FLG_SAVEMEM & ~FLG_DYNFMT &
 		~FLG_MASK_CHK & ~FLG_NOLOG & ~OPT_REQ_PARAM,
-		"%d", &benchmark_time},
+		OPT_FMT_STR_ALLOC, &test_str},
 	{"test-full", FLG_TEST_SET, FLG_TEST_CHK,
 		0, ~FLG_TEST_SET & ~FLG_FORMAT & ~FLG_SAVEMEM & ~FLG_DYNFMT &
 		OPT_REQ_PARAM & ~FLG_NOLOG, "%d", &benchmark_level},
@@ -238,6 +238,8 @@ static struct opt_entry opt_list[] = {
 		"%d", &options.max_run_time},
 	{"progress-every", FLG_ZERO, 0, FLG_CRACKING_CHK, OPT_REQ_PARAM,
 		"%u", &options.status_interval},
+	{"status-file-every", FLG_ZERO, 0, FLG_CRACKING_CHK, OPT_REQ_PARAM,
+		"%u", &options.status_file_interval},
 	{"regen-lost-salts", FLG_ZERO, 0, FLG_CRACKING_CHK, OPT_REQ_PARAM,
 		OPT_FMT_STR_ALLOC, &regen_salts_options},
 	{"bare-always-valid", FLG_ZERO, 0, 0, OPT_REQ_PARAM,
@@ -257,6 +259,10 @@ static struct opt_entry opt_list[] = {
 	{"skip-self-tests", FLG_NOTESTS, FLG_NOTESTS},
 	{"costs", FLG_ZERO, 0, 0, OPT_REQ_PARAM,
                 OPT_FMT_STR_ALLOC, &costs_str},
+	{"bench-output", FLG_ZERO, 0, FLG_TEST_CHK, OPT_REQ_PARAM,
+		OPT_FMT_STR_ALLOC, &options.bench_output},
+	{"bench-compare", FLG_ZERO, 0, FLG_TEST_CHK, OPT_REQ_PARAM,
+		OPT_FMT_STR_ALLOC, &options.bench_compare},
 
 	{"keep-guessing", FLG_KEEP_GUESSING, FLG_KEEP_GUESSING},
 	{"stress-test", FLG_LOOPTEST | FLG_TEST_SET, FLG_TEST_CHK,
@@ -325,6 +331,9 @@ JOHN_USAGE_REGEX \
 "--make-charset=FILE        make a charset file. It will be overwritten\n" \
 "--show[=left]              show cracked passwords [if =left, then uncracked]\n" \
 "--test[=TIME]              run tests and benchmarks for TIME seconds each\n" \
+"--test=pipeline[:HASHES[:TIME]] benchmark the whole cracking pipeline\n" \
+"                           (rules, set_key, crypt_all, compare) against\n" \
+"                           HASHES loaded hashes, with a per-stage breakdown\n" \
 "--users=[-]LOGIN|UID[,..]  [do not] load this (these) user(s) only\n" \
 "--groups=[-]GID[,..]       load users [not] of this (these) group(s) only\n" \
 "--shells=[-]SHELL[,..]     load users with[out] this (these) shell(s) only\n" \
@@ -394,6 +403,7 @@ void opt_print_hidden_usage(void)
 	puts("--bare-always-valid=C      if C is 'Y' or 'y', then the dynamic format will");
 	puts("                           always treat bare hashes as valid");
 	puts("--progress-every=N         emit a status line every N seconds");
+	puts("--status-file-every=N      write a JSON status file every N seconds");
 	puts("--crack-status             emit a status line whenever a password is cracked");
 	puts("--keep-guessing            try more candidates for cracked hashes (ie. search");
 	puts("                           for plaintext collisions)");
@@ -413,6 +423,11 @@ void opt_print_hidden_usage(void)
 	puts("--skip-self-tests          skip self tests");
 	puts("--test-full[=LEVEL]        run more thorough self-tests");
 	puts("--stress-test[=TIME]       loop self tests forever");
+	puts("--bench-output=FILE        write benchmark results to FILE, as CSV if");
+	puts("                           it ends in .csv, as JSON otherwise");
+	puts("--bench-compare=FILE       compare benchmark results with FILE (as");
+	puts("                           written by --bench-output), fail on");
+	puts("                           regressions");
 #ifdef HAVE_FUZZ
 	puts("--fuzz[=DICTFILE]          fuzz formats' prepare(), valid() and split()");
 	puts("--fuzz-dump[=FROM,TO]      dump the fuzzed hashes between FROM and TO to file pwfile.format");
@@ -476,6 +491,27 @@ void opt_init(char *name, int argc, char **argv, int show_usage)
 
 	opt_process(opt_list, &options.flags, argv);
 
+	if ((options.flags & FLG_TEST_CHK) && test_str) {
+		if (!strncasecmp(test_str, "pipeline", 8)) {
+			benchmark_pipeline = BENCHMARK_PIPELINE_HASHES;
+			if (test_str[8] && (test_str[8] != ':' ||
+			    sscanf(&test_str[9], "%d:%d", &benchmark_pipeline,
+			           &benchmark_time) < 1 ||
+			    benchmark_pipeline < 0)) {
+				fprintf(stderr, "Invalid --test=pipeline value\n");
+				error();
+			}
+			if (options.flags & FLG_MASK_CHK) {
+				fprintf(stderr, "The pipeline benchmark only supports "
+				        "wordlist rules, not mask\n");
+				error();
+			}
+		} else if (sscanf(test_str, "%d", &benchmark_time) != 1) {
+			fprintf(stderr, "Invalid --test value: %s\n", test_str);
+			error();
+		}
+	}
+
 #if HAVE_REXGEN
 	/* We allow regex as parent for hybrid mask, not vice versa */
 	if ((options.flags & FLG_REGEX_CHK) && (options.flags & FLG_MASK_CHK)) {
@@ -239,6 +239,12 @@ struct options_main {
 /* Configuration file name */
 	char *config;
 
+/* Benchmark results file to write (--bench-output) */
+	char *bench_output;
+
+/* Benchmark results file to compare against (--bench-compare) */
+	char *bench_compare;
+
 /* Markov stuff */
 	char *mkv_param;
 	char *mkv_stats;
@@ -346,6 +352,9 @@ struct options_main {
 /* Emit a status line every N seconds */
 	int status_interval;
 
+/* Write a JSON status file every N seconds */
+	int status_file_interval;
+
 /* Resync pot file when saving */
 	int reload_at_save;
 
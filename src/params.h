@@ -141,11 +141,34 @@
  */
 #define BENCHMARK_TIME			1
 
+/*
+ * Default number of loaded hashes for the --test=pipeline benchmark.
+ */
+#define BENCHMARK_PIPELINE_HASHES	1000000
+
+/*
+ * Minimum time in milliseconds to spend timing each batch size when
+ * auto-tuning OpenMP formats, and the time a single crypt_all() call of
+ * the format's default batch size may take for us to bother at all.
+ */
+#define OMP_AUTOTUNE_TIME		100
+#define OMP_AUTOTUNE_MAX_CALL		500
+
 /*
  * Number of salts to assume when benchmarking.
  */
 #define BENCHMARK_MANY			0x100
 
+/*
+ * Set this to 1 to count events on the cracker's hot path (candidates,
+ * rejected by rules, crypts, bitmap probes and hits, cmp_one() and
+ * cmp_exact() calls, guesses).  The counts are shown on status lines and
+ * logged at exit.  With 0, the counting is compiled out completely.
+ */
+#ifndef STATUS_COUNTERS
+#define STATUS_COUNTERS			0
+#endif
+
 /*
  * File names.
  */
@@ -158,14 +181,19 @@
 #define SEC_POT_NAME			JOHN_PRIVATE_HOME "/secure.pot"
 #define LOG_NAME			JOHN_PRIVATE_HOME "/john.log"
 #define RECOVERY_NAME			JOHN_PRIVATE_HOME "/john"
+#define OMP_AUTOTUNE_NAME		JOHN_PRIVATE_HOME "/john.omp"
+#define PMK_CACHE_NAME			JOHN_PRIVATE_HOME "/john.pmk"
 #else
 #define POT_NAME			"$JOHN/john.pot"
 #define SEC_POT_NAME			"$JOHN/secure.pot"
 #define LOG_NAME			"$JOHN/john.log"
 #define RECOVERY_NAME			"$JOHN/john"
+#define OMP_AUTOTUNE_NAME		"$JOHN/john.omp"
+#define PMK_CACHE_NAME			"$JOHN/john.pmk"
 #endif
 #define LOG_SUFFIX			".log"
 #define RECOVERY_SUFFIX			".rec"
+#define STATUS_SUFFIX			".status"
 #define WORDLIST_NAME			"$JOHN/password.lst"
 
 /*
@@ -250,6 +278,15 @@ extern unsigned int password_hash_thresholds[PASSWORD_HASH_SIZES];
 #define PASSWORD_HASH_SHR		2
 #endif
 
+/*
+ * Size in bits of a small bitmap the cracker checks before a salt's own, so
+ * that most misses are rejected while still in cache, or 0 for none.  It is
+ * only built for salts with a larger bitmap and at most the threshold number
+ * of hashes, as with more than that it would be mostly ones.
+ */
+#define PASSWORD_HASH_FILTER_SIZE	0x200000
+#define PASSWORD_HASH_FILTER_THRESHOLD	(PASSWORD_HASH_FILTER_SIZE / 2)
+
 /*
  * Cracked password hash size, used while loading.
  */
@@ -311,11 +348,27 @@ extern unsigned int password_hash_thresholds[PASSWORD_HASH_SIZES];
 #define CRK_PREFETCH			0
 #endif
 
+/*
+ * Default time in seconds that one batch of candidates may take to go through
+ * all loaded salts before the cracker makes its batches smaller (down to the
+ * format's min_keys_per_crypt, and only while that costs little speed per
+ * candidate).  Status, restore points and candidate counts
+ * are only brought up to date between batches.  Can be changed with
+ * SaltPassTime in john.conf, where 0 disables this.
+ */
+#define CRK_PASS_TIME			10
+
 /*
  * Maximum number of GECOS words to try in pairs.
  */
 #define SINGLE_WORDS_PAIR_MAX		6
 
+/*
+ * Maximum total size of the per-salt "single crack" mode key buffers, in MB.
+ * The buffers are grown towards max_keys_per_crypt for as long as they fit.
+ */
+#define SINGLE_MAX_BUFFER_SIZE		256
+
 /*
  * Charset parameters.
  *
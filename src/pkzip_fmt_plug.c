@@ -38,6 +38,7 @@ john_register_one(&fmt_pkzip);
 
 #include "pkzip_inffixed.h"  // This file is a data file, taken from zlib
 #include "loader.h"
+#include "stage_stats.h"
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -165,6 +166,8 @@ static u32  *K12;
 static PKZ_SALT *salt;
 static u8 *chk;
 static int dirty=1;
+static struct stage_stats stats;
+static const char *stage_names[] = { "checksum", "inflate", "CRC", NULL };
 #if USE_PKZIP_MAGIC
 static ZIP_SIGS SIGS[256];
 #endif
@@ -409,6 +412,7 @@ static void init(struct fmt_main *self)
 	saved_key = mem_calloc(sizeof(*saved_key), self->params.max_keys_per_crypt);
 	K12 = mem_calloc(sizeof(*K12) * 3, self->params.max_keys_per_crypt);
 	chk = mem_calloc(sizeof(*chk), self->params.max_keys_per_crypt);
+	stage_stats_init(&stats, "PKZIP", stage_names);
 
 	/*
 	 * Precompute the multiply mangling, within several parts of the hash. There is a pattern,
@@ -523,6 +527,7 @@ static void init(struct fmt_main *self)
 
 static void done(void)
 {
+	stage_stats_done(&stats);
 	MEM_FREE(chk);
 	MEM_FREE(K12);
 	MEM_FREE(saved_key);
@@ -915,7 +920,7 @@ static int cmp_exact_loadfile(int index)
 	return ret == Z_STREAM_END && inp_used == salt->compLen && decomp_len == salt->deCompLen && salt->crc32 == ~crc;
 }
 
-static int cmp_exact(char *source, int index)
+static int cmp_exact_full(int index)
 {
 	const u8 *b;
 	u8 C, *decompBuf, *decrBuf, *B;
@@ -1008,6 +1013,14 @@ static int cmp_exact(char *source, int index)
 	return cmp_exact_loadfile(index);
 }
 
+static int cmp_exact(char *source, int index)
+{
+	if (!cmp_exact_full(index))
+		return 0;
+	stage_stats_pass(&stats, 2);
+	return 1;
+}
+
 #if USE_PKZIP_MAGIC
 const char exBytesUTF8[64] = {
 	1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1, 1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
@@ -1467,6 +1480,9 @@ static int crypt_all(int *pcount, struct db_salt *_salt)
 				goto Failed_Bailout;
 #endif
 
+			if (!cur_hash_idx)
+				stage_stats_pass(&stats, 0);
+
 			// Now, update the key data (with that last byte.
 			key0.u = jtr_crc32 (key0.u, C);
 			key1.u = (key1.u + key0.c[KB1]) * 134775813 + 1;
@@ -1705,6 +1721,7 @@ static int crypt_all(int *pcount, struct db_salt *_salt)
 		/* We load the proper checksum value for the gethash */
 	KnownSuccess: ;
 		chk[idx] = 1;
+		stage_stats_pass(&stats, 1);
 
 		continue;
 
@@ -1716,6 +1733,7 @@ static int crypt_all(int *pcount, struct db_salt *_salt)
 	/* clear the 'dirty' flag.  Then on multiple different salt calls, we will not have to */
 	/* encrypt the passwords again. They will have already been loaded in the K12[] array. */
 	dirty = 0;
+	STAGE_STATS_TRY(&stats, _count);
 
 	return _count;
 }
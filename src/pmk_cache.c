@@ -0,0 +1,425 @@
+/*
+ * This file is part of John the Ripper password cracker.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted.
+ *
+ * There's ABSOLUTELY NO WARRANTY, express or implied.
+ */
+
+#ifndef __FreeBSD__
+#if _XOPEN_SOURCE < 500
+#undef _XOPEN_SOURCE
+#define _XOPEN_SOURCE 500 /* for fileno(3), ftruncate(2) */
+#endif
+#endif
+
+#define NEED_OS_FLOCK
+#include "os.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#if (!AC_BUILT || HAVE_UNISTD_H) && !_MSC_VER
+#include <unistd.h>
+#endif
+#if !AC_BUILT || HAVE_SYS_FILE_H
+#include <sys/file.h>
+#endif
+#if (!AC_BUILT || HAVE_FCNTL_H)
+#include <fcntl.h>
+#endif
+#ifdef _MSC_VER
+#include <io.h>
+#endif
+
+#if _MSC_VER || __MINGW32__ || __MINGW64__ || __CYGWIN__ || HAVE_WINDOWS_H
+#include "win32_memmap.h"
+#undef MEM_FREE
+#if !defined(__CYGWIN__) && !defined(__MINGW64__)
+#include "mmap-windows.c"
+#endif
+#endif
+
+#if defined(HAVE_MMAP)
+#include <sys/mman.h>
+#endif
+
+#include "arch.h"
+#include "jumbo.h"
+#include "misc.h"
+#include "memory.h"
+#include "pmk_cache.h"
+#include "memdbg.h"
+
+/* Records we buffer before appending them to the file */
+#define PMK_CACHE_BUFFER		0x400
+
+static struct {
+	char *name;
+	FILE *file;
+	char *map;
+	int64_t map_size;
+	struct pmk_record *mapped;
+	uint32_t mapped_count;
+/* Records not yet flushed, numbered on from mapped_count */
+	struct pmk_record *added;
+	uint32_t added_count;
+/* Open addressing, entries are record numbers plus 1 */
+	uint32_t *table;
+	uint32_t table_mask, count;
+} cache;
+
+static struct pmk_record *pmk_cache_record(uint32_t n)
+{
+	if (n < cache.mapped_count)
+		return &cache.mapped[n];
+	return &cache.added[n - cache.mapped_count];
+}
+
+/* FNV-1a over the zero padded ESSID and key */
+static uint32_t pmk_cache_hash(const struct pmk_record *rec)
+{
+	const unsigned char *p = rec->essid;
+	const unsigned char *end = rec->key + PMK_CACHE_KEY_LEN;
+	uint32_t hash = 2166136261U;
+
+	while (p < end)
+		hash = (hash ^ *p++) * 16777619U;
+
+	return hash;
+}
+
+static void pmk_cache_insert(uint32_t n)
+{
+	uint32_t i = pmk_cache_hash(pmk_cache_record(n)) & cache.table_mask;
+
+	while (cache.table[i])
+		i = (i + 1) & cache.table_mask;
+	cache.table[i] = n + 1;
+}
+
+static void pmk_cache_grow(void)
+{
+	uint32_t *old = cache.table, size = cache.table_mask + 1, i;
+
+	cache.table = mem_calloc(size << 1, sizeof(*cache.table));
+	cache.table_mask = (size << 1) - 1;
+	for (i = 0; i < size; i++)
+		if (old[i])
+			pmk_cache_insert(old[i] - 1);
+	MEM_FREE(old);
+}
+
+/*
+ * Maps the first size bytes of the file, which must be whole records,
+ * in place of what we had mapped before.
+ */
+static int pmk_cache_map(FILE *file, int64_t size)
+{
+#ifdef HAVE_MMAP
+	char *map = NULL;
+
+	if (size > PMK_CACHE_MAGIC_LEN) {
+		map = mmap(NULL, size, PROT_READ, MAP_SHARED, fileno(file), 0);
+		if (map == MAP_FAILED) {
+			fprintf(stderr, "PMK cache: %s: memory mapping failed "
+			        "(%s)\n", cache.name, strerror(errno));
+			return -1;
+		}
+	}
+	if (cache.map)
+		munmap(cache.map, cache.map_size);
+	cache.map = map;
+#else
+	if (size > cache.map_size) {
+		cache.map = mem_realloc(cache.map, size);
+		cache.mapped = (struct pmk_record *)
+			(cache.map + PMK_CACHE_MAGIC_LEN);
+		jtr_fseek64(file, cache.map_size, SEEK_SET);
+		if (fread(cache.map + cache.map_size, size - cache.map_size,
+		          1, file) != 1) {
+			fprintf(stderr, "PMK cache: %s: read error\n",
+			        cache.name);
+			return -1;
+		}
+	}
+#endif
+	cache.map_size = size;
+	cache.mapped = cache.map ?
+		(struct pmk_record *)(cache.map + PMK_CACHE_MAGIC_LEN) : NULL;
+
+	return 0;
+}
+
+/*
+ * Exclusive lock for writing to the file, taken while we create the magic
+ * and while we append, so that only one process at a time may find (and
+ * repair) a partial record at the end.
+ */
+static void pmk_cache_lock(FILE *file, int lock)
+{
+#if FCNTL_LOCKS
+	struct flock fl;
+
+	memset(&fl, 0, sizeof(fl));
+	fl.l_type = lock ? F_WRLCK : F_UNLCK;
+	while (fcntl(fileno(file), lock ? F_SETLKW : F_SETLK, &fl)) {
+		if (errno != EINTR)
+			pexit("fcntl(%s)", lock ? "F_WRLCK" : "F_UNLCK");
+	}
+#elif OS_FLOCK
+	while (flock(fileno(file), lock ? LOCK_EX : LOCK_UN)) {
+		if (errno != EINTR)
+			pexit("flock(%s)", lock ? "LOCK_EX" : "LOCK_UN");
+	}
+#endif
+}
+
+static int pmk_cache_setup(struct pmk_record *rec, const char *essid,
+	const unsigned char *key, int length)
+{
+	size_t essid_len = strlen(essid);
+
+	if (essid_len > PMK_CACHE_ESSID_LEN || length > PMK_CACHE_KEY_LEN ||
+	    length < 0)
+		return 0;
+
+	memset(rec, 0, sizeof(*rec));
+	memcpy(rec->essid, essid, essid_len);
+	memcpy(rec->key, key, length);
+
+	return 1;
+}
+
+int pmk_cache_open(char *name)
+{
+	FILE *file;
+	int64_t size, records;
+	char magic[PMK_CACHE_MAGIC_LEN];
+
+	if (!(file = jtr_fopen(name, "a+b"))) {
+		fprintf(stderr, "PMK cache: %s: %s\n", name, strerror(errno));
+		return -1;
+	}
+
+	pmk_cache_lock(file, 1);
+	jtr_fseek64(file, 0, SEEK_END);
+	if ((size = jtr_ftell64(file)) < 0) {
+		pmk_cache_lock(file, 0);
+		fclose(file);
+		return -1;
+	}
+
+	if (size < PMK_CACHE_MAGIC_LEN) {
+		if (size ||
+		    fwrite(PMK_CACHE_MAGIC, PMK_CACHE_MAGIC_LEN, 1, file) != 1 ||
+		    fflush(file)) {
+			fprintf(stderr, "PMK cache: %s: not a PMK cache\n", name);
+			pmk_cache_lock(file, 0);
+			fclose(file);
+			return -1;
+		}
+		size = PMK_CACHE_MAGIC_LEN;
+	}
+	pmk_cache_lock(file, 0);
+
+	jtr_fseek64(file, 0, SEEK_SET);
+	if (fread(magic, PMK_CACHE_MAGIC_LEN, 1, file) != 1 ||
+	    memcmp(magic, PMK_CACHE_MAGIC, PMK_CACHE_MAGIC_LEN)) {
+		fprintf(stderr, "PMK cache: %s: not a PMK cache\n", name);
+		fclose(file);
+		return -1;
+	}
+
+	records = (size - PMK_CACHE_MAGIC_LEN) / sizeof(struct pmk_record);
+	if (records >= 0x7fffffff) {
+		fprintf(stderr, "PMK cache: %s: too large\n", name);
+		fclose(file);
+		return -1;
+	}
+
+/*
+ * A partial record at the end may be one that another process is still
+ * appending, so we just leave it out here.  pmk_cache_flush() repairs it
+ * if it's still there when we hold the lock.
+ */
+	size = PMK_CACHE_MAGIC_LEN + records * sizeof(struct pmk_record);
+
+	memset(&cache, 0, sizeof(cache));
+	cache.name = str_alloc_copy(name);
+	if (pmk_cache_map(file, size)) {
+#ifndef HAVE_MMAP
+		MEM_FREE(cache.map);
+#endif
+		fclose(file);
+		return -1;
+	}
+	cache.mapped_count = records;
+
+/*
+ * Unbuffered, so that each flush is a single append of whole records
+ * even if other processes are appending too.
+ */
+	setvbuf(file, NULL, _IONBF, 0);
+	cache.file = file;
+
+	cache.table_mask = 0xffff;
+	while (cache.table_mask < (records << 1))
+		cache.table_mask = (cache.table_mask << 1) | 1;
+	cache.table = mem_calloc(cache.table_mask + 1, sizeof(*cache.table));
+	for (cache.count = 0; cache.count < records; cache.count++)
+		pmk_cache_insert(cache.count);
+
+	return 0;
+}
+
+int pmk_cache_lookup(const char *essid, const unsigned char *key,
+	int length, unsigned char *pmk)
+{
+	struct pmk_record rec;
+	uint32_t i, n;
+
+	if (!cache.table || !pmk_cache_setup(&rec, essid, key, length))
+		return 0;
+
+	i = pmk_cache_hash(&rec) & cache.table_mask;
+	while ((n = cache.table[i])) {
+		struct pmk_record *found = pmk_cache_record(n - 1);
+
+		if (!memcmp(found->essid, rec.essid,
+		            PMK_CACHE_ESSID_LEN + PMK_CACHE_KEY_LEN)) {
+			memcpy(pmk, found->pmk, PMK_CACHE_PMK_LEN);
+			return 1;
+		}
+		i = (i + 1) & cache.table_mask;
+	}
+
+	return 0;
+}
+
+void pmk_cache_add(const char *essid, const unsigned char *key,
+	int length, const unsigned char *pmk)
+{
+	struct pmk_record *rec;
+	unsigned char dummy[PMK_CACHE_PMK_LEN];
+
+	if (!cache.file || pmk_cache_lookup(essid, key, length, dummy))
+		return;
+
+	if (!cache.added)
+		cache.added = mem_alloc(PMK_CACHE_BUFFER * sizeof(*cache.added));
+
+	rec = &cache.added[cache.added_count];
+	if (!pmk_cache_setup(rec, essid, key, length))
+		return;
+	memcpy(rec->pmk, pmk, PMK_CACHE_PMK_LEN);
+
+	if (++cache.count > (cache.table_mask >> 1))
+		pmk_cache_grow();
+	pmk_cache_insert(cache.mapped_count + cache.added_count++);
+
+	if (cache.added_count >= PMK_CACHE_BUFFER)
+		pmk_cache_flush();
+}
+
+void pmk_cache_flush(void)
+{
+	uint32_t count = cache.added_count, first, n;
+	int64_t size, whole;
+
+	if (!cache.file || !count)
+		return;
+
+	pmk_cache_lock(cache.file, 1);
+
+/*
+ * With the lock held nobody else is appending, so a partial record at the
+ * end is what's left of an interrupted write.  Cut it off before adding
+ * ours, or everything after it would be misaligned.
+ */
+	jtr_fseek64(cache.file, 0, SEEK_END);
+	if ((size = jtr_ftell64(cache.file)) < PMK_CACHE_MAGIC_LEN) {
+		fprintf(stderr, "PMK cache: %s: can't get file size, no longer "
+		        "saving new keys\n", cache.name);
+		goto fail;
+	}
+	whole = PMK_CACHE_MAGIC_LEN + (size - PMK_CACHE_MAGIC_LEN) /
+		sizeof(struct pmk_record) * sizeof(struct pmk_record);
+	if (size != whole) {
+#ifndef _MSC_VER
+		if (ftruncate(fileno(cache.file), whole))
+#else
+		if (_chsize(fileno(cache.file), whole))
+#endif
+		{
+			fprintf(stderr, "PMK cache: %s: truncated record at end "
+			        "and can't remove it, no longer saving new keys\n",
+			        cache.name);
+			goto fail;
+		}
+	}
+
+	if (fwrite(cache.added, sizeof(struct pmk_record), count,
+	           cache.file) != count) {
+		fprintf(stderr, "PMK cache: %s: write error (%s), no longer "
+		        "saving new keys\n", cache.name, strerror(errno));
+		goto fail;
+	}
+
+	pmk_cache_lock(cache.file, 0);
+
+/*
+ * Our records are now in the file from record first on, after any that
+ * other processes appended since we last looked.  Map all of them so that
+ * the buffer can be reused.  The table entries for ours are renumbered from
+ * the last down, so that no new number is mistaken for an old one.
+ */
+	first = (whole - PMK_CACHE_MAGIC_LEN) / sizeof(struct pmk_record);
+	if (pmk_cache_map(cache.file, whole + count * sizeof(struct pmk_record))) {
+		fprintf(stderr, "PMK cache: %s: no longer saving new keys\n",
+		        cache.name);
+		fclose(cache.file);
+		cache.file = NULL;
+		return;
+	}
+	for (n = count; n-- && first != cache.mapped_count; ) {
+		uint32_t i = pmk_cache_hash(&cache.added[n]) & cache.table_mask;
+
+		while (cache.table[i] != cache.mapped_count + n + 1)
+			i = (i + 1) & cache.table_mask;
+		cache.table[i] = first + n + 1;
+	}
+
+	n = cache.mapped_count;
+	cache.mapped_count = first + count;
+	cache.added_count = 0;
+	for (; n < first; n++) {
+		if (++cache.count > (cache.table_mask >> 1))
+			pmk_cache_grow();
+		pmk_cache_insert(n);
+	}
+	return;
+
+fail:
+	pmk_cache_lock(cache.file, 0);
+	fclose(cache.file);
+	cache.file = NULL;
+}
+
+void pmk_cache_close(void)
+{
+	pmk_cache_flush();
+	if (cache.file)
+		fclose(cache.file);
+
+#ifdef HAVE_MMAP
+	if (cache.map)
+		munmap(cache.map, cache.map_size);
+#else
+	MEM_FREE(cache.map);
+#endif
+	MEM_FREE(cache.added);
+	MEM_FREE(cache.table);
+	memset(&cache, 0, sizeof(cache));
+}
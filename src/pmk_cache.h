@@ -0,0 +1,71 @@
+/*
+ * This file is part of John the Ripper password cracker.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted.
+ *
+ * There's ABSOLUTELY NO WARRANTY, express or implied.
+ */
+
+/*
+ * Persistent store of WPA-PSK pairwise master keys, keyed by (ESSID,
+ * passphrase).  The PMK doesn't depend on anything else in a capture, so
+ * once computed it can be reused for any other handshake with that ESSID.
+ */
+
+#ifndef _JOHN_PMK_CACHE_H
+#define _JOHN_PMK_CACHE_H
+
+#include <stdint.h>
+
+#define PMK_CACHE_MAGIC			"JtR PMK cache 1\n"
+#define PMK_CACHE_MAGIC_LEN		16
+
+#define PMK_CACHE_ESSID_LEN		32
+#define PMK_CACHE_KEY_LEN		64
+#define PMK_CACHE_PMK_LEN		32
+
+/*
+ * On-disk record, all fields zero padded.  The file is the magic followed
+ * by records; a truncated record at the end (e.g. from an interrupted
+ * write) is ignored when reading, and cut off by the next process that
+ * appends, while holding the file lock.
+ */
+struct pmk_record {
+	unsigned char essid[PMK_CACHE_ESSID_LEN];
+	unsigned char key[PMK_CACHE_KEY_LEN];
+	unsigned char pmk[PMK_CACHE_PMK_LEN];
+};
+
+/*
+ * Maps the cache file (creating it if needed) and indexes its records.
+ * Returns 0 on success, -1 if the file can't be used; the cache is then
+ * simply disabled.
+ */
+extern int pmk_cache_open(char *name);
+
+/*
+ * Looks up the PMK for this ESSID and key, returns non-zero and fills
+ * pmk if found.
+ */
+extern int pmk_cache_lookup(const char *essid, const unsigned char *key,
+	int length, unsigned char *pmk);
+
+/*
+ * Adds a PMK.  Records are buffered and appended to the file by
+ * pmk_cache_flush().
+ */
+extern void pmk_cache_add(const char *essid, const unsigned char *key,
+	int length, const unsigned char *pmk);
+
+/*
+ * Appends the buffered records to the file.
+ */
+extern void pmk_cache_flush(void);
+
+/*
+ * Flushes and unmaps the cache.
+ */
+extern void pmk_cache_close(void);
+
+#endif
@@ -7,6 +7,7 @@
  */
 
 #include "misc.h"	// error()
+#include "stage_stats.h"
 
 static int omp_t = 1;
 static unsigned char *saved_salt;
@@ -17,6 +18,8 @@ static unpack_data_t (*unpack_data);
 static unsigned int *saved_len;
 static unsigned char *aes_key;
 static unsigned char *aes_iv;
+static struct stage_batch batch;	/* key slots hold an AES_KEY */
+static const char *stage_names[] = { "first block", "CRC", NULL };
 
 #define FORMAT_TAG          "$RAR3$*"
 #define FORMAT_TAG_LEN      (sizeof(FORMAT_TAG)-1)
@@ -29,6 +32,8 @@ static struct fmt_tests cpu_tests[] = {
 	/* -p mode tests, -m0 and -m3 (in that order) */
 	{"$RAR3$*1*c47c5bef0bbd1e98*965f1453*48*47*1*c5e987f81d316d9dcfdb6a1b27105ce63fca2c594da5aa2f6fdf2f65f50f0d66314f8a09da875ae19d6c15636b65c815*30", "test"},
 	{"$RAR3$*1*b4eee1a48dc95d12*965f1453*64*47*1*0fe529478798c0960dd88a38a05451f9559e15f0cf20b4cac58260b0e5b56699d5871bdcc35bee099cc131eb35b9a116adaedf5ecc26b1c09cadf5185b3092e6*33", "test"},
+	/* Over 22 characters, the IV snapshots need a second SHA-1 block */
+	{"$RAR3$*0*3f8a61c2d95e07b4*18b5787d12997866e5c8b56c3fafc6b1", "Twenty-five characters!!!"},
 #ifdef DEBUG
 	/* Various lengths, these should be in self-test but not benchmark */
 	/* from CMIYC 2012 */
@@ -521,100 +526,116 @@ static int cmp_exact(char *source, int index)
 	return 1;
 }
 
-inline static void check_rar(int count)
+/*
+ * Sets up the AES key, and decrypts just the first block for early rejection
+ * of compressed data.  Stored data has no cheap check.
+ */
+static int check_rar_first_block(int index, unsigned char *key_slot)
 {
-	unsigned int index;
+	AES_KEY *aes_ctx = (AES_KEY*)key_slot;
+	unsigned char plain[16];
+	unsigned char pre_iv[16];
 
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-	for (index = 0; index < count; index++) {
-		AES_KEY aes_ctx;
-		unsigned char *key = &aes_key[index * 16];
-		unsigned char *iv = &aes_iv[index * 16];
+	AES_set_decrypt_key(&aes_key[index * 16], 128, aes_ctx);
 
-		AES_set_decrypt_key(key, 128, &aes_ctx);
+	if (cur_file->method == 0x30)	/* stored, not deflated */
+		return 1;
 
-		/* AES decrypt, uses aes_iv, aes_key and blob */
-		if (cur_file->type == 0) {	/* rar-hp mode */
-			unsigned char plain[16];
+	memcpy(pre_iv, &aes_iv[index * 16], 16);
+	AES_cbc_encrypt(cur_file->blob, plain, 16,
+	                aes_ctx, pre_iv, AES_DECRYPT);
 
-			AES_cbc_encrypt(cur_file->blob, plain, 16,
-			                &aes_ctx, iv, AES_DECRYPT);
+	if (plain[0] & 0x80) {
+		// PPM checks here.
+		if (!(plain[0] & 0x20) ||  // Reset bit must be set
+		    (plain[1] & 0x80))     // MaxMB must be < 128
+			return 0;
+	} else {
+		// LZ checks here.
+		if ((plain[0] & 0x40) ||   // KeepOldTable can't be set
+		    !check_huffman(plain)) // Huffman table check
+			return 0;
+	}
 
-			cracked[index] = !memcmp(plain, "\xc4\x3d\x7b\x00\x40\x07\x00", 7);
-		} else {
-			if (cur_file->method == 0x30) {	/* stored, not deflated */
-				CRC32_t crc;
-				unsigned char crc_out[4];
-				unsigned char plain[0x8000];
-				unsigned long long size = cur_file->unp_size;
-				unsigned char *cipher = cur_file->blob;
-
-				/* Use full decryption with CRC check.
-				   Compute CRC of the decompressed plaintext */
-				CRC32_Init(&crc);
-
-				while (size) {
-					unsigned int inlen = (size > 0x8000) ? 0x8000 : size;
-
-					AES_cbc_encrypt(cipher, plain, inlen,
-					                &aes_ctx, iv, AES_DECRYPT);
-
-					CRC32_Update(&crc, plain, inlen);
-					size -= inlen;
-					cipher += inlen;
-				}
-				CRC32_Final(crc_out, crc);
-
-				/* Compare computed CRC with stored CRC */
-				cracked[index] = !memcmp(crc_out, &cur_file->crc.c, 4);
-			} else {
-				const int solid = 0;
-				unpack_data_t *unpack_t;
-				unsigned char plain[20];
-				unsigned char pre_iv[16];
-
-				cracked[index] = 0;
-
-				memcpy(pre_iv, iv, 16);
-
-				/* Decrypt just one block for early rejection */
-				AES_cbc_encrypt(cur_file->blob, plain, 16,
-				                &aes_ctx, pre_iv, AES_DECRYPT);
-
-				/* Early rejection */
-				if (plain[0] & 0x80) {
-					// PPM checks here.
-					if (!(plain[0] & 0x20) ||  // Reset bit must be set
-					    (plain[1] & 0x80))     // MaxMB must be < 128
-						goto bailOut;
-				} else {
-					// LZ checks here.
-					if ((plain[0] & 0x40) ||   // KeepOldTable can't be set
-					    !check_huffman(plain)) // Huffman table check
-						goto bailOut;
-				}
-
-				/* Reset stuff for full check */
-				AES_set_decrypt_key(key, 128, &aes_ctx);
+	return 1;
+}
+
+/* Full decryption (and decompression) with CRC check */
+static int check_rar_crc(int index, unsigned char *key_slot)
+{
+	AES_KEY *aes_ctx = (AES_KEY*)key_slot;
+	unsigned char *key = &aes_key[index * 16];
+	unsigned char *iv = &aes_iv[index * 16];
+
+	if (cur_file->method == 0x30) {	/* stored, not deflated */
+		CRC32_t crc;
+		unsigned char crc_out[4];
+		unsigned char plain[0x8000];
+		unsigned long long size = cur_file->unp_size;
+		unsigned char *cipher = cur_file->blob;
+
+		/* Compute CRC of the decompressed plaintext */
+		CRC32_Init(&crc);
+
+		while (size) {
+			unsigned int inlen = (size > 0x8000) ? 0x8000 : size;
+
+			AES_cbc_encrypt(cipher, plain, inlen,
+			                aes_ctx, iv, AES_DECRYPT);
+
+			CRC32_Update(&crc, plain, inlen);
+			size -= inlen;
+			cipher += inlen;
+		}
+		CRC32_Final(crc_out, crc);
+
+		/* Compare computed CRC with stored CRC */
+		return !memcmp(crc_out, &cur_file->crc.c, 4);
+	} else {
+		const int solid = 0;
+		unpack_data_t *unpack_t;
 
 #ifdef _OPENMP
-				unpack_t = &unpack_data[omp_get_thread_num()];
+		unpack_t = &unpack_data[omp_get_thread_num()];
 #else
-				unpack_t = unpack_data;
+		unpack_t = unpack_data;
 #endif
-				unpack_t->max_size = cur_file->unp_size;
-				unpack_t->dest_unp_size = cur_file->unp_size;
-				unpack_t->pack_size = cur_file->pack_size;
-				unpack_t->iv = iv;
-				unpack_t->ctx = &aes_ctx;
-				unpack_t->key = key;
-
-				if (rar_unpack29(cur_file->blob, solid, unpack_t))
-					cracked[index] = !memcmp(&unpack_t->unp_crc, &cur_file->crc.c, 4);
-bailOut:;
-			}
+		unpack_t->max_size = cur_file->unp_size;
+		unpack_t->dest_unp_size = cur_file->unp_size;
+		unpack_t->pack_size = cur_file->pack_size;
+		unpack_t->iv = iv;
+		unpack_t->ctx = aes_ctx;
+		unpack_t->key = key;
+
+		return rar_unpack29(cur_file->blob, solid, unpack_t) &&
+			!memcmp(&unpack_t->unp_crc, &cur_file->crc.c, 4);
+	}
+}
+
+inline static void check_rar(int count)
+{
+	unsigned int index;
+
+	/* rar-hp mode has just the one check, so it isn't staged */
+	if (cur_file->type == 0) {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+		for (index = 0; index < count; index++) {
+			AES_KEY aes_ctx;
+			unsigned char plain[16];
+
+			AES_set_decrypt_key(&aes_key[index * 16], 128,
+			                    &aes_ctx);
+			AES_cbc_encrypt(cur_file->blob, plain, 16, &aes_ctx,
+			                &aes_iv[index * 16], AES_DECRYPT);
+			cracked[index] = !memcmp(plain, "\xc4\x3d\x7b\x00\x40\x07\x00", 7);
 		}
+		return;
 	}
+
+	stage_batch_start(&batch, count);
+	if (stage_batch_run(&batch, 0, 1, check_rar_first_block))
+		stage_batch_run(&batch, 1, 1, check_rar_crc);
+	stage_batch_cracked(&batch, cracked, count);
 }
@@ -97,8 +97,8 @@ john_register_one(&fmt_rar);
 
 #ifdef SIMD_COEF_32
 #include "simd-intrinsics.h"
+#include "iter_hash.h"
 #define NBKEYS (SIMD_COEF_32*SIMD_PARA_SHA1)
-#define GETPOS(i,idx) ( (idx&(SIMD_COEF_32-1))*4 + ((i)&(0xffffffff-3))*SIMD_COEF_32 + (3-((i)&3)) + (unsigned int)idx/SIMD_COEF_32*SHA_BUF_SIZ*4*SIMD_COEF_32 )
 #define HASH_IDX(idx) (((unsigned int)idx&(SIMD_COEF_32-1))+(unsigned int)idx/SIMD_COEF_32*5*SIMD_COEF_32)
 
 #define ALGORITHM_NAME		"SHA1 " SHA1_ALGORITHM_NAME " AES"
@@ -125,16 +125,6 @@ john_register_one(&fmt_rar);
 #include "rar_common.c"
 #include "memdbg.h"
 
-// these are supposed to be stack arrays; however gcc cannot correctly align
-// stack arrays so we have to use global arrays; we may switch back to stack
-// arrays (which take less space) when gcc fixes this issue
-#ifdef SIMD_COEF_32
-static uint8_t  (*vec_in)[2][NBKEYS*64];
-static uint32_t (*vec_out)[NBKEYS*5];
-static uint8_t  (*tmp_in)[NBKEYS*64];
-static uint32_t (*tmp_out)[NBKEYS*5];
-#endif
-
 static void init(struct fmt_main *self)
 {
 #if defined (_OPENMP)
@@ -162,17 +152,6 @@ static void init(struct fmt_main *self)
 	aes_key = mem_calloc(self->params.max_keys_per_crypt + 1, 16);
 	aes_iv = mem_calloc(self->params.max_keys_per_crypt + 1, 16);
 
-#ifdef SIMD_COEF_32
-	vec_in  = mem_calloc_align(self->params.max_keys_per_crypt,
-	                           sizeof(*vec_in), MEM_ALIGN_CACHE);
-	vec_out = mem_calloc_align(self->params.max_keys_per_crypt,
-	                           sizeof(*vec_out), MEM_ALIGN_CACHE);
-	tmp_in  = mem_calloc_align(self->params.max_keys_per_crypt,
-	                           sizeof(*tmp_in), MEM_ALIGN_CACHE);
-	tmp_out = mem_calloc_align(self->params.max_keys_per_crypt,
-	                           sizeof(*tmp_out), MEM_ALIGN_CACHE);
-#endif
-
 #ifdef DEBUG
 	self->params.benchmark_comment = " (1-16 characters)";
 #endif
@@ -182,10 +161,14 @@ static void init(struct fmt_main *self)
 		CRC32_t crc;
 		CRC32_Init(&crc);
 	}
+
+	stage_batch_init(&batch, "RAR", stage_names,
+	                 self->params.max_keys_per_crypt, sizeof(AES_KEY));
 }
 
 static void done(void)
 {
+	stage_batch_done(&batch);
 	MEM_FREE(aes_iv);
 	MEM_FREE(aes_key);
 	MEM_FREE(saved_len);
@@ -193,12 +176,6 @@ static void done(void)
 	MEM_FREE(cracked);
 	MEM_FREE(unpack_data);
 	MEM_FREE(saved_salt);
-#ifdef SIMD_COEF_32
-	MEM_FREE(vec_in);
-	MEM_FREE(vec_out);
-	MEM_FREE(tmp_in);
-	MEM_FREE(tmp_out);
-#endif
 }
 
 static int crypt_all(int *pcount, struct db_salt *salt)
@@ -229,88 +206,36 @@ static int crypt_all(int *pcount, struct db_salt *salt)
 #pragma omp parallel for
 #endif
 	for (index = 0; index < tot_todo; index += NBKEYS) {
-		unsigned int i, j, k;
-		uint8_t (*RawPsw)[NBKEYS*64] = vec_in[index/NBKEYS];
-		uint32_t *digest = vec_out[index/NBKEYS];
+		unsigned int i, j;
+		unsigned char RawPsw[NBKEYS][UNICODE_LENGTH + 8];
+		unsigned char *prefix[NBKEYS];
+		struct iter_hash ih;
+		uint32_t *digest;
 
 		// all passwords in one batch has the same length
 		int pw_len = saved_len[indices[index]];
-		int RawLength = pw_len + 8 + 3;
-		int cur_len = 0;
-		int fst_blk = 1;
-		int cur_buf = 0;
-
-		unsigned char tmp1 = 0, tmp2 = 0;
-		for (i = 0; i < ROUNDS; ++i) {
-			// copy passwords to vector buffer
+
+		for (j = 0; j < NBKEYS; ++j) {
+			int idx = indices[index + j];
+
+			memcpy(RawPsw[j], &saved_key[UNICODE_LENGTH*idx], pw_len);
+			memcpy(RawPsw[j] + pw_len, saved_salt, 8);
+			prefix[j] = RawPsw[j];
+		}
+		iter_hash_init(&ih, ITER_HASH_SHA1, prefix, pw_len + 8, 3);
+
+		// the IV bytes are taken after rounds 0, ROUNDS/16, ...
+		for (i = 0; i < 16; ++i) {
+			iter_hash_add(&ih, i ? ROUNDS / 16 : 1);
+			digest = iter_hash_final(&ih);
 			for (j = 0; j < NBKEYS; ++j) {
 				int idx = indices[index + j];
-				int len = cur_len;
-				for (k = 0; k < pw_len; ++k) {
-					RawPsw[(len & 64)>>6][GETPOS(len%64, j)] =
-						saved_key[UNICODE_LENGTH*idx + k];
-					len++;
-				}
-				for (k = 0; k < 8; ++k) {
-					RawPsw[(len & 64)>>6][GETPOS(len%64, j)] = saved_salt[k];
-					len++;
-				}
-
-				RawPsw[(len & 64)>>6][GETPOS(len%64, j)] = (unsigned char)i;
-				len++;
-				if ( ((unsigned char) i) == 0) {
-					tmp1 = (unsigned char)(i >> 8);
-					tmp2 = (unsigned char)(i >> 16);
-				}
-				RawPsw[(len & 64)>>6][GETPOS(len%64, j)] = tmp1;
-				len++;
-				RawPsw[(len & 64)>>6][GETPOS(len%64, j)] = tmp2;
-			}
-			cur_len += RawLength;
-
-			if (i % (ROUNDS / 16) == 0) {
-				uint8_t *tempin = tmp_in[index/NBKEYS];
-				uint32_t *tempout = tmp_out[index/NBKEYS];
-				memcpy(tempin, RawPsw[cur_buf], NBKEYS*64);
-				for (j = 0; j < NBKEYS; ++j) { // padding
-					uint32_t *tail;
-					for (k = RawLength; k < 64; ++k)
-						tempin[GETPOS(k, j)] = 0;
-					tempin[GETPOS(RawLength, j)] = 0x80;
-					tail = (uint32_t*)&tempin[GETPOS(64 - 1, j)];
-					*tail = cur_len*8;
-				}
-				if (i == 0)
-					SIMDSHA1body(tempin, tempout, NULL, SSEi_MIXED_IN);
-				else
-					SIMDSHA1body(tempin, tempout, digest,
-					             SSEi_MIXED_IN | SSEi_RELOAD);
-				for (j = 0; j < NBKEYS; ++j) {
-					int idx = indices[index + j];
-					aes_iv[idx*16 + i/(ROUNDS/16)] =
-						(uint8_t)tempout[HASH_IDX(j) + 4*SIMD_COEF_32];
-				}
-			}
-			// swap out and compute digests on the filled buffer
-			if ((cur_len & 64) != (cur_buf << 6)) {
-				if (fst_blk)
-					SIMDSHA1body(RawPsw[cur_buf], digest, NULL, SSEi_MIXED_IN);
-				else
-					SIMDSHA1body(RawPsw[cur_buf], digest, digest,
-					             SSEi_MIXED_IN | SSEi_RELOAD);
-				fst_blk = 0;
-				cur_buf = 1 - cur_buf;
+				aes_iv[idx*16 + i] =
+					(uint8_t)digest[HASH_IDX(j) + 4*SIMD_COEF_32];
 			}
 		}
-		// padding
-		memset(RawPsw[0], 0, sizeof(RawPsw[0]));
-		for (j = 0; j < NBKEYS; ++j) {
-			uint32_t *tail;
-			RawPsw[0][GETPOS(0, j)] = 0x80;
-			tail = (uint32_t*)&RawPsw[0][GETPOS(64 - 1, j)];
-			*tail = cur_len*8;
-		}
-		SIMDSHA1body(RawPsw[0], digest, digest, SSEi_MIXED_IN | SSEi_RELOAD);
+		iter_hash_add(&ih, ROUNDS - 1 - 15 * (ROUNDS / 16));
+		digest = iter_hash_final(&ih);
 
 		for (j = 0; j < NBKEYS; ++j) {
 			for (i = 0; i < 4; ++i) {
@@ -319,6 +244,7 @@ static int crypt_all(int *pcount, struct db_salt *salt)
 				dst[i] = digest[HASH_IDX(j) + i*SIMD_COEF_32];
 			}
 		}
+		iter_hash_free(&ih);
 	}
 	MEM_FREE(indices);
 #else
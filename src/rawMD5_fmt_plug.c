@@ -452,6 +452,27 @@ static int get_hash_5(int index) { return crypt_key[index][0] & PH_MASK_5; }
 static int get_hash_6(int index) { return crypt_key[index][0] & PH_MASK_6; }
 #endif
 
+static void get_hash_batch(int size, int count, unsigned int *out)
+{
+	uint32_t mask = password_hash_sizes[size] - 1;
+#ifdef SIMD_COEF_32
+	uint32_t *key = (uint32_t*)crypt_key;
+	int index, j;
+
+	/* whole vectors, out[] has room for max_keys_per_crypt */
+	for (index = 0; index < count; index += SIMD_COEF_32) {
+		for (j = 0; j < SIMD_COEF_32; j++)
+			out[index + j] = key[j] & mask;
+		key += 4 * SIMD_COEF_32;
+	}
+#else
+	int index;
+
+	for (index = 0; index < count; index++)
+		out[index] = crypt_key[index][0] & mask;
+#endif
+}
+
 struct fmt_main fmt_rawMD5 = {
 	{
 		FORMAT_LABEL,
@@ -512,7 +533,9 @@ struct fmt_main fmt_rawMD5 = {
 		},
 		cmp_all,
 		cmp_one,
-		cmp_exact
+		cmp_exact,
+		NULL,
+		get_hash_batch
 	}
 };
 
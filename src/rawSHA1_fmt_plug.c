@@ -173,6 +173,27 @@ static int get_hash_5(int index) { return crypt_key[index][pos] & PH_MASK_5; }
 static int get_hash_6(int index) { return crypt_key[index][pos] & PH_MASK_6; }
 #endif
 
+static void get_hash_batch(int size, int count, unsigned int *out)
+{
+	uint32_t mask = password_hash_sizes[size] - 1;
+#ifdef SIMD_COEF_32
+	int index, j;
+
+	/* whole vectors, out[] has room for max_keys_per_crypt */
+	for (index = 0; index < count; index += SIMD_COEF_32) {
+		uint32_t *key = &crypt_key[index / NBKEYS][HASH_OFFSET];
+
+		for (j = 0; j < SIMD_COEF_32; j++)
+			out[index + j] = key[j] & mask;
+	}
+#else
+	int index;
+
+	for (index = 0; index < count; index++)
+		out[index] = crypt_key[index][pos] & mask;
+#endif
+}
+
 static int binary_hash_0(void *binary) { return ((uint32_t*)binary)[pos] & PH_MASK_0; }
 static int binary_hash_1(void *binary) { return ((uint32_t*)binary)[pos] & PH_MASK_1; }
 static int binary_hash_2(void *binary) { return ((uint32_t*)binary)[pos] & PH_MASK_2; }
@@ -449,7 +470,9 @@ struct fmt_main fmt_rawSHA1 = {
 		},
 		cmp_all,
 		cmp_one,
-		cmp_exact
+		cmp_exact,
+		NULL,
+		get_hash_batch
 	}
 };
 
@@ -513,7 +536,9 @@ struct fmt_main fmt_rawSHA1_axcrypt = {
 		},
 		cmp_all,
 		cmp_one,
-		cmp_exact
+		cmp_exact,
+		NULL,
+		get_hash_batch
 	}
 };
 
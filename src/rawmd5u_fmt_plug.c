@@ -110,6 +110,8 @@ static void init(struct fmt_main *self)
 		tests[3].plaintext = "\xE2\x82\xAC\xC3\xBC";	// euro and u-umlaut
 		tests[4].ciphertext = "8007d9070b27db7b30433df2cd10abc1";
 		tests[4].plaintext = "\xC3\xBC\xE2\x82\xAC";	// u-umlaut and euro
+		tests[5].ciphertext = "21293b239448a02d82fde6cb44e372a1";
+		tests[5].plaintext = "John the Ripper \xE2\x82\xAC";	// ASCII run and euro
 	} else {
 		if (options.target_enc != ASCII &&
 		    options.target_enc != ISO_8859_1) {
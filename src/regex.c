@@ -52,8 +52,29 @@ static const char *cur_regex, *save_regex;
 static char *restore_str, *restore_regex;
 static int save_str_len;
 
+/*
+ * Candidates are pulled from the iterator a block at a time, and then fed
+ * to the cracker.  The iterator state is recorded at the start of each
+ * block, so a restored session replays at most one block and never skips
+ * a candidate.  In non-hybrid mode, --node and --fork split the work by
+ * handing out whole blocks round-robin.
+ */
+#define REGEX_BLOCK_KEYS		0x400
+
+static struct {
+	int count;
+	char key[REGEX_BLOCK_KEYS][PLAINTEXT_BUFFER_SIZE];
+} block;
+static char *block_str;
+static int block_str_len;
+static unsigned long long block_number, save_block_number;
+static unsigned long long restore_block_number;
+
+static void rex_hybrid_fix_state(void);
+
 static void fix_state(void)
 {
+	rex_hybrid_fix_state();
 }
 
 static double get_progress(void)
@@ -67,7 +88,7 @@ static void save_state(FILE *file)
 
 int rexgen_restore_state_hybrid(const char *sig, FILE *file)
 {
-	if (!strncmp(sig, "rex-v1", 6))
+	if (!strncmp(sig, "rex-v1", 6) || !strncmp(sig, "rex-v2", 6))
 	{
 		int len, ret;
 		ret = fscanf(file, "%d\n", &len);
@@ -78,6 +99,9 @@ int rexgen_restore_state_hybrid(const char *sig, FILE *file)
 		if (ret != 1) return 1;
 		restore_str = mem_alloc_tiny(len+2, 8);
 		fgetl(restore_str, len+1, file);
+		if (sig[5] == '2' &&
+		    fscanf(file, LLu "\n", &restore_block_number) != 1)
+			return 1;
 		log_event("resuming a regex expr or %s and state of %s\n", restore_regex, restore_str);
 		return 0;
 	}
@@ -87,30 +111,94 @@ int rexgen_restore_state_hybrid(const char *sig, FILE *file)
 static void save_state_hybrid(FILE *file)
 {
 	if (save_str && strlen(save_str)) {
-		fprintf(file, "rex-v1\n");
+		fprintf(file, "rex-v2\n");
 		fprintf(file, "%d\n", (int)strlen(save_regex));
 		fprintf(file, "%s\n", save_regex);
 		fprintf(file, "%d\n", (int)strlen(save_str));
 		fprintf(file, "%s\n", save_str);
+		fprintf(file, LLu "\n", save_block_number);
+	}
+}
+
+static void copy_state(char **dst, int *dst_len, const char *src)
+{
+	if (!*dst || strlen(src) > *dst_len) {
+		*dst_len = strlen(src) + 256;
+		MEM_FREE(*dst);
+		*dst = mem_alloc(*dst_len + 1);
 	}
+	strcpy(*dst, src);
 }
 
 static void rex_hybrid_fix_state()
 {
-	char *dstptr=0;
-	if (iter)
-		c_iterator_get_state(iter, &dstptr);
-	if (dstptr) {
-		if (strlen(dstptr) > save_str_len) {
-			save_str_len = strlen(dstptr)+256;
-			MEM_FREE(save_str);
-			save_str = mem_alloc(save_str_len+1);
-		}
-		strcpy(save_str, dstptr);
+	if (block_str && *block_str) {
+		copy_state(&save_str, &save_str_len, block_str);
 		save_regex = cur_regex;
+		save_block_number = block_number;
 	}
 }
 
+/*
+ * Records the iterator state, then pulls up to REGEX_BLOCK_KEYS candidates
+ * into the block.  Returns the number of candidates.
+ */
+static int regex_fill_block(c_simplestring_ptr buffer)
+{
+	char *dstptr = 0;
+
+	c_iterator_get_state(iter, &dstptr);
+	if (dstptr)
+		copy_state(&block_str, &block_str_len, dstptr);
+
+	block.count = 0;
+	while (block.count < REGEX_BLOCK_KEYS && c_iterator_next(iter)) {
+		c_simplestring_clear(buffer);
+		c_iterator_value(iter, buffer);
+		/**
+		  * rexgen already creates the correct encoding
+		  */
+		strnzcpy(block.key[block.count++],
+		         c_simplestring_to_string(buffer),
+		         PLAINTEXT_BUFFER_SIZE);
+	}
+
+	return block.count;
+}
+
+static int regex_block_for_us(void)
+{
+	int for_node;
+
+	if (!options.node_count)
+		return 1;
+
+	for_node = block_number % options.node_count + 1;
+	return for_node >= options.node_min && for_node <= options.node_max;
+}
+
+static int regex_process_block(int max_len)
+{
+	int i;
+
+	for (i = 0; i < block.count; i++) {
+		char *word = block.key[i];
+
+		if (options.mask) {
+			if (do_mask_crack(word))
+				return 1;
+		} else
+		if (ext_filter(word)) {
+			if (strlen(word) > max_len)
+				word[max_len] = 0;
+			if (crk_process_key(word))
+				return 1;
+		}
+	}
+
+	return 0;
+}
+
 static int restore_state(FILE *file)
 {
 	return 0;
@@ -190,7 +278,6 @@ int do_regex_hybrid_crack(struct db_main *db, const char *regex,
                           const char *regex_alpha)
 {
 	c_simplestring_ptr buffer = c_simplestring_new();
-	const char* word;
 	static int bFirst = 1;
 	static int bALPHA = 0;
 	int max_len = db->format->params.plaintext_length;
@@ -286,29 +373,11 @@ int do_regex_hybrid_crack(struct db_main *db, const char *regex,
 		goto out;
 	}
 
-	while (c_iterator_next(iter)) {
-		c_simplestring_clear(buffer);
-		c_iterator_value(iter, buffer);
-		word = c_simplestring_to_string(buffer);
-		/**
-		  * rexgen already creates the correct encoding
-		  */
-		//if (options.internal_cp != UTF_8)
-		//	utf8_to_cp_r(word, word, sizeof(word));
-		if (options.mask) {
-			if (do_mask_crack(word)) {
-				retval = 1;
-				goto out;
-			}
-		} else
-		if (ext_filter((char *)word)) {
-			c_simplestring_truncate_bytes(buffer, max_len);
-			if (crk_process_key((char *)word)) {
-				retval = 1;
-				goto out;
-			}
+	while (regex_fill_block(buffer))
+		if (regex_process_block(max_len)) {
+			retval = 1;
+			goto out;
 		}
-	}
 	retval = 0;
 	goto out;
 
@@ -320,7 +389,6 @@ out:
 void do_regex_crack(struct db_main *db, const char *regex)
 {
 	c_simplestring_ptr buffer = c_simplestring_new();
-	const char* word;
 	int max_len = db->format->params.plaintext_length;
 
 	if (options.req_maxlength)
@@ -344,24 +412,20 @@ void do_regex_crack(struct db_main *db, const char *regex)
 	if (rec_restored && john_main_process)
 		fprintf(stderr, "Proceeding with regex:%s\n", regex);
 
+	if (options.node_count)
+		log_event("- Split over nodes in blocks of %d candidates",
+		          REGEX_BLOCK_KEYS);
+
 	iter = c_regex_iterator(regex_ptr);
 	if (restore_str) {
 		c_iterator_set_state(iter, restore_str);
 		restore_str = 0;
 	}
-	while (c_iterator_next(iter)) {
-		c_simplestring_clear(buffer);
-		c_iterator_value(iter, buffer);
-		word = c_simplestring_to_string(buffer);
-		if (options.mask) {
-			if (do_mask_crack(word))
-				break;
-		} else
-		if (ext_filter((char *)word)) {
-			c_simplestring_truncate_bytes(buffer, max_len);
-			if (crk_process_key((char *)word))
-				break;
-		}
+	block_number = restore_block_number;
+	while (regex_fill_block(buffer)) {
+		if (regex_block_for_us() && regex_process_block(max_len))
+			break;
+		block_number++;
 	}
 	c_simplestring_delete(buffer);
 	c_iterator_delete(iter);
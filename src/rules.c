@@ -20,6 +20,7 @@
 #include "rules.h"
 #include "options.h"
 #include "john.h"
+#include "status.h"
 #include "unicode.h"
 #include "encoding_data.h"
 #include "memdbg.h"
@@ -2191,11 +2192,11 @@ out_OK:
 	in[rules_max_length] = 0;
 	if (minlength)
 		if (length < minlength)
-			return NULL;
+			goto out_NULL;
 	/* --maxlength will skip, not truncate */
 	if (maxlength)
 		if (length > maxlength)
-			return NULL;
+			goto out_NULL;
 	if (!(options.flags & FLG_MASK_STACKED) &&
 	    options.internal_cp != UTF_8 && options.target_enc == UTF_8) {
 		char out[PLAINTEXT_BUFFER_SIZE + 1];
@@ -2212,13 +2213,13 @@ out_OK:
 				return in;
 			if (strcmp(&in[ARCH_SIZE - 1], &last[ARCH_SIZE - 1]))
 				return in;
-			return NULL;
+			goto out_NULL;
 		}
 		if (last[length])
 			return in;
 		if (memcmp(in, last, length))
 			return in;
-		return NULL;
+		goto out_NULL;
 	}
 	return in;
 
@@ -2234,26 +2235,32 @@ out_which:
 out_ERROR_POSITION:
 	rules_errno = RULES_ERROR_POSITION;
 	if (LAST)
-		goto out_NULL;
+		goto out_ERROR;
 
 out_ERROR_END:
 	rules_errno = RULES_ERROR_END;
+/* A syntax error in the rule rather than a word rejected by it */
+out_ERROR:
+	STATUS_COUNT(rule_errors, 1);
+	return NULL;
+
 out_NULL:
+	STATUS_COUNT(rejected, 1);
 	return NULL;
 
 out_ERROR_CLASS:
 	rules_errno = RULES_ERROR_CLASS;
 	if (LAST)
-		goto out_NULL;
+		goto out_ERROR;
 	goto out_ERROR_END;
 
 out_ERROR_UNKNOWN:
 	rules_errno = RULES_ERROR_UNKNOWN;
-	goto out_NULL;
+	goto out_ERROR;
 
 out_ERROR_UNALLOWED:
 	rules_errno = RULES_ERROR_UNALLOWED;
-	goto out_NULL;
+	goto out_ERROR;
 }
 
 /*
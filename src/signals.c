@@ -59,10 +59,11 @@
 
 volatile int event_pending = 0, event_reload = 0;
 volatile int event_abort = 0, event_save = 0, event_status = 0;
+volatile int event_status_file = 0;
 volatile int event_ticksafety = 0;
 volatile int event_mpiprobe = 0, event_poll_files = 0;
 
-volatile int timer_abort = 0, timer_status = 0;
+volatile int timer_abort = 0, timer_status = 0, timer_status_file = 0;
 static int timer_save_interval;
 #ifndef BENCH_BUILD
 static int timer_save_value;
@@ -351,6 +352,10 @@ static void sig_handle_timer(int signum)
 		timer_status = options.status_interval;
 		event_status = event_pending = 1;
 	}
+	if (timer_status_file && !--timer_status_file) {
+		timer_status_file = options.status_file_interval;
+		event_status_file = event_pending = 1;
+	}
 #else /* no OS_TIMER */
 	time = status_get_time();
 
@@ -385,6 +390,10 @@ static void sig_handle_timer(int signum)
 		timer_status += options.status_interval;
 		event_status = event_pending = 1;
 	}
+	if (timer_status_file && time >= timer_status_file) {
+		timer_status_file += options.status_file_interval;
+		event_status_file = event_pending = 1;
+	}
 #endif /* OS_TIMER */
 #endif /* !BENCH_BUILD */
 
@@ -588,6 +597,8 @@ void sig_init_late(void)
 		timer_abort = time + abs(options.max_run_time);
 	if (options.status_interval)
 		timer_status = time + options.status_interval;
+	if (options.status_file_interval)
+		timer_status_file = time + options.status_file_interval;
 #endif
 }
 
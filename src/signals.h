@@ -35,6 +35,7 @@ extern volatile int event_abort;	/* Abort requested */
 extern volatile int event_reload;	/* Reload of pot file requested */
 extern volatile int event_save;		/* Save the crash recovery file */
 extern volatile int event_status;	/* Status display requested */
+extern volatile int event_status_file;	/* Status file update requested */
 extern volatile int event_ticksafety;	/* System time in ticks may overflow */
 #ifdef HAVE_MPI
 extern volatile int event_mpiprobe;	/* MPI probe for messages requested */
@@ -48,6 +49,9 @@ extern volatile int timer_abort;
 /* --progress-every timer */
 extern volatile int timer_status;
 
+/* --status-file-every timer */
+extern volatile int timer_status_file;
+
 #if !OS_TIMER
 /*
  * Timer emulation for systems with no setitimer(2).
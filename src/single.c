@@ -7,6 +7,7 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <stdint.h>
 
 #include "misc.h"
 #include "params.h"
@@ -35,7 +36,7 @@ static int rec_rule;
 
 static struct db_main *single_db;
 static int rule_number, rule_count;
-static int length, key_count;
+static int length, key_count, stale_rules;
 static struct db_keys *guessed_keys;
 static struct rpp_context *rule_ctx;
 
@@ -127,14 +128,50 @@ static void single_init(void)
 	key_count = single_db->format->params.min_keys_per_crypt;
 	if (key_count < SINGLE_HASH_MIN)
 		key_count = SINGLE_HASH_MIN;
+
+/*
+ * A buffer that hasn't filled up within this many rules is processed anyway,
+ * so that rec_rule keeps advancing.  This stays based on min_keys_per_crypt
+ * no matter how much we grow the buffers below.
+ */
+	stale_rules = key_count << 1;
+
 /*
- * We use "short" for buffered key indices and "unsigned short" for buffered
- * key offsets - make sure these don't overflow.
+ * Each salt's buffer is processed with a crypt_all() call of its own, and
+ * the format's OpenMP threads only all get work when that call is given a
+ * full max_keys_per_crypt batch.  So grow the buffers towards that for as
+ * long as the buffers for all salts fit in SingleMaxBufferSize.
  */
-	if (key_count > 0x8000)
-		key_count = 0x8000;
-	while (key_count > 0xffff / length + 1)
-		key_count >>= 1;
+	{
+		int max_count = single_db->format->params.max_keys_per_crypt;
+		int max_size = cfg_get_int(SECTION_OPTIONS, NULL,
+		                           "SingleMaxBufferSize");
+		uint64_t per_key = length + sizeof(struct db_keys_hash_entry);
+		uint64_t avail;
+
+		if (max_size < 0)
+			max_size = SINGLE_MAX_BUFFER_SIZE;
+		avail = (uint64_t)max_size << 20;
+
+		if (options.force_maxkeys && options.force_maxkeys < max_count)
+			max_count = options.force_maxkeys;
+
+		while (key_count < max_count) {
+			int next = key_count << 1;
+
+			if (next > max_count)
+				next = max_count;
+			if ((uint64_t)single_db->salt_count * per_key * next >
+			    avail)
+				break;
+			key_count = next;
+		}
+
+		if (key_count < max_count)
+			log_event("- SingleMaxBufferSize = %d MB limits buffers "
+			          "to %d of %d candidate passwords",
+			          max_size, key_count, max_count);
+	}
 
 	if (rpp_init(rule_ctx, options.activesinglerules)) {
 		log_event("! No \"%s\" mode rules found",
@@ -432,7 +469,7 @@ next:
 		last = &pw->next;
 	} while ((pw = pw->next));
 
-	if (keys->count && rule_number - keys->rule > (key_count << 1))
+	if (keys->count && rule_number - keys->rule > stale_rules)
 		if (single_process_buffer(salt))
 			return 1;
 
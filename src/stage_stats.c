@@ -0,0 +1,141 @@
+/*
+ * This file is part of John the Ripper password cracker.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted.
+ *
+ * There's ABSOLUTELY NO WARRANTY, express or implied.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "arch.h"
+#include "misc.h"
+#include "memory.h"
+#include "params.h"
+#include "options.h"
+#include "logger.h"
+#include "stage_stats.h"
+#include "memdbg.h"
+
+void stage_stats_init(struct stage_stats *stats, const char *label,
+	const char *name[])
+{
+	memset(stats, 0, sizeof(*stats));
+	stats->label = label;
+	while (stats->stages < STAGE_STATS_MAX && name[stats->stages]) {
+		stats->name[stats->stages] = name[stats->stages];
+		stats->stages++;
+	}
+}
+
+void stage_stats_done(struct stage_stats *stats)
+{
+	char line[LINE_BUFFER_SIZE], *p = line;
+	unsigned long long tried = stats->tried;
+	int stage;
+
+	if (!tried)
+		return;
+
+	*p = 0;
+	for (stage = 0; stage < stats->stages && tried; stage++) {
+		unsigned long long passed = stats->passed[stage];
+
+		p += snprintf(p, sizeof(line) - (p - line),
+		              "%s%s %.3f%% of " LLu, stage ? ", " : "",
+		              stats->name[stage],
+		              100.0 * (tried - passed) / tried, tried);
+		tried = passed;
+	}
+
+	log_event("- %s early reject: %s", stats->label, line);
+	if (options.verbosity > VERB_DEFAULT)
+		fprintf(stderr, "%s early reject: %s\n", stats->label, line);
+
+	stats->tried = 0;
+	memset(stats->passed, 0, sizeof(stats->passed));
+}
+
+void stage_batch_init(struct stage_batch *batch, const char *label,
+	const char *name[], int max_keys, size_t key_size)
+{
+	stage_stats_init(&batch->stats, label, name);
+	batch->key_size = key_size;
+	batch->keys = NULL;
+	batch->index = batch->passed = NULL;
+	batch->count = batch->max_keys = 0;
+	stage_batch_alloc(batch, max_keys);
+}
+
+void stage_batch_alloc(struct stage_batch *batch, int max_keys)
+{
+	if (max_keys <= batch->max_keys)
+		return;
+
+	if (batch->key_size)
+		batch->keys = mem_realloc(batch->keys,
+		                          max_keys * batch->key_size);
+	batch->index = mem_realloc(batch->index,
+	                           max_keys * sizeof(*batch->index));
+	batch->passed = mem_realloc(batch->passed,
+	                            max_keys * sizeof(*batch->passed));
+	batch->max_keys = max_keys;
+}
+
+void stage_batch_done(struct stage_batch *batch)
+{
+	stage_stats_done(&batch->stats);
+	MEM_FREE(batch->passed);
+	MEM_FREE(batch->index);
+	MEM_FREE(batch->keys);
+}
+
+void stage_batch_start(struct stage_batch *batch, int count)
+{
+	int i;
+
+	stage_batch_alloc(batch, count);
+	for (i = 0; i < count; i++)
+		batch->index[i] = i;
+	batch->count = count;
+	STAGE_STATS_TRY(&batch->stats, count);
+}
+
+int stage_batch_run(struct stage_batch *batch, int stage, int stages,
+	stage_check check)
+{
+	int i, left, count = batch->count;
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+	for (i = 0; i < count; i++) {
+		int index = batch->index[i];
+
+		batch->passed[i] = check(index, batch->keys ?
+		                         stage_batch_key(batch, index) : NULL);
+	}
+
+	for (i = left = 0; i < count; i++) {
+		int passed = MIN(batch->passed[i], stages);
+
+		if (!bench_running)
+			while (passed--)
+				batch->stats.passed[stage + passed]++;
+		if (batch->passed[i] >= stages)
+			batch->index[left++] = batch->index[i];
+	}
+
+	return batch->count = left;
+}
+
+void stage_batch_cracked(struct stage_batch *batch, int *cracked, int count)
+{
+	int i;
+
+	memset(cracked, 0, count * sizeof(*cracked));
+	for (i = 0; i < batch->count; i++)
+		cracked[batch->index[i]] = 1;
+}
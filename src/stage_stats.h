@@ -0,0 +1,134 @@
+/*
+ * This file is part of John the Ripper password cracker.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted.
+ *
+ * There's ABSOLUTELY NO WARRANTY, express or implied.
+ */
+
+/*
+ * Staged checks done by archive formats (a checksum or verifier first, then
+ * partial decryption, decompression, and a CRC or MAC last), and their reject
+ * rates.  Stages are numbered from the cheapest one; a candidate only gets
+ * to a stage if it passed all earlier ones.
+ */
+
+#ifndef _JOHN_STAGE_STATS_H
+#define _JOHN_STAGE_STATS_H
+
+#include "common.h"
+
+#define STAGE_STATS_MAX			4
+
+extern volatile int bench_running;
+
+struct stage_stats {
+	const char *label;
+	int stages;
+	const char *name[STAGE_STATS_MAX];
+	unsigned long long tried;
+	unsigned long long passed[STAGE_STATS_MAX];
+};
+
+/*
+ * Sets up stats for up to STAGE_STATS_MAX stages, named by the NULL
+ * terminated list of names.
+ */
+extern void stage_stats_init(struct stage_stats *stats, const char *label,
+	const char *name[]);
+
+/*
+ * Counts candidates going into the first stage.  Not thread safe, so call
+ * this outside of parallel regions.  Self-tests, benchmarks and auto-tuning
+ * aren't counted.
+ */
+#define STAGE_STATS_TRY(stats, count) \
+	((stats)->tried += bench_running ? 0 : (count))
+
+/*
+ * Counts a candidate passing a stage.  Passes are rare compared to the
+ * candidates tried, so this can be done from parallel regions.
+ */
+static MAYBE_INLINE void stage_stats_pass(struct stage_stats *stats,
+	int stage)
+{
+	if (bench_running)
+		return;
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+	stats->passed[stage]++;
+}
+
+/*
+ * Logs the reject rate of each stage, and also prints it with --verbosity
+ * above the default.  Nothing is reported if no candidates were tried.
+ */
+extern void stage_stats_done(struct stage_stats *stats);
+
+/*
+ * A batch of candidates going through the stages.  Each candidate has a slot
+ * of key_size bytes for what is derived from its key (the KDF output, an AES
+ * key schedule set up by one stage for the next, ...), so later stages (and
+ * later salts, if the format allows) don't derive it again.  Each stage is
+ * run in one parallel loop over just the candidates still in the batch.
+ */
+struct stage_batch {
+	struct stage_stats stats;
+	size_t key_size;
+	unsigned char *keys;
+	int *index, *passed, count, max_keys;
+};
+
+/*
+ * One check for the candidate at index, given its key slot.  Returns the
+ * number of stages passed from the one it was run for, so that a check can
+ * cover several stages (e.g. decompression then a CRC of the output).  It
+ * is called from parallel regions.
+ */
+typedef int (*stage_check)(int index, unsigned char *key);
+
+/*
+ * Sets up a batch for max_keys candidates (may be 0 if not known yet), with
+ * key_size bytes (may be 0) of key slot each, and stage stats as for
+ * stage_stats_init().
+ */
+extern void stage_batch_init(struct stage_batch *batch, const char *label,
+	const char *name[], int max_keys, size_t key_size);
+
+/*
+ * Makes room for max_keys candidates, keeping the key slots there are.
+ */
+extern void stage_batch_alloc(struct stage_batch *batch, int max_keys);
+
+/*
+ * Reports the stats as stage_stats_done() does, and frees the batch.
+ */
+extern void stage_batch_done(struct stage_batch *batch);
+
+#define stage_batch_key(batch, index) \
+	(&(batch)->keys[(size_t)(index) * (batch)->key_size])
+
+/*
+ * Starts the first stage with candidates 0 to count - 1, making room for
+ * them if needed.
+ */
+extern void stage_batch_start(struct stage_batch *batch, int count);
+
+/*
+ * Runs check for the candidates left, which is to cover stages starting
+ * with stage.  Only those passing all of them are kept, in their original
+ * order.  Returns the number of candidates left.
+ */
+extern int stage_batch_run(struct stage_batch *batch, int stage, int stages,
+	stage_check check);
+
+/*
+ * Sets cracked[] for the first count candidates, to whether they passed all
+ * the stages run.
+ */
+extern void stage_batch_cracked(struct stage_batch *batch, int *cracked,
+	int count);
+
+#endif
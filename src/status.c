@@ -15,11 +15,15 @@
 #include <stdlib.h>
 #include <ctype.h>
 #include <string.h>
+#include <errno.h>
 #include <time.h>
 #include "os.h"
 #if HAVE_SYS_TIMES_H
 #include <sys/times.h>
 #endif
+#if HAVE_UNISTD_H
+#include <unistd.h>
+#endif
 
 #include "times.h"
 
@@ -35,6 +39,10 @@
 #include "status.h"
 #include "bench.h"
 #include "config.h"
+#include "logger.h"
+#include "loader.h"
+#include "recovery.h"
+#include "path.h"
 #include "unicode.h"
 #include "signals.h"
 #include "mask.h"
@@ -45,6 +53,9 @@
 #include "memdbg.h"
 
 struct status_main status;
+#if STATUS_COUNTERS
+struct status_counters status_counters;
+#endif
 unsigned int status_restored_time = 0;
 static char* timeFmt = NULL;
 static char* timeFmt24 = NULL;
@@ -396,6 +407,18 @@ static void status_print_cracking(double percent)
 	if (n > 0)
 		p += n;
 
+#if STATUS_COUNTERS
+	n = sprintf(p, "Keys "LLu" rejected "LLu" rule errors "LLu" crypts "LLu
+	    " probes "LLu" hits "LLu" cmp_one "LLu" cmp_exact "LLu
+	    " guesses "LLu"\n",
+	    status_counters.keys, status_counters.rejected,
+	    status_counters.rule_errors, status_counters.crypts, status_counters.probes,
+	    status_counters.hits, status_counters.cmp_one,
+	    status_counters.cmp_exact, status_counters.guesses);
+	if (n > 0)
+		p += n;
+#endif
+
 	fwrite(s, p - s, 1, stderr);
 }
 
@@ -492,3 +515,126 @@ void status_print(void)
 		status_print_cracking(percent_value);
 #endif
 }
+
+/*
+ * Status file names are those of the .rec files with STATUS_SUFFIX instead.
+ */
+static char *status_file_name(char *suffix)
+{
+	size_t len = strlen(rec_name), rec_len = strlen(RECOVERY_SUFFIX);
+	char *name;
+
+	if (len > rec_len && !strcmp(&rec_name[len - rec_len], RECOVERY_SUFFIX))
+		len -= rec_len;
+
+	name = mem_alloc_tiny(len + strlen(STATUS_SUFFIX) + strlen(suffix) + 1,
+	                      MEM_ALIGN_NONE);
+	memcpy(name, rec_name, len);
+	strcpy(&name[len], STATUS_SUFFIX);
+	strcat(name, suffix);
+
+	return str_alloc_copy(path_expand(name));
+}
+
+static unsigned long long status_get_ull(int64 *c)
+{
+	return ((unsigned long long)c->hi << 32) + c->lo;
+}
+
+void status_write_file(struct db_main *db)
+{
+	static char *name, *tmp_name;
+	static int failed;
+	FILE *file;
+	double secs, percent, eta, combs;
+	unsigned long long cands, crypts;
+
+	if (failed || !rec_name_completed)
+		return;
+
+	if (!name) {
+		name = status_file_name("");
+		tmp_name = status_file_name(".tmp");
+	}
+
+	secs = status_restored_time +
+		(double)(get_time() - status.start_time) / clk_tck;
+	if (secs <= 0)
+		secs = 1.0 / clk_tck;
+
+	percent = status_get_progress ? status_get_progress() : -1;
+	eta = -1;
+	if (percent >= 100)
+		eta = 0;
+	else if (percent > 0)
+		eta = secs * 100 / percent - secs;
+
+	cands = status_get_ull(&status.cands);
+	crypts = status_get_ull(&status.crypts);
+	combs = status_get_ull(&status.combs) +
+		status.combs_ehi * 18446744073709551616.0;
+
+	if (!(file = fopen(tmp_name, "w"))) {
+		fprintf(stderr, "Can't write status file %s: %s\n",
+		        tmp_name, strerror(errno));
+		failed = 1;
+		return;
+	}
+
+	fprintf(file, "{\"pid\": %d, \"node\": %u, \"node_max\": %u, "
+	        "\"node_count\": %u,\n", (int)getpid(), options.node_min,
+	        options.node_max, options.node_count);
+	fprintf(file, " \"time\": %.3f, \"progress\": %.4f, \"eta\": %.0f,\n",
+	        secs, percent, eta);
+	fprintf(file, " \"guesses\": %u, \"candidates\": "LLu", "
+	        "\"crypts\": "LLu", \"combinations\": %.0f,\n",
+	        status.guess_count, cands, crypts, combs);
+	fprintf(file, " \"guesses_per_sec\": %.3f, \"candidates_per_sec\": "
+	        "%.3f, \"crypts_per_sec\": %.3f, \"combinations_per_sec\": "
+	        "%.3f,\n", status.guess_count / secs, cands / secs,
+	        crypts / secs, combs / secs);
+	fprintf(file, " \"salts\": %d, \"hashes\": %d",
+	        db ? db->salt_count : 0, db ? db->password_count : 0);
+#if STATUS_COUNTERS
+	fprintf(file, ",\n \"counters\": {\"keys\": "LLu", \"rejected\": "LLu
+	        ", \"rule_errors\": "LLu", \"crypts\": "LLu", \"probes\": "LLu
+	        ", \"hits\": "LLu", \"cmp_one\": "LLu", \"cmp_exact\": "LLu
+	        ", \"guesses\": "LLu"}",
+	        status_counters.keys, status_counters.rejected,
+	        status_counters.rule_errors, status_counters.crypts, status_counters.probes,
+	        status_counters.hits, status_counters.cmp_one,
+	        status_counters.cmp_exact, status_counters.guesses);
+#endif
+	fputs("}\n", file);
+
+	if (ferror(file) | fclose(file)) {
+		fprintf(stderr, "Can't write status file %s\n", tmp_name);
+		failed = 1;
+		return;
+	}
+
+#if defined (__MINGW32__) || defined (_MSC_VER)
+	unlink(name);
+#endif
+	if (rename(tmp_name, name)) {
+		fprintf(stderr, "Can't rename %s to %s: %s\n",
+		        tmp_name, name, strerror(errno));
+		failed = 1;
+	}
+}
+
+void status_log_counters(void)
+{
+#if STATUS_COUNTERS
+	struct status_counters *c = &status_counters;
+
+	log_event("Counters: keys "LLu", rejected "LLu", rule errors "LLu
+	          ", crypts "LLu,
+	          c->keys, c->rejected, c->rule_errors, c->crypts);
+	log_event("Counters: bitmap probes "LLu", hits "LLu" (%.2f%%), "
+	          "cmp_one "LLu", cmp_exact "LLu", guesses "LLu,
+	          c->probes, c->hits,
+	          c->probes ? 100.0 * c->hits / c->probes : 0.0,
+	          c->cmp_one, c->cmp_exact, c->guesses);
+#endif
+}
@@ -20,6 +20,7 @@
 #include <time.h>
 
 #include "math.h"
+#include "params.h"
 
 #if CPU_REQ && defined(__GNUC__) && defined(__i386__)
 /* ETA reporting would be wrong when cracking some hash types at least on a
@@ -47,6 +48,26 @@ struct status_main {
 
 extern struct status_main status;
 
+#if STATUS_COUNTERS
+/*
+ * Hot-path event counts (see STATUS_COUNTERS in params.h).  These are only
+ * updated from the thread running the cracker (other threads only work
+ * inside crypt_all() and candidate generators), so they need no locking.
+ * For salts without a bitmap, cmp_all() calls count as bitmap probes.
+ * Words rejected by a rule are counted apart from rule syntax errors.
+ */
+struct status_counters {
+	unsigned long long keys, rejected, rule_errors, crypts, probes, hits;
+	unsigned long long cmp_one, cmp_exact, guesses;
+};
+
+extern struct status_counters status_counters;
+
+#define STATUS_COUNT(field, n)		(status_counters.field += (n))
+#else
+#define STATUS_COUNT(field, n)		((void)0)
+#endif
+
 extern double (*status_get_progress)(void);
 
 /*
@@ -93,4 +114,17 @@ extern unsigned int status_get_time(void);
  */
 extern void status_print(void);
 
+/*
+ * Atomically replaces the session's JSON status file (see --status-file-every)
+ * with a snapshot of the current status, including the number of salts and
+ * hashes left in db (which may be NULL).
+ */
+struct db_main;
+extern void status_write_file(struct db_main *db);
+
+/*
+ * Logs the hot-path counters, if compiled in.
+ */
+extern void status_log_counters(void);
+
 #endif
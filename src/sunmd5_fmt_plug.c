@@ -545,7 +545,7 @@ static int crypt_all(int *pcount, struct db_salt *salt)
 #endif // SIMD_COEF_32
 #else
 #ifdef SIMD_COEF_32
-#pragma omp parallel for default(none) private(idx) shared(ngroups, group_sz, saved_salt, data, input_buf, input_buf_big, out_buf)
+#pragma omp parallel for default(none) private(idx) shared(ngroups, group_sz, saved_salt, data, input_buf, input_buf_big, out_buf, count, constant_phrase)
 #else
 #pragma omp parallel for default(none) private(idx) shared(ngroups, group_sz, saved_salt, data)
 #endif // SIMD_COEF_32
@@ -136,6 +136,25 @@ int utf8_to_utf16(UTF16 *target, unsigned int len, const UTF8 *source,
 	unsigned int extraBytesToRead;
 
 	while (source < sourceEnd) {
+#if __SSE2__ && ARCH_LITTLE_ENDIAN
+		/* Runs of pure ASCII are widened 16 characters at a time */
+		while (source + 16 <= sourceEnd && target + 16 < targetEnd) {
+			__m128i v = _mm_loadu_si128((const __m128i *)source);
+			__m128i zero = _mm_setzero_si128();
+
+			if (_mm_movemask_epi8(v) |
+			    _mm_movemask_epi8(_mm_cmpeq_epi8(v, zero)))
+				break;
+			_mm_storeu_si128((__m128i *)target,
+			                 _mm_unpacklo_epi8(v, zero));
+			_mm_storeu_si128((__m128i *)target + 1,
+			                 _mm_unpackhi_epi8(v, zero));
+			source += 16;
+			target += 16;
+		}
+		if (source >= sourceEnd)
+			break;
+#endif
 		if (*source < 0xC0) {
 #if ARCH_LITTLE_ENDIAN
 			*target++ = (UTF16)*source++;
@@ -33,6 +33,10 @@
 #include <wchar.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+#if __SSE2__
+#include <emmintrin.h>
+#endif
 
 #include "options.h"
 #include "common.h"
@@ -254,6 +258,53 @@ inline static UTF16 up2low_u16(UTF16 w)
 	return w;
 }
 
+/*
+ * Widens the pure ASCII start of a UTF-8 key of length len to UTF-16LE,
+ * 8 characters at a time, as pairs of characters in 32-bit words that are
+ * stride words apart (the layout of our interleaved SIMD key buffers).  No
+ * more than max characters are done.  Returns the number of characters done,
+ * a multiple of 8; the caller decodes the rest, starting with any multibyte
+ * sequence.  Big-endian builds get no help here and always see 0.
+ */
+inline static unsigned int utf8_ascii_to_utf16_words(uint32_t *dst,
+	unsigned int stride, const UTF8 *src, unsigned int len, unsigned int max)
+{
+	unsigned int done = 0;
+
+#if ARCH_LITTLE_ENDIAN
+	while (done + 8 <= len && done + 8 <= max) {
+#if __SSE2__
+		__m128i v = _mm_loadl_epi64((const __m128i *)&src[done]);
+
+		if (_mm_movemask_epi8(v) & 0xff)
+			break;
+		v = _mm_unpacklo_epi8(v, _mm_setzero_si128());
+		if (stride == 1) {
+			_mm_storeu_si128((__m128i *)dst, v);
+		} else {
+			dst[0] = _mm_cvtsi128_si32(v);
+			dst[stride] = _mm_cvtsi128_si32(_mm_srli_si128(v, 4));
+			dst[2 * stride] = _mm_cvtsi128_si32(_mm_srli_si128(v, 8));
+			dst[3 * stride] = _mm_cvtsi128_si32(_mm_srli_si128(v, 12));
+		}
+#else
+		uint64_t x;
+		unsigned int i;
+
+		memcpy(&x, &src[done], 8);
+		if (x & 0x8080808080808080ULL)
+			break;
+		for (i = 0; i < 4; i++, x >>= 16)
+			dst[i * stride] = (x & 0xff) | (x & 0xff00) << 8;
+#endif
+		dst += 4 * stride;
+		done += 8;
+	}
+#endif
+
+	return done;
+}
+
 /* Lowercase UTF-16 string */
 extern int utf16_lc(UTF16 *dst, unsigned dst_len, const UTF16 *src, unsigned src_len);
 
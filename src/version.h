@@ -0,0 +1 @@
+#define JTR_GIT_VERSION "5fe95bc+"
@@ -58,6 +58,10 @@
 
 #include <errno.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include "arch.h"
 #include "jumbo.h"
 #include "misc.h"
@@ -80,7 +84,9 @@
 #include "unicode.h"
 #include "regex.h"
 #include "mask.h"
+#include "decompress.h"
 #include "pseudo_intrinsics.h"
+#include "crc32.h"
 #include "memdbg.h"
 
 #define _STR_VALUE(arg)         #arg
@@ -95,6 +101,7 @@
 static int dist_rules;
 
 static FILE *word_file = NULL;
+static int zip_type;
 static double progress = 0;
 
 static int rec_rule;
@@ -270,6 +277,273 @@ static MAYBE_INLINE int skip_lines(unsigned long n, char *line)
 	return 0;
 }
 
+/*
+ * Line index for the memory-mapped file: the number of newlines before
+ * each WL_INDEX_BLOCK bytes of it.  It's built in parallel and saved next
+ * to the wordlist, so later sessions can just load it.  With it, we can
+ * seek to any line by scanning at most one block.
+ */
+#define WL_INDEX_BLOCK          (1 << 20)
+#define WL_INDEX_MAGIC          "JtRwlix2"
+#define WL_LINE_MAX             (LINE_BUFFER_SIZE - 2)
+
+static char *wl_path;
+
+static struct {
+	int64_t blocks;
+	int64_t *lines;		/* newlines before each block, blocks + 1 */
+	int usable;		/* no line is long enough for mgetl() to split */
+} wl_index;
+
+/*
+ * Size and mtime alone miss a wordlist rewritten in place within the same
+ * second, so we also keep CRC-32s of its first and last blocks.
+ */
+struct wl_index_header {
+	char magic[8];
+	int32_t block_size, line_max;
+	int64_t file_size, mtime, blocks;
+	uint32_t head_crc, tail_crc;
+};
+
+static uint32_t wl_index_crc(char *p, int64_t size)
+{
+	CRC32_t crc;
+	unsigned char out[4];
+
+	CRC32_Init(&crc);
+	CRC32_Update(&crc, p, size);
+	CRC32_Final(out, crc);
+
+	return out[0] | out[1] << 8 | out[2] << 16 | (uint32_t)out[3] << 24;
+}
+
+static void wl_index_header(struct wl_index_header *h)
+{
+	struct stat st;
+	int64_t size;
+
+	memset(h, 0, sizeof(*h));
+	memcpy(h->magic, WL_INDEX_MAGIC, sizeof(h->magic));
+	h->block_size = WL_INDEX_BLOCK;
+	h->line_max = WL_LINE_MAX;
+	h->file_size = map_end - mem_map;
+	h->blocks = (h->file_size + WL_INDEX_BLOCK - 1) / WL_INDEX_BLOCK;
+	if (!stat(wl_path, &st))
+		h->mtime = st.st_mtime;
+
+	size = MIN(h->file_size, WL_INDEX_BLOCK);
+	h->head_crc = wl_index_crc(mem_map, size);
+	h->tail_crc = wl_index_crc(map_end - size, size);
+}
+
+static char *wl_index_name(void)
+{
+	static char name[PATH_BUFFER_SIZE];
+
+	snprintf(name, sizeof(name), "%s.jidx", wl_path);
+	return name;
+}
+
+static int wl_index_load(void)
+{
+	struct wl_index_header h, file_h;
+	FILE *file;
+	int32_t usable;
+	int ok;
+
+	if (!(file = fopen(wl_index_name(), "rb")))
+		return 0;
+
+	wl_index_header(&h);
+	ok = fread(&file_h, sizeof(file_h), 1, file) == 1 &&
+		!memcmp(&h, &file_h, sizeof(h)) &&
+		fread(&usable, sizeof(usable), 1, file) == 1;
+	if (ok) {
+		wl_index.lines = mem_alloc((h.blocks + 1) * sizeof(int64_t));
+		ok = fread(wl_index.lines, sizeof(int64_t), h.blocks + 1,
+		           file) == h.blocks + 1;
+		if (ok) {
+			wl_index.blocks = h.blocks;
+			wl_index.usable = usable;
+		} else
+			MEM_FREE(wl_index.lines);
+	}
+	fclose(file);
+
+	if (ok)
+		log_event("- Loaded line index %.100s", wl_index_name());
+	return ok;
+}
+
+/*
+ * Other sessions (e.g. the other --node's) may be reading or writing the same
+ * index, so we write it under a name of our own and rename it into place.
+ */
+static void wl_index_save(void)
+{
+	struct wl_index_header h;
+	int32_t usable = wl_index.usable;
+	char tmp_name[PATH_BUFFER_SIZE + 16];
+	FILE *file;
+	int ok;
+
+	snprintf(tmp_name, sizeof(tmp_name), "%s.%u", wl_index_name(),
+	         (unsigned int)getpid());
+	if (!(file = fopen(tmp_name, "wb"))) {
+		log_event("- Could not write line index %.100s (%s)",
+		          wl_index_name(), strerror(errno));
+		return;
+	}
+
+	wl_index_header(&h);
+	ok = fwrite(&h, sizeof(h), 1, file) == 1 &&
+		fwrite(&usable, sizeof(usable), 1, file) == 1 &&
+		fwrite(wl_index.lines, sizeof(int64_t), h.blocks + 1, file) ==
+		h.blocks + 1;
+	if (fclose(file))
+		ok = 0;
+
+#if defined (__MINGW32__) || defined (_MSC_VER)
+	if (ok)
+		unlink(wl_index_name());
+#endif
+	if (!ok || rename(tmp_name, wl_index_name()))
+		unlink(tmp_name);
+	else
+		log_event("- Saved line index %.100s", wl_index_name());
+}
+
+static void wl_index_build(void)
+{
+	int64_t blocks = (map_end - mem_map + WL_INDEX_BLOCK - 1) /
+		WL_INDEX_BLOCK;
+	int64_t *first, *last, prev, b;
+	int usable = 1;
+
+	wl_index.lines = mem_alloc((blocks + 1) * sizeof(int64_t));
+	first = mem_alloc(blocks * sizeof(int64_t));
+	last = mem_alloc(blocks * sizeof(int64_t));
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16) reduction(&:usable)
+#endif
+	for (b = 0; b < blocks; b++) {
+		char *p = mem_map + b * WL_INDEX_BLOCK;
+		char *end = b + 1 < blocks ? p + WL_INDEX_BLOCK : map_end;
+		char *nl;
+		int64_t count = 0;
+
+		first[b] = last[b] = -1;
+		while ((nl = memchr(p, '\n', end - p))) {
+			if (!count++)
+				first[b] = nl - mem_map;
+			else if (nl - p > WL_LINE_MAX)
+				usable = 0;
+			last[b] = nl - mem_map;
+			p = nl + 1;
+		}
+		wl_index.lines[b + 1] = count;
+	}
+
+	/* Prefix sums, and lengths of lines crossing block boundaries */
+	wl_index.lines[0] = 0;
+	prev = -1;
+	for (b = 0; b < blocks; b++) {
+		wl_index.lines[b + 1] += wl_index.lines[b];
+		if (first[b] >= 0) {
+			if (first[b] - prev - 1 > WL_LINE_MAX)
+				usable = 0;
+			prev = last[b];
+		}
+	}
+	if (map_end - mem_map - prev - 1 > WL_LINE_MAX)
+		usable = 0;
+
+	MEM_FREE(last);
+	MEM_FREE(first);
+
+	wl_index.blocks = blocks;
+	wl_index.usable = usable;
+	log_event("- Built line index: "LLd" lines%s",
+	          (long long)wl_index.lines[blocks],
+	          usable ? "" : " (too long lines, not used for seeking)");
+}
+
+/*
+ * Returns non-zero if we have an index we can seek with, building or
+ * loading it first if needed.
+ */
+static int wl_index_get(void)
+{
+	if (!mem_map || !wl_path)
+		return 0;
+
+	if (!wl_index.lines && !wl_index_load()) {
+		wl_index_build();
+		if (cfg_get_bool(SECTION_OPTIONS, NULL, "WordlistIndexFile", 0))
+			wl_index_save();
+	}
+
+	return wl_index.usable;
+}
+
+/*
+ * Returns the position in the map where mgetl() would be after reading
+ * 'line' lines from the start.
+ */
+static char *wl_index_seek(int64_t line)
+{
+	int64_t lo = 0, hi = wl_index.blocks - 1;
+	char *p;
+
+	/* Last block having fewer than 'line' newlines before it */
+	while (lo < hi) {
+		int64_t mid = (lo + hi + 1) / 2;
+
+		if (wl_index.lines[mid] < line)
+			lo = mid;
+		else
+			hi = mid - 1;
+	}
+
+	p = mem_map + lo * WL_INDEX_BLOCK;
+	line -= wl_index.lines[lo];
+	while (line-- > 0) {
+		char *nl = memchr(p, '\n', map_end - p);
+
+		if (!nl)
+			return map_end;
+		p = nl + 1;
+	}
+
+	return p;
+}
+
+/*
+ * Number of occurrences of c in a buffer, counted in parallel.
+ */
+static int64_t wl_count_char(char *buf, int64_t len, char c)
+{
+	int64_t blocks = (len + WL_INDEX_BLOCK - 1) / WL_INDEX_BLOCK;
+	int64_t b, total = 0;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16) reduction(+:total)
+#endif
+	for (b = 0; b < blocks; b++) {
+		char *p = buf + b * WL_INDEX_BLOCK;
+		char *end = b + 1 < blocks ? p + WL_INDEX_BLOCK : buf + len;
+
+		while ((p = memchr(p, c, end - p))) {
+			total++;
+			p++;
+		}
+	}
+
+	return total;
+}
+
 static void restore_line_number(void)
 {
 	char line[LINE_BUFFER_SIZE];
@@ -307,7 +581,11 @@ static int restore_state(FILE *file)
 	if (!nWordFileLines) {
 		if (mem_map) {
 			char line[LINE_BUFFER_SIZE];
-			skip_lines(rec_line, line);
+
+			if (rec_line && wl_index_get())
+				map_pos = wl_index_seek(rec_line);
+			else
+				skip_lines(rec_line, line);
 			rec_pos = 0;
 		} else if (rec_line && !rec_pos) {
 			/* from mem_map build does not have rec_pos */
@@ -404,6 +682,8 @@ static double get_progress(void)
 	} else if (mem_map) {
 		pos = map_pos - mem_map;
 		size = map_end - mem_map;
+	} else if (zip_type) {
+		dc_progress(word_file, &pos, &size);
 	} else {
 		pos = jtr_ftell64(word_file);
 		jtr_fseek64(word_file, 0, SEEK_END);
@@ -499,6 +779,98 @@ static MAYBE_INLINE char *convert(char *line)
 	return line;
 }
 
+/*
+ * Parallel version of loading this node's share of a memory-mapped wordlist
+ * to memory, for when no conversion is needed.  Each thread handles the
+ * lines starting in its index blocks, knowing their line numbers from the
+ * index: one pass for sizes, another to copy.  Returns the number of bytes
+ * copied and sets *lines to the total line count.
+ */
+static int64_t wl_load_share(int rules, int64_t *lines)
+{
+	int64_t blocks = wl_index.blocks;
+	int64_t *offset = mem_alloc((blocks + 1) * sizeof(int64_t));
+	int64_t size;
+	int pass, bom = options.input_enc == UTF_8;
+
+	for (pass = 0; pass < 2; pass++) {
+		int64_t b;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+		for (b = 0; b < blocks; b++) {
+			char *p = mem_map + b * WL_INDEX_BLOCK;
+			char *end = b + 1 < blocks ? p + WL_INDEX_BLOCK : map_end;
+			char *dest = pass ? word_file_str + offset[b] : NULL;
+			int64_t number = wl_index.lines[b], bytes = 0;
+
+			/* Find the first line starting in this block */
+			if (b) {
+				char *nl = memchr(p - 1, '\n', end - p + 1);
+
+				if (!nl)
+					p = end;
+				else {
+					number += (nl >= p);
+					p = nl + 1;
+				}
+			}
+
+			while (p < end) {
+				char *eol = memchr(p, '\n', map_end - p);
+				char *next = eol ? eol + 1 : map_end;
+				int for_node = number++ % options.node_count + 1;
+				char *nul;
+				int64_t len;
+
+				if (!eol)
+					eol = map_end;
+				if (eol > p && eol[-1] == '\r')
+					eol--;
+				if (bom && eol - p >= 3 &&
+				    !memcmp(p, "\xEF\xBB\xBF", 3))
+					p += 3;
+				if ((eol - p >= 9 && !memcmp(p, "#!comment", 9)) ||
+				    for_node < options.node_min ||
+				    for_node > options.node_max) {
+					p = next;
+					continue;
+				}
+				if ((nul = memchr(p, 0, eol - p)))
+					eol = nul;
+				len = eol - p;
+				if (!rules && len > length)
+					len = length;
+				if (dest) {
+					memcpy(dest, p, len);
+					dest[len] = '\n';
+					dest += len + 1;
+				}
+				bytes += len + 1;
+				p = next;
+			}
+			if (!pass)
+				offset[b + 1] = bytes;
+		}
+
+		if (!pass) {
+			offset[0] = 0;
+			for (b = 0; b < blocks; b++)
+				offset[b + 1] += offset[b];
+			word_file_str = mem_alloc_tiny(offset[blocks] +
+			                               LINE_BUFFER_SIZE + 1,
+			                               MEM_ALIGN_NONE);
+		}
+	}
+
+	size = offset[blocks];
+	MEM_FREE(offset);
+	*lines = wl_index.lines[blocks] + (map_end[-1] != '\n');
+
+	return size;
+}
+
 static unsigned int hash_log, hash_size, hash_mask;
 #define ENTRY_END_HASH	0xFFFFFFFF
 #define ENTRY_END_LIST	0xFFFFFFFE
@@ -663,6 +1035,7 @@ void do_wordlist_crack(struct db_main *db, char *name, int rules)
 	if (options.flags & FLG_STACKED)
 		options.max_fix_state_delay = 0;
 
+	zip_type = DC_NONE;
 	if (name) {
 		char *cp, csearch;
 		int64_t ourshare = 0;
@@ -672,11 +1045,19 @@ void do_wordlist_crack(struct db_main *db, char *name, int rules)
 		log_event("- %s file: %.100s",
 		          loopBack ? "Loopback pot" : "Wordlist",
 		          path_expand(name));
+		wl_path = str_alloc_copy(path_expand(name));
 
 		jtr_fseek64(word_file, 0, SEEK_END);
 		if ((file_len = jtr_ftell64(word_file)) == -1)
 			pexit(STR_MACRO(jtr_ftell64));
 		jtr_fseek64(word_file, 0, SEEK_SET);
+
+		/* Compressed wordlists are decompressed as they're read,
+		   through a stream that is otherwise used like the file.
+		   file_len is -1 if the decompressed size isn't known. */
+		if (!loopBack && (zip_type = dc_detect(word_file)))
+			word_file = dc_open(word_file, zip_type, &file_len);
+
 		if (file_len == 0 && !loopBack) {
 			if (john_main_process)
 				fprintf(stderr, "Error, dictionary file is "
@@ -685,7 +1066,8 @@ void do_wordlist_crack(struct db_main *db, char *name, int rules)
 		}
 
 #ifdef HAVE_MMAP
-		if (cfg_get_bool(SECTION_OPTIONS, NULL, "WordlistMemoryMap", 1))
+		if (!zip_type &&
+		    cfg_get_bool(SECTION_OPTIONS, NULL, "WordlistMemoryMap", 1))
 		{
 			log_event("- memory mapping wordlist ("LLd" bytes)",
 			          (long long)file_len);
@@ -721,7 +1103,8 @@ void do_wordlist_crack(struct db_main *db, char *name, int rules)
 			(options.node_max - options.node_min + 1)
 			: file_len;
 
-		if (ourshare < options.max_wordfile_memory &&
+		if (file_len >= 0 &&
+		    ourshare < options.max_wordfile_memory &&
 		    mem_saving_level < 2 &&
 		    (options.flags & FLG_RULES))
 			forceLoad = 1;
@@ -735,66 +1118,74 @@ void do_wordlist_crack(struct db_main *db, char *name, int rules)
 			// Load only this node's share of words to memory
 			if (mem_map && options.node_count > 1 &&
 			    (file_len > options.node_count * (length * 100))) {
-				/* Check net size for our share. */
-				for (nWordFileLines = 0;; ++nWordFileLines) {
-					char *lp;
-					int for_node = nWordFileLines %
-						options.node_count + 1;
-					int skip =
-						for_node < options.node_min ||
-						for_node > options.node_max;
-
-					if (!mgetl(line))
-						break;
-					check_bom(line);
-					if (!strncmp(line, "#!comment", 9))
-						continue;
-					lp = convert(line);
-					if (!rules)
-						lp[length] = 0;
-					if (!skip)
-						my_size += strlen(lp) + 1;
-				}
-				map_pos = mem_map;
-
-				// Now copy just our share to memory
-				word_file_str =
-					mem_alloc_tiny(my_size +
-					               LINE_BUFFER_SIZE + 1,
-					               MEM_ALIGN_NONE);
-				i = 0;
-				for (myWordFileLines = 0;; ++myWordFileLines) {
-					char *lp;
-					int for_node = myWordFileLines %
-						options.node_count + 1;
-					int skip =
-						for_node < options.node_min ||
-						for_node > options.node_max;
-
-					if (!mgetl(line))
-						break;
-					check_bom(line);
-					if (!strncmp(line, "#!comment", 9))
-						continue;
-					lp = convert(line);
-					if (!rules)
-						lp[length] = 0;
-					if (!skip) {
-						strcpy(&word_file_str[i], lp);
-						i += strlen(lp);
-						word_file_str[i++] = '\n';
+				if (!loopBack &&
+				    options.input_enc == options.target_enc &&
+				    wl_index_get()) {
+					my_size = wl_load_share(rules,
+					                        &nWordFileLines);
+					myWordFileLines = nWordFileLines;
+				} else {
+					/* Check net size for our share. */
+					for (nWordFileLines = 0;; ++nWordFileLines) {
+						char *lp;
+						int for_node = nWordFileLines %
+							options.node_count + 1;
+						int skip =
+							for_node < options.node_min ||
+							for_node > options.node_max;
+
+						if (!mgetl(line))
+							break;
+						check_bom(line);
+						if (!strncmp(line, "#!comment", 9))
+							continue;
+						lp = convert(line);
+						if (!rules)
+							lp[length] = 0;
+						if (!skip)
+							my_size += strlen(lp) + 1;
 					}
-					if (i > my_size) {
-						fprintf(stderr,
-						        "Error: wordlist grew "
-						        "as we read it - "
-						        "aborting\n");
-						error();
+					map_pos = mem_map;
+
+					// Now copy just our share to memory
+					word_file_str =
+						mem_alloc_tiny(my_size +
+						               LINE_BUFFER_SIZE + 1,
+						               MEM_ALIGN_NONE);
+					i = 0;
+					for (myWordFileLines = 0;; ++myWordFileLines) {
+						char *lp;
+						int for_node = myWordFileLines %
+							options.node_count + 1;
+						int skip =
+							for_node < options.node_min ||
+							for_node > options.node_max;
+
+						if (!mgetl(line))
+							break;
+						check_bom(line);
+						if (!strncmp(line, "#!comment", 9))
+							continue;
+						lp = convert(line);
+						if (!rules)
+							lp[length] = 0;
+						if (!skip) {
+							strcpy(&word_file_str[i], lp);
+							i += strlen(lp);
+							word_file_str[i++] = '\n';
+						}
+						if (i > my_size) {
+							fprintf(stderr,
+							        "Error: wordlist grew "
+							        "as we read it - "
+							        "aborting\n");
+							error();
+						}
 					}
+					if (nWordFileLines != myWordFileLines)
+					fprintf(stderr, "Warning: wordlist changed as"
+					        " we read it\n");
 				}
-				if (nWordFileLines != myWordFileLines)
-				fprintf(stderr, "Warning: wordlist changed as"
-				        " we read it\n");
 				log_event("- loaded this node's share of "
 				          "wordfile %s into memory "
 				          "(%lu bytes of "LLd", max_size="Zu
@@ -847,9 +1238,8 @@ void do_wordlist_crack(struct db_main *db, char *name, int rules)
 				csearch = '\r';
 				cp = memchr(word_file_str, csearch, (size_t)file_len);
 			}
-			for (nWordFileLines = 0; cp; ++nWordFileLines)
-				cp = memchr(&cp[1], csearch, (size_t)(file_len -
-				            (cp - word_file_str) - 1));
+			nWordFileLines = cp ?
+				wl_count_char(word_file_str, file_len, csearch) : 0;
 			if (aep[-1] != csearch)
 				++nWordFileLines;
 			words = mem_alloc((nWordFileLines + 1) * sizeof(char*));
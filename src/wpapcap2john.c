@@ -7,24 +7,41 @@
  */
 
 #define __STDC_FORMAT_MACROS
+#if AC_BUILT
+#include "autoconfig.h"
+#endif
+
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 #include <stddef.h>
 #include <inttypes.h>
+#if HAVE_MMAP
+#include <sys/mman.h>
+#endif
 
 //#define WPADEBUG 1
 #define IGNORE_MSG1 0
 #define IGNORE_MSG2 0
 #define IGNORE_MSG3 0
 
+#define NEED_OS_FORK
+#include "os.h"
+
+#if OS_FORK
+#include <sys/wait.h>
+#endif
+
 #include "wpapcap2john.h"
 #include "jumbo.h"
 #include "memdbg.h"
 
 static size_t max_essids = 1024; /* Will grow automagically */
 
-static int GetNextPacket(FILE *in);
+/* Buckets in the BSSID index of wpa[] */
+#define BSSID_HASH_SIZE		0x10000
+
+static int GetNextPacket(void);
 static int ProcessPacket();
 static void HandleBeacon(uint16_t subtype, int has_ht);
 static void Handle4Way(int is_qos);
@@ -48,6 +65,31 @@ static int warn_wpaclean;
 static int warn_snaplen;
 static int verbosity = 1;
 
+/* wpa[] entries by BSSID hash, newest first, -1 terminated */
+static int *bssid_hash;
+
+/*
+ * The current capture file, memory mapped when possible.  Packets are then
+ * processed where they are (mapped private, so we may modify them) instead
+ * of being read into a buffer one by one.
+ */
+static struct {
+	FILE *file;
+	uint8_t *map;
+	uint64_t size, pos;
+	uint8_t *buf;
+	size_t buf_size;
+} input;
+
+/* pcapng, and the interfaces seen in its current section */
+static int pcapng;
+static struct {
+	int supported;
+	uint32_t link_type;
+	uint64_t ts_res; /* timestamp units per second */
+} *iface;
+static uint32_t niface, iface_alloc;
+
 // These 2 functions output data properly for JtR, in base-64 format. These
 // were taken from hccap2john.c source, and modified for this project.
 static int code_block(unsigned char *in, unsigned char b, char *cp)
@@ -102,6 +144,60 @@ static void allocate_more_memory(void)
 	memset(wpa + old_max, 0, sizeof(WPA4way_t) * old_max);
 }
 
+static void init_db(void)
+{
+	wpa = calloc(max_essids, sizeof(WPA4way_t));
+	bssid_hash = malloc(BSSID_HASH_SIZE * sizeof(*bssid_hash));
+	if (!wpa || !bssid_hash)
+		alloc_error();
+	memset(bssid_hash, 0xff, BSSID_HASH_SIZE * sizeof(*bssid_hash));
+}
+
+static unsigned int hash_bssid(const char *bssid)
+{
+	unsigned int hash = 2166136261U;
+
+	while (*bssid)
+		hash = (hash ^ (unsigned char)*bssid++) * 16777619U;
+
+	return hash & (BSSID_HASH_SIZE - 1);
+}
+
+// Next older wpa[] entry for this BSSID, or -1
+static int next_bssid(const char *bssid, int i)
+{
+	while ((i = wpa[i].hash_next) >= 0 && strcmp(bssid, wpa[i].bssid))
+		;
+	return i;
+}
+
+// Newest wpa[] entry for this BSSID, or -1
+static int first_bssid(const char *bssid)
+{
+	int i = bssid_hash[hash_bssid(bssid)];
+
+	if (i >= 0 && strcmp(bssid, wpa[i].bssid))
+		i = next_bssid(bssid, i);
+	return i;
+}
+
+static int add_essid(const char *essid, const char *bssid, int prio)
+{
+	unsigned int hash = hash_bssid(bssid);
+	int i = nwpa;
+
+	wpa[i].prio = prio;
+	strcpy(wpa[i].essid, essid);
+	strcpy(wpa[i].bssid, bssid);
+	wpa[i].hash_next = bssid_hash[hash];
+	bssid_hash[hash] = i;
+
+	if (++nwpa >= max_essids)
+		allocate_more_memory();
+
+	return i;
+}
+
 // Convert WPA handshakes from aircrack-ng (airodump-ng) IVS2 to JtR format
 static int convert_ivs2(FILE *f_in)
 {
@@ -202,7 +298,7 @@ static int convert_ivs2(FILE *f_in)
 			p += len;
 
 			// Check if already in db
-			for (i = nwpa - 1; i >= 0; --i) {
+			for (i = first_bssid(bssid); i >= 0; i = next_bssid(bssid, i)) {
 				if (!strcmp(bssid, wpa[i].bssid) && !strcmp(essid, wpa[i].essid)) {
 					ess = i;
 
@@ -218,19 +314,13 @@ static int convert_ivs2(FILE *f_in)
 
 			// New entry
 			if (ess < 0) {
-				ess = nwpa;
-				wpa[nwpa].prio = 5;
-				strcpy(wpa[nwpa].essid, essid);
-				strcpy(wpa[nwpa].bssid, bssid);
+				ess = add_essid(essid, bssid, 5);
 
 				fprintf(stderr, "ivs2 '%s' at %s\n", essid, bssid);
-
-				if (++nwpa >= max_essids)
-					allocate_more_memory();
 			}
 		} else if (bssidFound && ess < 0) {
 			// Check if already in db
-			for (i = nwpa - 1; i >= 0; --i) {
+			for (i = first_bssid(bssid); i >= 0; i = next_bssid(bssid, i)) {
 				if (!strcmp(bssid, wpa[i].bssid)) {
 					fprintf(stderr, "ESSID (from db): '%s' at %s\n", wpa[i].essid, wpa[i].bssid);
 					ess = i;
@@ -361,21 +451,133 @@ static void dump_any_unver() {
 	}
 }
 
+static void input_open(FILE *file)
+{
+	input.file = file;
+	input.map = NULL;
+	input.pos = 0;
+
+	jtr_fseek64(file, 0, SEEK_END);
+	input.size = jtr_ftell64(file);
+	jtr_fseek64(file, 0, SEEK_SET);
+
+#if HAVE_MMAP
+	/* Private and writable, as some packets are modified in place */
+	if (input.size > 0 && input.size == (size_t)input.size) {
+		input.map = mmap(NULL, input.size, PROT_READ | PROT_WRITE,
+		                 MAP_PRIVATE, fileno(file), 0);
+		if (input.map == MAP_FAILED)
+			input.map = NULL;
+	}
+#endif
+}
+
+static void input_rewind(void)
+{
+	input.pos = 0;
+	if (!input.map)
+		jtr_fseek64(input.file, 0, SEEK_SET);
+}
+
+static void input_close(void)
+{
+#if HAVE_MMAP
+	if (input.map)
+		munmap(input.map, input.size);
+#endif
+	input.map = NULL;
+	fclose(input.file);
+}
+
+/*
+ * Returns a pointer to the next len bytes of input, or NULL if there aren't
+ * that many left.  The data stays valid until the next call.
+ */
+static uint8_t *get_bytes(size_t len)
+{
+	uint8_t *p;
+
+	if (input.map) {
+		if (len > input.size - input.pos)
+			return NULL;
+		p = input.map + input.pos;
+		input.pos += len;
+		return p;
+	}
+
+	if (len > input.buf_size) {
+		MEM_FREE(input.buf);
+		input.buf_size = len > 0x10000 ? len : 0x10000;
+		safe_malloc(input.buf, input.buf_size);
+	}
+	if (fread(input.buf, 1, len, input.file) != len)
+		return NULL;
+	input.pos += len;
+	return input.buf;
+}
+
+static int check_link_type(uint32_t type)
+{
+	if (type == LINKTYPE_IEEE802_11)
+		fprintf(stderr, "\nFile %s: raw 802.11\n", filename);
+	else if (type == LINKTYPE_PRISM_HEADER)
+		fprintf(stderr, "\nFile %s: Prism headers stripped\n", filename);
+	else if (type == LINKTYPE_RADIOTAP_HDR)
+		fprintf(stderr, "\nFile %s: Radiotap headers stripped\n", filename);
+	else if (type == LINKTYPE_PPI_HDR)
+		fprintf(stderr, "\nFile %s: PPI headers stripped\n", filename);
+	else if (type == LINKTYPE_ETHERNET)
+		fprintf(stderr, "\nFile %s: Ethernet headers, non-monitor mode. Use of -e option likely required.\n", filename);
+	else {
+		fprintf(stderr, "\nFile %s: No 802.11 wireless traffic data (network %d)\n", filename, type);
+		return 0;
+	}
+	return 1;
+}
+
 static int Process(FILE *in)
 {
 	pcap_hdr_t main_hdr;
+	uint8_t *p;
+	uint32_t magic;
 
-	if (fread(&main_hdr, 1, sizeof(pcap_hdr_t), in) != sizeof(pcap_hdr_t)) {
+	input_open(in);
+	pcapng = 0;
+
+	if (!(p = get_bytes(4))) {
 		fprintf(stderr,
 			"%s: Error, could not read enough bytes to get a common 'main' pcap header\n",
 			filename);
 		return 0;
 	}
-	if (main_hdr.magic_number == 0xa1b2c3d4)
-		bROT = 0;
-	else if (main_hdr.magic_number == 0xd4c3b2a1)
-		bROT = 1;
-	else {
+	memcpy(&magic, p, 4);
+	input_rewind();
+
+	if (magic == PCAPNG_SHB) {
+		pcapng = 1;
+		niface = 0;
+		fprintf(stderr, "\nFile %s: pcapng\n", filename);
+	} else if (magic == 0xa1b2c3d4 || magic == 0xd4c3b2a1) {
+		if (!(p = get_bytes(sizeof(pcap_hdr_t)))) {
+			fprintf(stderr,
+				"%s: Error, could not read enough bytes to get a common 'main' pcap header\n",
+				filename);
+			return 0;
+		}
+		memcpy(&main_hdr, p, sizeof(pcap_hdr_t));
+		bROT = (magic == 0xd4c3b2a1);
+		if (bROT) {
+			main_hdr.magic_number = swap32u(main_hdr.magic_number);
+			main_hdr.version_major = swap16u(main_hdr.version_major);
+			main_hdr.version_minor = swap16u(main_hdr.version_minor);
+			main_hdr.sigfigs = swap32u(main_hdr.sigfigs);
+			main_hdr.snaplen = swap32u(main_hdr.snaplen);
+			main_hdr.network = swap32u(main_hdr.network);
+		}
+		link_type = main_hdr.network;
+		if (!check_link_type(link_type))
+			return 0;
+	} else {
 		if (convert_ivs2(in)) {
 			fprintf(stderr, "%s: not a .ivs v2 file\n", filename);
 			return 0;
@@ -383,31 +585,7 @@ static int Process(FILE *in)
 		return 1;
 	}
 
-	if (bROT) {
-		main_hdr.magic_number = swap32u(main_hdr.magic_number);
-		main_hdr.version_major = swap16u(main_hdr.version_major);
-		main_hdr.version_minor = swap16u(main_hdr.version_minor);
-		main_hdr.sigfigs = swap32u(main_hdr.sigfigs);
-		main_hdr.snaplen = swap32u(main_hdr.snaplen);
-		main_hdr.network = swap32u(main_hdr.network);
-	}
-	link_type = main_hdr.network;
-	if (link_type == LINKTYPE_IEEE802_11)
-		fprintf(stderr, "\nFile %s: raw 802.11\n", filename);
-	else if (link_type == LINKTYPE_PRISM_HEADER)
-		fprintf(stderr, "\nFile %s: Prism headers stripped\n", filename);
-	else if (link_type == LINKTYPE_RADIOTAP_HDR)
-		fprintf(stderr, "\nFile %s: Radiotap headers stripped\n", filename);
-	else if (link_type == LINKTYPE_PPI_HDR)
-		fprintf(stderr, "\nFile %s: PPI headers stripped\n", filename);
-	else if (link_type == LINKTYPE_ETHERNET)
-		fprintf(stderr, "\nFile %s: Ethernet headers, non-monitor mode. Use of -e option likely required.\n", filename);
-	else {
-		fprintf(stderr, "\nFile %s: No 802.11 wireless traffic data (network %d)\n", filename, link_type);
-		return 0;
-	}
-
-	while (GetNextPacket(in)) {
+	while (GetNextPacket()) {
 		if (!ProcessPacket()) {
 			break;
 		}
@@ -418,17 +596,157 @@ static int Process(FILE *in)
 	return 1;
 }
 
-static int GetNextPacket(FILE *in)
+static uint16_t ng16(const uint8_t *p)
+{
+	uint16_t v;
+
+	memcpy(&v, p, 2);
+	return bROT ? swap16u(v) : v;
+}
+
+static uint32_t ng32(const uint8_t *p)
 {
-	size_t read_size;
+	uint32_t v;
 
-	if (fread(&pkt_hdr, 1, sizeof(pkt_hdr), in) != sizeof(pkt_hdr)) return 0;
+	memcpy(&v, p, 4);
+	return bROT ? swap32u(v) : v;
+}
 
-	if (bROT) {
-		pkt_hdr.ts_sec = swap32u(pkt_hdr.ts_sec);
-		pkt_hdr.ts_usec = swap32u(pkt_hdr.ts_usec);
-		pkt_hdr.incl_len = swap32u(pkt_hdr.incl_len);
-		pkt_hdr.orig_len = swap32u(pkt_hdr.orig_len);
+/*
+ * Reads an Interface Description Block body: link type, reserved, snaplen,
+ * then options.  Only the timestamp resolution option is of interest.
+ */
+static void pcapng_interface(const uint8_t *body, uint32_t len)
+{
+	uint32_t pos = 8;
+
+	if (niface == iface_alloc) {
+		iface_alloc = iface_alloc ? 2 * iface_alloc : 8;
+		safe_realloc(iface, iface_alloc * sizeof(*iface));
+	}
+	iface[niface].link_type = ng16(body);
+	iface[niface].ts_res = 1000000;
+
+	while (pos + 4 <= len) {
+		uint16_t code = ng16(body + pos);
+		uint16_t olen = ng16(body + pos + 2);
+
+		if (!code || pos + 4 + olen > len)
+			break;
+		if (code == PCAPNG_IF_TSRESOL && olen >= 1) {
+			uint8_t res = body[pos + 4];
+			uint64_t ts_res = 1;
+
+			if (res & 0x80) {
+				if ((res & 0x7f) < 64)
+					ts_res <<= res & 0x7f;
+			} else
+				while (res-- && ts_res < 1000000000000000000ULL)
+					ts_res *= 10;
+			iface[niface].ts_res = ts_res;
+		}
+		pos += 4 + ((olen + 3) & ~3);
+	}
+
+	link_type = iface[niface].link_type;
+	iface[niface].supported = check_link_type(link_type);
+	niface++;
+}
+
+/*
+ * Sets up pkt_hdr and full_packet from the next packet block of a pcapng
+ * file, skipping blocks we have no use for.
+ */
+static int GetNextPacketNG(void)
+{
+	uint8_t *p, *body;
+	uint32_t type, len;
+
+	while ((p = get_bytes(8))) {
+		memcpy(&type, p, 4);
+		if (type == PCAPNG_SHB) {
+			uint32_t order;
+
+			memcpy(&len, p + 4, 4);
+			if (!(p = get_bytes(4)))
+				break;
+			memcpy(&order, p, 4);
+			if (order == PCAPNG_BYTE_ORDER)
+				bROT = 0;
+			else if (order == swap32u(PCAPNG_BYTE_ORDER))
+				bROT = 1;
+			else {
+				fprintf(stderr, "%s: Invalid pcapng byte order magic\n", filename);
+				return 0;
+			}
+			if (bROT)
+				len = swap32u(len);
+			niface = 0;
+			if (len < 16 || len & 3 || !get_bytes(len - 12))
+				break;
+			continue;
+		}
+
+		type = ng32(p);
+		len = ng32(p + 4);
+		if (len < 12 || len & 3 || !(body = get_bytes(len - 8)))
+			break;
+		len -= 12; /* body, without the trailing length */
+
+		if (type == PCAPNG_IDB && len >= 8) {
+			pcapng_interface(body, len);
+		} else if (type == PCAPNG_EPB && len >= 20) {
+			uint32_t id = ng32(body);
+			uint64_t ts = (uint64_t)ng32(body + 4) << 32 | ng32(body + 8);
+
+			if (id >= niface || !iface[id].supported)
+				continue;
+			pkt_hdr.incl_len = ng32(body + 12);
+			pkt_hdr.orig_len = ng32(body + 16);
+			if (pkt_hdr.incl_len > len - 20)
+				break;
+			pkt_hdr.ts_sec = ts / iface[id].ts_res;
+			pkt_hdr.ts_usec = ts % iface[id].ts_res * 1000000 /
+				iface[id].ts_res;
+			link_type = iface[id].link_type;
+			full_packet = body + 20;
+			return 1;
+		} else if (type == PCAPNG_SPB && len >= 4) {
+			/* No timestamp: keep that of the previous packet */
+			if (!niface || !iface[0].supported)
+				continue;
+			pkt_hdr.orig_len = ng32(body);
+			pkt_hdr.incl_len = pkt_hdr.orig_len < len - 4 ?
+				pkt_hdr.orig_len : len - 4;
+			link_type = iface[0].link_type;
+			full_packet = body + 4;
+			return 1;
+		}
+	}
+
+	if (input.pos < input.size)
+		fprintf(stderr, "%s: truncated last block\n", filename);
+	return 0;
+}
+
+static int GetNextPacket(void)
+{
+	if (pcapng) {
+		if (!GetNextPacketNG())
+			return 0;
+	} else {
+		uint8_t *p = get_bytes(sizeof(pkt_hdr));
+
+		if (!p)
+			return 0;
+		memcpy(&pkt_hdr, p, sizeof(pkt_hdr));
+
+		if (bROT) {
+			pkt_hdr.ts_sec = swap32u(pkt_hdr.ts_sec);
+			pkt_hdr.ts_usec = swap32u(pkt_hdr.ts_usec);
+			pkt_hdr.incl_len = swap32u(pkt_hdr.incl_len);
+			pkt_hdr.orig_len = swap32u(pkt_hdr.orig_len);
+		}
 	}
 
 	if (pkt_hdr.ts_sec == 0 && pkt_hdr.ts_usec == 0 && !warn_wpaclean++)
@@ -450,13 +768,15 @@ static int GetNextPacket(FILE *in)
 		cur_u += 1000000;
 	}
 
-	MEM_FREE(full_packet);
-	safe_malloc(full_packet, pkt_hdr.incl_len);
-	read_size = fread(full_packet, 1, pkt_hdr.incl_len, in);
-	if (read_size < pkt_hdr.incl_len)
+	if (pcapng)
+		return 1;
+
+	if (!(full_packet = get_bytes(pkt_hdr.incl_len))) {
 		fprintf(stderr, "%s: truncated last packet\n", filename);
+		return 0;
+	}
 
-	return (read_size == pkt_hdr.incl_len);
+	return 1;
 }
 
 // Fake 802.11 header. We use this when indata is Ethernet (not monitor mode)
@@ -710,10 +1030,7 @@ static void ManualBeacon(char *essid_bssid)
 	bssid = strupr(bssid);
 	fprintf(stderr, "Learned BSSID %s ESSID '%s' from command-line option\n",
 	        bssid, essid);
-	strcpy(wpa[nwpa].essid, essid);
-	strcpy(wpa[nwpa].bssid, bssid);
-	if (++nwpa >= max_essids)
-		allocate_more_memory();
+	add_essid(essid, bssid, 0);
 }
 
 static void HandleBeacon(uint16_t subtype, int has_ht)
@@ -805,7 +1122,7 @@ static void HandleBeacon(uint16_t subtype, int has_ht)
 	}
 
 	// Check if already in db, or older entry has worse prio
-	for (i = nwpa - 1; i >= 0; --i) {
+	for (i = first_bssid(bssid); i >= 0; i = next_bssid(bssid, i)) {
 		if (!strcmp(bssid, wpa[i].bssid) && !strcmp(essid, wpa[i].essid)) {
 			if (wpa[i].prio > prio) {
 				fprintf(stderr, "%s '%s' at %s (prio %d -> %d)\n",
@@ -825,14 +1142,9 @@ static void HandleBeacon(uint16_t subtype, int has_ht)
 		}
 	}
 
-	wpa[nwpa].prio = prio;
-	strcpy(wpa[nwpa].essid, essid);
-	strcpy(wpa[nwpa].bssid, bssid);
+	add_essid(essid, bssid, prio);
 
 	fprintf(stderr, "%s '%s' at %s\n", ctl_subtype[subtype], essid, bssid);
-
-	if (++nwpa >= max_essids)
-		allocate_more_memory();
 }
 
 static int is_zero(void *ptr, size_t len)
@@ -848,7 +1160,7 @@ static int is_zero(void *ptr, size_t len)
 static void Handle4Way(int is_qos)
 {
 	ieee802_1x_frame_hdr_t *pkt = (ieee802_1x_frame_hdr_t*)packet;
-	int i, ess = -1;
+	int ess = -1;
 	uint8_t *p = (uint8_t*)&packet[sizeof(ieee802_1x_frame_hdr_t)];
 	uint8_t *end = packet + pkt_hdr.incl_len;
 	ieee802_1x_eapol_t *auth;
@@ -861,12 +1173,7 @@ static void Handle4Way(int is_qos)
 	// Also, if we find it, we may determine that we're done with it already
 
 	to_bssid(bssid, pkt->addr3);
-	for (i = nwpa - 1; i >= 0; --i) {
-		if (!strcmp(bssid, wpa[i].bssid)) {
-			ess = i;
-			break;
-		}
-	}
+	ess = first_bssid(bssid);
 	if (ess == -1) {
 		fprintf(stderr, "EAPOL for BSSID %s - unknown ESSID. Perhaps -e option needed?\n", bssid);
 		return;
@@ -1328,39 +1635,171 @@ int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
 	write(fd, data, size);
 	close(fd);
 
-	wpa = calloc(max_essids, sizeof(WPA4way_t));
+	init_db();
 
 	in = fopen(filename = name, "rb");
 	if (in) {
 		if ((base = strrchr(filename, '/')))
 			filename = ++base;
 		Process(in);
-		fclose(in);
+		input_close();
 	} else
 		fprintf(stderr, "Error, file %s not found\n", name);
 	fprintf(stderr, "\n%d ESSIDS processed\n", nwpa);
 	remove(name);
 
 	free(wpa);
+	free(bssid_hash);
 
 	return 0;
 }
 #endif
 
+static void process_file(char *name)
+{
+	FILE *in;
+	char *base;
+	int j;
+
+	// Re-init between pcap files
+	warn_snaplen = 0;
+	warn_wpaclean = 0;
+	start_t = start_u = 0;
+	pkt_num = 0;
+	for (j = 0; j < nwpa; j++)
+		wpa[j].prio = 5;
+
+	in = fopen(filename = name, "rb");
+	if (in) {
+		if ((base = strrchr(filename, '/')))
+			filename = ++base;
+		Process(in);
+		input_close();
+	} else
+		fprintf(stderr, "Error, file %s not found\n", name);
+}
+
+#if OS_FORK
+struct job {
+	pid_t pid;
+	int done, status;
+	FILE *out, *err, *count;
+};
+
+static void copy_output(FILE *from, FILE *to)
+{
+	char buf[4096];
+	size_t len;
+
+	rewind(from);
+	while ((len = fread(buf, 1, sizeof(buf), from)))
+		fwrite(buf, 1, len, to);
+	fclose(from);
+	fflush(to);
+}
+
+/*
+ * Processes up to "jobs" files at once, each in a child process of its own.
+ * The children's output is kept in temporary files and copied out in the
+ * order the files were given.  Each child starts from our state and sends
+ * none of its own back, so unlike a serial run a file doesn't know about the
+ * files before it: it can't use their ESSIDs, it can't complete a handshake
+ * that one of them started, and a network they already got a complete
+ * handshake for is output again.  -h says so, too.
+ *
+ * Returns the number of ESSIDs seen, and sets *failed if a child failed.
+ */
+static int process_parallel(char **name, int count, int jobs, int *failed)
+{
+	struct job *job;
+	int next = 0, running = 0, flushed = 0, total = nwpa;
+
+	if (!(job = calloc(count, sizeof(*job))))
+		alloc_error();
+
+	fflush(stdout);
+	fflush(stderr);
+
+	while (flushed < count) {
+		pid_t pid;
+		int i, n, status;
+
+		while (next < count && running < jobs) {
+			struct job *j = &job[next];
+
+			if (!(j->out = tmpfile()) || !(j->err = tmpfile()) ||
+			    !(j->count = tmpfile())) {
+				perror("tmpfile");
+				exit(EXIT_FAILURE);
+			}
+			if ((j->pid = fork()) < 0) {
+				perror("fork");
+				exit(EXIT_FAILURE);
+			}
+			if (!j->pid) {
+				n = nwpa;
+				dup2(fileno(j->out), fileno(stdout));
+				dup2(fileno(j->err), fileno(stderr));
+				process_file(name[next]);
+				fprintf(j->count, "%d\n", nwpa - n);
+				fflush(NULL);
+				_exit(0);
+			}
+			next++;
+			running++;
+		}
+
+		if ((pid = wait(&status)) < 0) {
+			perror("wait");
+			exit(EXIT_FAILURE);
+		}
+		for (i = 0; i < next; i++)
+			if (job[i].pid == pid && !job[i].done) {
+				job[i].done = 1;
+				job[i].status = status;
+				running--;
+				break;
+			}
+
+		while (flushed < next && job[flushed].done) {
+			struct job *j = &job[flushed++];
+
+			copy_output(j->out, stdout);
+			copy_output(j->err, stderr);
+			rewind(j->count);
+			if (fscanf(j->count, "%d", &n) == 1)
+				total += n;
+			fclose(j->count);
+
+			if (WIFSIGNALED(j->status)) {
+				fprintf(stderr, "Error, processing %s was killed "
+				        "by signal %d, its output may be incomplete\n",
+				        name[j - job], WTERMSIG(j->status));
+				*failed = 1;
+			} else if (WEXITSTATUS(j->status)) {
+				fprintf(stderr, "Error, processing %s failed "
+				        "with exit status %d, its output may be "
+				        "incomplete\n",
+				        name[j - job], WEXITSTATUS(j->status));
+				*failed = 1;
+			}
+		}
+	}
+
+	free(job);
+	return total;
+}
+#endif
+
 #ifdef HAVE_LIBFUZZER
 int main_dummy(int argc, char **argv)
 #else
 int main(int argc, char **argv)
 #endif
 {
-	FILE *in;
-	int i;
-	char *base;
-
-	wpa = calloc(max_essids, sizeof(WPA4way_t));
+	int i, jobs = 1, processed, failed = 0;
 
-	if (!wpa)
-		alloc_error();
+	init_db();
 
 	if (sizeof(struct ivs2_filehdr) != 2  || sizeof(struct ivs2_pkthdr) != 4 ||
 	    sizeof(struct ivs2_WPA_hdsk) != 352 || sizeof(hccap_t) != 356+36) {
@@ -1386,6 +1825,14 @@ int main(int argc, char **argv)
 		argv++; argc--;
 	}
 
+	if (argc > 2 && !strcmp(argv[1], "-j")) {
+		jobs = atoi(argv[2]);
+		if (jobs < 1)
+			jobs = 1;
+		argv[2] = argv[0];
+		argv += 2; argc -= 2;
+	}
+
 	while (argc > 2 && !strcmp(argv[1], "-e")) {
 		argv[1] = argv[0];
 		argv++; argc--;
@@ -1396,38 +1843,39 @@ int main(int argc, char **argv)
 
 	if (argc < 2)
 		return !!fprintf(stderr,
-"Converts PCAP or IVS2 files to JtR format.\n"
+"Converts PCAP, PCAPNG or IVS2 files to JtR format.\n"
 "Supported encapsulations: 802.11, Prism, Radiotap and PPI.\n"
-"Usage: %s [-c] [-v] [-r] [-e essid:bssid [-e ...]] <file[s]>\n"
+"Usage: %s [-c] [-v] [-r] [-j N] [-e essid:bssid [-e ...]] <file[s]>\n"
 "\n-c\tShow only complete auths (incomplete ones might be wrong passwords\n"
 "\tbut we can crack what passwords were tried).\n"
 "-v\tBump verbosity\n"
 "-r\tIgnore replay-count (for use with nonce fuzzing)\n"
+"-j\tProcess up to N files in parallel.  Output is in file order, but\n"
+"\teach file is processed on its own: ESSIDs and partial handshakes\n"
+"\tare not carried over from one file to the next, and a network\n"
+"\tcan be output again for each file it has a handshake in.  Use -e\n"
+"\tfor ESSIDs only beaconed in another file, or leave out -j for\n"
+"\tcaptures split into several files.\n"
 "-e\tManually add Name:MAC pair(s) in case the file lacks beacons.\n"
 "\teg. -e \"Magnum WIFI:6d:61:67:6e:75:6d\"\n\n",
 		                 argv[0]);
 
-	for (i = 1; i < argc; i++) {
-		int j;
-
-		// Re-init between pcap files
-		warn_snaplen = 0;
-		warn_wpaclean = 0;
-		start_t = start_u = 0;
-		pkt_num = 0;
-		for (j = 0; j < nwpa; j++)
-			wpa[j].prio = 5;
-
-		in = fopen(filename = argv[i], "rb");
-		if (in) {
-			if ((base = strrchr(filename, '/')))
-				filename = ++base;
-			Process(in);
-			fclose(in);
-		} else
-			fprintf(stderr, "Error, file %s not found\n", argv[i]);
+#if OS_FORK
+	if (jobs > 1 && argc > 2)
+		processed = process_parallel(argv + 1, argc - 1, jobs,
+		                             &failed);
+	else
+#else
+	if (jobs > 1)
+		fprintf(stderr, "Warning: -j is not supported on this system\n");
+#endif
+	{
+		for (i = 1; i < argc; i++)
+			process_file(argv[i]);
+		processed = nwpa;
 	}
-	fprintf(stderr, "\n%d ESSIDS processed\n", nwpa);
+	fprintf(stderr, "\n%d ESSIDS processed\n", processed);
 	MEM_FREE(new_p);
-	return 0;
+	MEM_FREE(input.buf);
+	return failed;
 }
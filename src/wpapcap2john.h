@@ -42,6 +42,16 @@ typedef struct pcap_hdr_s {
 	uint32_t network;        /* data link type */
 } pcap_hdr_t;
 
+// pcapng block types, and the byte-order magic of a section header
+#define PCAPNG_SHB              0x0A0D0D0A
+#define PCAPNG_IDB              0x00000001
+#define PCAPNG_SPB              0x00000003
+#define PCAPNG_EPB              0x00000006
+#define PCAPNG_BYTE_ORDER       0x1A2B3C4D
+
+// pcapng interface option holding the timestamp resolution
+#define PCAPNG_IF_TSRESOL       9
+
 // PCAP packet header
 typedef struct pcaprec_hdr_s {
 	uint32_t ts_sec;         /* timestamp seconds */
@@ -206,6 +216,7 @@ typedef struct WPA4way_s {
 	int hopefully_cracked; // we have a 1 & 2
 	int eapol_sz;
 	int prio; // lower prio will overwrite higher
+	int hash_next; // next older entry in the same BSSID hash bucket
 } WPA4way_t;
 
 // Support for loading airodump-ng ivs2 files.
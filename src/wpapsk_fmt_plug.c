@@ -24,6 +24,10 @@ john_register_one(&fmt_wpapsk);
 #include "formats.h"
 #include "common.h"
 #include "misc.h"
+#include "config.h"
+#include "options.h"
+#include "path.h"
+#include "pmk_cache.h"
 //#define WPAPSK_DEBUG
 #include "wpapsk.h"
 #include "sha.h"
@@ -74,6 +78,12 @@ static unsigned char (*sse_crypt2);
 static unsigned char (*sse_crypt);
 #endif
 
+/* 0 = not opened yet, 1 = in use, -1 = disabled */
+static int pmk_cache_state;
+static int *miss_index;
+static wpapsk_password *miss_in;
+static wpapsk_hash *miss_out;
+
 static void init(struct fmt_main *self)
 {
 #ifdef _OPENMP
@@ -90,6 +100,12 @@ static void init(struct fmt_main *self)
 	                      self->params.max_keys_per_crypt);
 	mic = mem_alloc(sizeof(*mic) *
 	                self->params.max_keys_per_crypt);
+	miss_index = mem_alloc(sizeof(*miss_index) *
+	                       self->params.max_keys_per_crypt);
+	miss_in = mem_alloc(sizeof(*miss_in) *
+	                    self->params.max_keys_per_crypt);
+	miss_out = mem_alloc(sizeof(*miss_out) *
+	                     self->params.max_keys_per_crypt);
 
 #if defined (SIMD_COEF_32)
 	sse_hash1 = mem_calloc_align(self->params.max_keys_per_crypt,
@@ -128,12 +144,18 @@ static void init(struct fmt_main *self)
 
 static void done(void)
 {
+	if (pmk_cache_state > 0)
+		pmk_cache_close();
+	pmk_cache_state = 0;
 #ifdef SIMD_COEF_32
 	MEM_FREE(sse_crypt);
 	MEM_FREE(sse_crypt2);
 	MEM_FREE(sse_crypt1);
 	MEM_FREE(sse_hash1);
 #endif
+	MEM_FREE(miss_out);
+	MEM_FREE(miss_in);
+	MEM_FREE(miss_index);
 	MEM_FREE(mic);
 	MEM_FREE(outbuffer);
 	MEM_FREE(inbuffer);
@@ -358,17 +380,80 @@ static MAYBE_INLINE void wpapsk_sse(int count, wpapsk_password * in, wpapsk_hash
 }
 #endif
 
+static void wpapsk_pmk(int count, wpapsk_password *in, wpapsk_hash *out)
+{
+#ifndef SIMD_COEF_32
+	wpapsk_cpu(count, in, out, &currentsalt);
+#else
+	wpapsk_sse(count, in, out, &currentsalt);
+#endif
+}
+
+/*
+ * The cache is opened on first use in a cracking session, so that self
+ * tests and benchmarks neither depend on it nor add to it.
+ */
+static int pmk_cache_usable(void)
+{
+	extern volatile int bench_running;
+
+	if (bench_running || (options.flags & FLG_TEST_CHK))
+		return 0;
+
+	if (!pmk_cache_state) {
+		pmk_cache_state = -1;
+		if (cfg_get_bool(SECTION_OPTIONS, NULL, "WPAPMKCache", 0) &&
+		    !pmk_cache_open(path_expand(PMK_CACHE_NAME)))
+			pmk_cache_state = 1;
+	}
+
+	return pmk_cache_state > 0;
+}
+
+/*
+ * Takes the PMKs we already have from the cache, computes the rest and
+ * adds them to it.
+ */
+static void wpapsk_pmk_cached(int count)
+{
+	int index, misses = 0;
+
+	for (index = 0; index < count; index++)
+		if (!pmk_cache_lookup(hccap.essid, inbuffer[index].v,
+		                      inbuffer[index].length,
+		                      (unsigned char*)outbuffer[index].v)) {
+			miss_index[misses] = index;
+			miss_in[misses++] = inbuffer[index];
+		}
+
+	if (!misses)
+		return;
+
+/* The SIMD code always does whole groups of NBKEYS */
+	for (index = misses; index % NBKEYS; index++)
+		miss_in[index].length = 0;
+
+	wpapsk_pmk(misses, miss_in, miss_out);
+
+	for (index = 0; index < misses; index++) {
+		outbuffer[miss_index[index]] = miss_out[index];
+		pmk_cache_add(hccap.essid, miss_in[index].v,
+		              miss_in[index].length,
+		              (unsigned char*)miss_out[index].v);
+	}
+	pmk_cache_flush();
+}
+
 static int crypt_all(int *pcount, struct db_salt *salt)
 {
 	const int count = *pcount;
 	extern volatile int bench_running;
 
 	if (new_keys || strcmp(last_ssid, hccap.essid) || bench_running) {
-#ifndef SIMD_COEF_32
-		wpapsk_cpu(count, inbuffer, outbuffer, &currentsalt);
-#else
-		wpapsk_sse(count, inbuffer, outbuffer, &currentsalt);
-#endif
+		if (pmk_cache_usable())
+			wpapsk_pmk_cached(count);
+		else
+			wpapsk_pmk(count, inbuffer, outbuffer);
 		new_keys = 0;
 		strcpy(last_ssid, hccap.essid);
 	}
@@ -169,6 +169,18 @@
 #define DES_BS_VECTOR_SIZE		8
 #define DES_BS_VECTOR			5
 #define DES_BS_ALGORITHM_NAME		"DES 256/256 AVX-16 + 64/64"
+#elif __AVX512F__ || JOHN_AVX512F
+/* 512-bit as 1x512, with vpternlogd for the bitselects */
+#define DES_BS_VECTOR			8
+#undef DES_BS
+#define DES_BS				3
+#define DES_BS_ALGORITHM_NAME		"DES 512/512 AVX512F"
+#undef CPU_NAME
+#if __AVX512BW__ || JOHN_AVX512BW
+#define CPU_NAME			"AVX512BW"
+#else
+#define CPU_NAME			"AVX512F"
+#endif
 #elif __AVX2__ || JOHN_AVX2
 /* 256-bit as 1x256 */
 #define DES_BS_VECTOR			4
@@ -233,7 +245,7 @@
 #endif
 #define DES_BS_EXPAND			1
 
-#if CPU_DETECT && DES_BS == 3
+#if CPU_DETECT && DES_BS == 3 && !(__AVX512F__ || JOHN_AVX512F)
 #define CPU_REQ_XOP			1
 #undef CPU_NAME
 #define CPU_NAME			"XOP"
@@ -63,10 +63,19 @@ john_register_one(&fmt_zip);
 static int omp_t = 1;
 #endif
 #include "hmac_sha.h"
+#include "stage_stats.h"
 #include "memdbg.h"
 
 #define KEY_LENGTH(mode)        (8 * ((mode) & 3) + 8)
 #define SALT_LENGTH(mode)       (4 * ((mode) & 3) + 4)
+/*
+ * PBKDF2 output is the AES key, the HMAC key and the 2 byte password
+ * verifier.  This is the offset of the SHA-1 block holding the verifier,
+ * which also holds the end of the HMAC key.  So the first pass derives only
+ * that block, and on a verifier match the second pass derives only the HMAC
+ * key blocks before it.
+ */
+#define VERIFIER_BLOCK(mode)    (2 * KEY_LENGTH(mode) / 20 * 20)
 
 typedef struct my_salt_t {
 	dyna_salt dsalt;
@@ -104,6 +113,8 @@ typedef struct my_salt_t {
 static char (*saved_key)[PLAINTEXT_LENGTH + 1];
 static unsigned char (*crypt_key)[((WINZIP_BINARY_SIZE+3)/4)*4];
 static my_salt *saved_salt;
+static struct stage_stats stats;
+static const char *stage_names[] = { "verifier", "HMAC", NULL };
 
 
 //    filename:$zip2$*Ty*Mo*Ma*Sa*Va*Le*DF*Au*$/zip2$
@@ -138,10 +149,12 @@ static void init(struct fmt_main *self)
 	                       sizeof(*saved_key));
 	crypt_key = mem_calloc(self->params.max_keys_per_crypt,
 	                       sizeof(*crypt_key));
+	stage_stats_init(&stats, "ZIP", stage_names);
 }
 
 static void done(void)
 {
+	stage_stats_done(&stats);
 	MEM_FREE(crypt_key);
 	MEM_FREE(saved_key);
 }
@@ -272,12 +285,18 @@ static int crypt_all(int *pcount, struct db_salt *salt)
 		return count;
 	}
 
+	STAGE_STATS_TRY(&stats, count);
+
 #ifdef _OPENMP
-#pragma omp parallel for default(none) private(index) shared(count, saved_key, saved_salt, crypt_key)
+#pragma omp parallel for default(none) private(index) shared(count, saved_key, saved_salt, crypt_key, stats)
 #endif
 	for (index = 0; index < count; index += MAX_KEYS_PER_CRYPT) {
+		int key_len = KEY_LENGTH(saved_salt->v.mode);
+		int block = VERIFIER_BLOCK(saved_salt->v.mode);
+		int pos = 2 * key_len - block;
 #ifdef SIMD_COEF_32
-		unsigned char pwd_ver[64*MAX_KEYS_PER_CRYPT];
+		unsigned char verifier[MAX_KEYS_PER_CRYPT][20];
+		unsigned char hmac_key[MAX_KEYS_PER_CRYPT][KEY_LENGTH(3)];
 		int lens[MAX_KEYS_PER_CRYPT], i;
 		int something_hit = 0, hits[MAX_KEYS_PER_CRYPT] = {0};
 		unsigned char *pin[MAX_KEYS_PER_CRYPT], *pout[MAX_KEYS_PER_CRYPT];
@@ -285,27 +304,32 @@ static int crypt_all(int *pcount, struct db_salt *salt)
 		for (i = 0; i < MAX_KEYS_PER_CRYPT; ++i) {
 			lens[i] = strlen(saved_key[i+index]);
 			pin[i] = (unsigned char*)saved_key[i+index];
-			pout[i] = &pwd_ver[i*(2+2*KEY_LENGTH(saved_salt->v.mode))];
+			pout[i] = verifier[i];
 		}
 		pbkdf2_sha1_sse((const unsigned char **)pin, lens, saved_salt->salt,
 		                SALT_LENGTH(saved_salt->v.mode), KEYING_ITERATIONS,
-		                pout, 2, 2*KEY_LENGTH(saved_salt->v.mode));
+		                pout, 20, block);
 		for (i = 0; i < MAX_KEYS_PER_CRYPT; ++i)
-			if (!memcmp(pout[i], saved_salt->passverify, 2))
+			if (!memcmp(&verifier[i][pos], saved_salt->passverify, 2)) {
 				something_hit = hits[i] = 1;
+				stage_stats_pass(&stats, 0);
+			}
 		if (something_hit) {
+			for (i = 0; i < MAX_KEYS_PER_CRYPT; ++i)
+				pout[i] = hmac_key[i];
 			pbkdf2_sha1_sse((const unsigned char **)pin, lens,
-				                saved_salt->salt,
-				                SALT_LENGTH(saved_salt->v.mode),
-				                KEYING_ITERATIONS, pout,
-				                KEY_LENGTH(saved_salt->v.mode),
-				                KEY_LENGTH(saved_salt->v.mode));
+			                saved_salt->salt,
+			                SALT_LENGTH(saved_salt->v.mode),
+			                KEYING_ITERATIONS, pout,
+			                block - key_len, key_len);
 			for (i = 0; i < MAX_KEYS_PER_CRYPT; ++i) {
 				if (hits[i]) {
-					hmac_sha1(pout[i], KEY_LENGTH(saved_salt->v.mode),
-				                  (const unsigned char*)saved_salt->datablob,
-				                  saved_salt->comp_len, crypt_key[index+i],
-				                  WINZIP_BINARY_SIZE);
+					memcpy(&hmac_key[i][block - key_len],
+					       verifier[i], pos);
+					hmac_sha1(hmac_key[i], key_len,
+					          (const unsigned char*)saved_salt->datablob,
+					          saved_salt->comp_len, crypt_key[index+i],
+					          WINZIP_BINARY_SIZE);
 				}
 				else
 					memset(crypt_key[index+i], 0, WINZIP_BINARY_SIZE);
@@ -315,23 +339,20 @@ static int crypt_all(int *pcount, struct db_salt *salt)
 				memset(crypt_key[index+i], 0, WINZIP_BINARY_SIZE);
 		}
 #else
-		union {
-			unsigned char pwd_ver[64];
-			uint32_t w;
-		} x;
-		unsigned char *pwd_ver = x.pwd_ver;
+		unsigned char verifier[20];
+		unsigned char hmac_key[KEY_LENGTH(3)];
 
 		pbkdf2_sha1((unsigned char *)saved_key[index], strlen(saved_key[index]),
 		            saved_salt->salt, SALT_LENGTH(saved_salt->v.mode),
-		            KEYING_ITERATIONS, pwd_ver, 2,
-		            2*KEY_LENGTH(saved_salt->v.mode));
-		if (!memcmp(pwd_ver, saved_salt->passverify, 2)) {
+		            KEYING_ITERATIONS, verifier, 20, block);
+		if (!memcmp(&verifier[pos], saved_salt->passverify, 2)) {
+			stage_stats_pass(&stats, 0);
 			pbkdf2_sha1((unsigned char *)saved_key[index],
 			            strlen(saved_key[index]), saved_salt->salt,
 			            SALT_LENGTH(saved_salt->v.mode), KEYING_ITERATIONS,
-			            pwd_ver, KEY_LENGTH(saved_salt->v.mode),
-			            KEY_LENGTH(saved_salt->v.mode));
-			hmac_sha1(pwd_ver, KEY_LENGTH(saved_salt->v.mode),
+			            hmac_key, block - key_len, key_len);
+			memcpy(&hmac_key[block - key_len], verifier, pos);
+			hmac_sha1(hmac_key, key_len,
 			          (const unsigned char*)saved_salt->datablob,
 			          saved_salt->comp_len, crypt_key[index],
 			          WINZIP_BINARY_SIZE);
@@ -361,7 +382,11 @@ static int cmp_one(void *binary, int index)
 static int cmp_exact(char *source, int index)
 {
 	void *b = winzip_common_binary(source);
-	return !memcmp(b, crypt_key[index], sizeof(crypt_key[index]));
+
+	if (memcmp(b, crypt_key[index], sizeof(crypt_key[index])))
+		return 0;
+	stage_stats_pass(&stats, 1);
+	return 1;
 }
 
 struct fmt_main fmt_zip = {